@@ -20,7 +20,8 @@ extern CapIdx __stack_mem_cap;
 
 enum KmodSchedClass : size_t {
     SCHED_CLASS_FCFS = 2,
-    SCHED_CLASS_RR   = 3,
+    SCHED_CLASS_CFS  = 3,
+    SCHED_CLASS_RR   = 4,
 };
 
 struct ForkRet {
@@ -37,6 +38,13 @@ CapIdx sys_pcb_create_process(CapIdx pcb_cap, const char *path, CapIdx *caps,
                               size_t caps_sz, size_t sched_class);
 CapIdx sys_create_process(const char *path, CapIdx *caps, size_t caps_sz,
                           size_t sched_class);
+/**
+ * @brief 直接创建并启动新进程, 按args传递capability并预先映射Memory.
+ *
+ * @return 子进程PCB capability; 失败返回cap::error.
+ */
+CapIdx sys_pcb_spawn(CapIdx pcb_cap, const SpawnArgs *args);
+CapIdx sys_spawn(const SpawnArgs *args);
 CapIdx sys_pcb_create_thread(CapIdx pcb_cap, void (*entry)(),
                              void *stack_addr, size_t stack_size);
 CapIdx sys_create_thread(void (*entry)(), void *stack_addr, size_t stack_size);
@@ -53,6 +61,10 @@ bool sys_cap_derive(CapIdx src, CapIdx target, uint64_t new_perm);
 bool sys_cap_remove(CapIdx idx);
 bool sys_cap_lookup(CapIdx idx, CapInfo *info);
 size_t sys_getpid(CapIdx pcb_cap);
+bool sys_tcb_set_nice(CapIdx tcb_cap, int nice);
+bool sys_tcb_set_priority(CapIdx tcb_cap, size_t prio);
+bool sys_tcb_set_deadline(CapIdx tcb_cap, size_t runtime, size_t period,
+                          size_t deadline);
 
 bool sys_notif_create(CapIdx target);
 bool sys_notif_signal(CapIdx capidx, size_t idx);
@@ -367,6 +367,41 @@ SBIRet sbi_remote_hfence_vvma_asid(umb_t hart_mask, umb_t hart_mask_base,
 SBIRet sbi_remote_hfence_vvma(umb_t hart_mask, umb_t hart_mask_base,
                               umb_t start_addr, umb_t size);
 
+//-----------------------
+// HSM Extension
+// EID #0x48534D "HSM"
+//-----------------------
+
+/**
+ * @brief 启动 hart (FID #0)
+ *
+ * 请求 SBI 实现以 S-Mode 在 start_addr 处启动指定 hart. 目标 hart 以
+ * a0 = hartid, a1 = opaque 开始执行, 此时 satp 为 0, 中断关闭.
+ *
+ * @param hartid 目标 hart
+ * @param start_addr 起始物理地址
+ * @param opaque 传递给目标 hart 的参数
+ * @return SBIRet 返回值
+ */
+SBIRet sbi_hart_start(umb_t hartid, umb_t start_addr, umb_t opaque);
+
+/**
+ * @brief 停止调用者所在的 hart (FID #1)
+ *
+ * 成功时不返回.
+ *
+ * @return SBIRet 返回值
+ */
+SBIRet sbi_hart_stop(void);
+
+/**
+ * @brief 查询 hart 状态 (FID #2)
+ *
+ * @param hartid 目标 hart
+ * @return SBIRet 返回值, value 为 HSM_STATE 之一
+ */
+SBIRet sbi_hart_get_status(umb_t hartid);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
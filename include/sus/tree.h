@@ -545,4 +545,404 @@ namespace util::tree_base {
         pool[5].TreeB::link_child(pool[9]);
     }
     */
-}  // namespace util::tree_base
\ No newline at end of file
+}  // namespace util::tree_base
+namespace util::rbtree {
+    /**
+     * @brief 红黑树侵入式节点, 作为成员嵌入被索引的对象中
+     */
+    template <typename Node>
+    struct RBNode {
+        Node *parent = nullptr;
+        Node *left   = nullptr;
+        Node *right  = nullptr;
+        bool red     = false;
+    };
+
+    /**
+     * @brief 侵入式红黑树
+     *
+     * 节点按 Compare 定义的严格弱序排列, 允许等价节点 (插入在已有等价节点之后).
+     * 树本身不分配内存, 节点生命周期由使用者管理.
+     *
+     * @tparam Node 节点类型
+     * @tparam Field 指向 RBNode<Node> 成员的成员指针
+     * @tparam Compare 形如 bool(const Node &, const Node &) 的比较器类型
+     */
+    template <typename Node, auto Field, typename Compare>
+    class RBTree {
+    private:
+        Node *_root  = nullptr;
+        size_t _size = 0;
+
+        static constexpr RBNode<Node> &U_node(Node *node) {
+            return node->*Field;
+        }
+        static constexpr const RBNode<Node> &U_node(const Node *node) {
+            return node->*Field;
+        }
+        static constexpr bool U_red(const Node *node) {
+            return node != nullptr && U_node(node).red;
+        }
+
+        static Node *U_min(Node *node) {
+            while (U_node(node).left != nullptr) {
+                node = U_node(node).left;
+            }
+            return node;
+        }
+        static Node *U_max(Node *node) {
+            while (U_node(node).right != nullptr) {
+                node = U_node(node).right;
+            }
+            return node;
+        }
+
+        void rotate_left(Node *x) {
+            Node *y         = U_node(x).right;
+            U_node(x).right = U_node(y).left;
+            if (U_node(y).left != nullptr) {
+                U_node(U_node(y).left).parent = x;
+            }
+            U_node(y).parent = U_node(x).parent;
+            replace_child(U_node(x).parent, x, y);
+            U_node(y).left   = x;
+            U_node(x).parent = y;
+        }
+
+        void rotate_right(Node *x) {
+            Node *y        = U_node(x).left;
+            U_node(x).left = U_node(y).right;
+            if (U_node(y).right != nullptr) {
+                U_node(U_node(y).right).parent = x;
+            }
+            U_node(y).parent = U_node(x).parent;
+            replace_child(U_node(x).parent, x, y);
+            U_node(y).right  = x;
+            U_node(x).parent = y;
+        }
+
+        // 将 parent 指向 old_child 的链接改为 new_child, parent 为空时修改根
+        void replace_child(Node *parent, Node *old_child, Node *new_child) {
+            if (parent == nullptr) {
+                _root = new_child;
+            } else if (U_node(parent).left == old_child) {
+                U_node(parent).left = new_child;
+            } else {
+                U_node(parent).right = new_child;
+            }
+        }
+
+        void transplant(Node *u, Node *v) {
+            replace_child(U_node(u).parent, u, v);
+            if (v != nullptr) {
+                U_node(v).parent = U_node(u).parent;
+            }
+        }
+
+        void insert_fixup(Node *z) {
+            while (U_red(U_node(z).parent)) {
+                Node *p = U_node(z).parent;
+                Node *g = U_node(p).parent;
+                if (p == U_node(g).left) {
+                    Node *u = U_node(g).right;
+                    if (U_red(u)) {
+                        U_node(p).red = false;
+                        U_node(u).red = false;
+                        U_node(g).red = true;
+                        z             = g;
+                        continue;
+                    }
+                    if (z == U_node(p).right) {
+                        z = p;
+                        rotate_left(z);
+                        p = U_node(z).parent;
+                    }
+                    U_node(p).red = false;
+                    U_node(g).red = true;
+                    rotate_right(g);
+                } else {
+                    Node *u = U_node(g).left;
+                    if (U_red(u)) {
+                        U_node(p).red = false;
+                        U_node(u).red = false;
+                        U_node(g).red = true;
+                        z             = g;
+                        continue;
+                    }
+                    if (z == U_node(p).left) {
+                        z = p;
+                        rotate_right(z);
+                        p = U_node(z).parent;
+                    }
+                    U_node(p).red = false;
+                    U_node(g).red = true;
+                    rotate_left(g);
+                }
+            }
+            U_node(_root).red = false;
+        }
+
+        // x 可能为空, 因此需同时给出其父节点 xp
+        void remove_fixup(Node *x, Node *xp) {
+            while (x != _root && !U_red(x)) {
+                if (x == U_node(xp).left) {
+                    Node *w = U_node(xp).right;
+                    if (U_red(w)) {
+                        U_node(w).red  = false;
+                        U_node(xp).red = true;
+                        rotate_left(xp);
+                        w = U_node(xp).right;
+                    }
+                    if (!U_red(U_node(w).left) && !U_red(U_node(w).right)) {
+                        U_node(w).red = true;
+                        x             = xp;
+                        xp            = U_node(x).parent;
+                        continue;
+                    }
+                    if (!U_red(U_node(w).right)) {
+                        U_node(U_node(w).left).red = false;
+                        U_node(w).red              = true;
+                        rotate_right(w);
+                        w = U_node(xp).right;
+                    }
+                    U_node(w).red               = U_node(xp).red;
+                    U_node(xp).red              = false;
+                    U_node(U_node(w).right).red = false;
+                    rotate_left(xp);
+                } else {
+                    Node *w = U_node(xp).left;
+                    if (U_red(w)) {
+                        U_node(w).red  = false;
+                        U_node(xp).red = true;
+                        rotate_right(xp);
+                        w = U_node(xp).left;
+                    }
+                    if (!U_red(U_node(w).left) && !U_red(U_node(w).right)) {
+                        U_node(w).red = true;
+                        x             = xp;
+                        xp            = U_node(x).parent;
+                        continue;
+                    }
+                    if (!U_red(U_node(w).left)) {
+                        U_node(U_node(w).right).red = false;
+                        U_node(w).red               = true;
+                        rotate_left(w);
+                        w = U_node(xp).left;
+                    }
+                    U_node(w).red              = U_node(xp).red;
+                    U_node(xp).red             = false;
+                    U_node(U_node(w).left).red = false;
+                    rotate_right(xp);
+                }
+                x = _root;
+            }
+            if (x != nullptr) {
+                U_node(x).red = false;
+            }
+        }
+
+        // 返回子树黑高, 违反红黑性质时返回 -1
+        int U_black_height(const Node *node) const {
+            if (node == nullptr) {
+                return 1;
+            }
+            const Node *l = U_node(node).left;
+            const Node *r = U_node(node).right;
+            if (U_red(node) && (U_red(l) || U_red(r))) {
+                return -1;
+            }
+            if ((l != nullptr && (U_node(l).parent != node ||
+                                  Compare{}(*node, *l))) ||
+                (r != nullptr && (U_node(r).parent != node ||
+                                  Compare{}(*r, *node))))
+            {
+                return -1;
+            }
+            int lh = U_black_height(l);
+            int rh = U_black_height(r);
+            if (lh < 0 || rh < 0 || lh != rh) {
+                return -1;
+            }
+            return lh + (U_red(node) ? 0 : 1);
+        }
+
+    public:
+        constexpr RBTree() = default;
+
+        RBTree(const RBTree &)            = delete;
+        RBTree &operator=(const RBTree &) = delete;
+
+        /**
+         * @brief 插入节点, O(log n)
+         */
+        void insert(Node &node) {
+            Node *z       = &node;
+            U_node(z)     = {};
+            U_node(z).red = true;
+
+            Node *parent = nullptr;
+            Node *cur    = _root;
+            bool left    = false;
+            while (cur != nullptr) {
+                parent = cur;
+                left   = Compare{}(*z, *cur);
+                cur    = left ? U_node(cur).left : U_node(cur).right;
+            }
+            U_node(z).parent = parent;
+            if (parent == nullptr) {
+                _root = z;
+            } else if (left) {
+                U_node(parent).left = z;
+            } else {
+                U_node(parent).right = z;
+            }
+            _size++;
+            insert_fixup(z);
+        }
+
+        /**
+         * @brief 移除树中的节点, O(log n)
+         */
+        void remove(Node &node) {
+            Node *z    = &node;
+            Node *y    = z;
+            bool y_red = U_red(y);
+            Node *x    = nullptr;
+            Node *xp   = nullptr;
+
+            if (U_node(z).left == nullptr) {
+                x  = U_node(z).right;
+                xp = U_node(z).parent;
+                transplant(z, x);
+            } else if (U_node(z).right == nullptr) {
+                x  = U_node(z).left;
+                xp = U_node(z).parent;
+                transplant(z, x);
+            } else {
+                y     = U_min(U_node(z).right);
+                y_red = U_red(y);
+                x     = U_node(y).right;
+                if (U_node(y).parent == z) {
+                    xp = y;
+                } else {
+                    xp = U_node(y).parent;
+                    transplant(y, x);
+                    U_node(y).right                = U_node(z).right;
+                    U_node(U_node(y).right).parent = y;
+                }
+                transplant(z, y);
+                U_node(y).left                = U_node(z).left;
+                U_node(U_node(y).left).parent = y;
+                U_node(y).red                 = U_node(z).red;
+            }
+            _size--;
+            if (!y_red) {
+                remove_fixup(x, xp);
+            }
+            U_node(z) = {};
+        }
+
+        [[nodiscard]]
+        Node *first() const {
+            return _root == nullptr ? nullptr : U_min(_root);
+        }
+
+        [[nodiscard]]
+        Node *last() const {
+            return _root == nullptr ? nullptr : U_max(_root);
+        }
+
+        /**
+         * @brief 中序后继, 不存在时返回 nullptr
+         */
+        static Node *next(Node *node) {
+            if (U_node(node).right != nullptr) {
+                return U_min(U_node(node).right);
+            }
+            Node *parent = U_node(node).parent;
+            while (parent != nullptr && node == U_node(parent).right) {
+                node   = parent;
+                parent = U_node(parent).parent;
+            }
+            return parent;
+        }
+
+        /**
+         * @brief 中序前驱, 不存在时返回 nullptr
+         */
+        static Node *prev(Node *node) {
+            if (U_node(node).left != nullptr) {
+                return U_max(U_node(node).left);
+            }
+            Node *parent = U_node(node).parent;
+            while (parent != nullptr && node == U_node(parent).left) {
+                node   = parent;
+                parent = U_node(parent).parent;
+            }
+            return parent;
+        }
+
+        /**
+         * @brief 查找最后一个满足 pred 的节点
+         *
+         * pred 须在中序序列上单调: 满足的节点构成一个前缀.
+         * 例如 pred(n) = key(n) <= k 时得到 k 的 floor.
+         */
+        template <typename Pred>
+        Node *last_such_that(Pred pred) const {
+            Node *cur    = _root;
+            Node *result = nullptr;
+            while (cur != nullptr) {
+                if (pred(*cur)) {
+                    result = cur;
+                    cur    = U_node(cur).right;
+                } else {
+                    cur = U_node(cur).left;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief 查找第一个不满足 pred 的节点, pred 要求同 last_such_that
+         */
+        template <typename Pred>
+        Node *first_not(Pred pred) const {
+            Node *cur    = _root;
+            Node *result = nullptr;
+            while (cur != nullptr) {
+                if (pred(*cur)) {
+                    cur = U_node(cur).right;
+                } else {
+                    result = cur;
+                    cur    = U_node(cur).left;
+                }
+            }
+            return result;
+        }
+
+        [[nodiscard]]
+        size_t size() const {
+            return _size;
+        }
+
+        [[nodiscard]]
+        bool empty() const {
+            return _size == 0;
+        }
+
+        /**
+         * @brief 校验红黑性质, 父指针与有序性, 供测试使用
+         */
+        [[nodiscard]]
+        bool validate() const {
+            if (U_red(_root)) {
+                return false;
+            }
+            if (_root != nullptr && U_node(_root).parent != nullptr) {
+                return false;
+            }
+            return U_black_height(_root) > 0;
+        }
+    };
+}  // namespace util::rbtree
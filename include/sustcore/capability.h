@@ -53,8 +53,10 @@ constexpr const char *to_string(PayloadType type) {
     }
 }
 
-constexpr size_t MAX_MSG_SIZE = 128;
-constexpr size_t MAX_MSG_CAPS = 4;
+constexpr size_t MAX_MSG_SIZE   = 128;
+constexpr size_t MAX_MSG_CAPS   = 4;
+constexpr size_t MAX_SPAWN_CAPS = 32;
+constexpr size_t MAX_SPAWN_MAPS = 8;
 
 using CapIdx  = b64;
 using RecvIdx = b64;
@@ -76,6 +78,42 @@ struct MsgPacket {
     size_t *capsz;
 };
 
+/**
+ * @brief spawn时传递给子进程的一项capability.
+ *
+ * 父进程src处的capability按CLONE语义复制到子进程dst处; perm非0时
+ * 子进程获得降级后的权限, 须为原权限的子集.
+ */
+struct SpawnCap {
+    CapIdx src;
+    CapIdx dst;
+    b64 perm;
+};
+
+/**
+ * @brief spawn时预先映射进子进程的Memory.
+ *
+ * memory为子进程CSpace中的索引, 须已由SpawnCap传入.
+ */
+struct SpawnMap {
+    CapIdx memory;
+    void *vaddr;
+    b64 rwx;
+    b64 growth;
+};
+
+/**
+ * @brief spawn系统调用的参数描述符.
+ */
+struct SpawnArgs {
+    const char *path;
+    const SpawnCap *caps;
+    size_t caps_sz;
+    const SpawnMap *maps;
+    size_t maps_sz;
+    size_t sched_class;
+};
+
 struct CapInfo {
     PayloadType type;
     b64 permissions;
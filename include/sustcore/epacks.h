@@ -24,4 +24,6 @@ struct TimerTickEvent {
 // No Present Event Pack
 struct NoPresentEvent {
     VirAddr access_address;
+    // 是否为写访问 (含 AMO) 引发的缺页
+    bool write = false;
 };
\ No newline at end of file
@@ -48,6 +48,12 @@
 #define SYS_MEM_RESIZE (SYSCALL_BASE + 0x1D)
 #define SYS_MEM_QUERY  (SYSCALL_BASE + 0x1E)
 
+#define SYS_SPAWN (SYSCALL_BASE + 0x1F)
+
+#define SYS_TCB_SET_NICE     (SYSCALL_BASE + 0x20)
+#define SYS_TCB_SET_PRIORITY (SYSCALL_BASE + 0x21)
+#define SYS_TCB_SET_DEADLINE (SYSCALL_BASE + 0x22)
+
 // 以SYS_UNSTABLE_BASE开头的系统调用为不稳定接口, 可能会在后续版本中更改或移除
 #define SYS_UNSTABLE_BASE  (0xFFC00000)
 #define SYS_WRITE_SERIAL   (SYS_UNSTABLE_BASE + 0x01)
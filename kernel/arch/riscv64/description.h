@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <arch/riscv64/mem/asid.h>
+#include <arch/riscv64/smp.h>
 #include <arch/riscv64/trait.h>
 #include <arch/trait.h>
 
@@ -24,4 +26,7 @@ template <KernelStage Stage>
 using _PageMan        = Riscv64SV39PageMan<Stage>;
 
 using EarlyPageMan = _PageMan<KernelStage::PRE_INIT>;
-using PageMan      = _PageMan<KernelStage::POST_INIT>;
\ No newline at end of file
+using PageMan      = _PageMan<KernelStage::POST_INIT>;
+
+using AsidAllocator = Riscv64AsidAllocator;
+using SMP           = Riscv64SMP;
\ No newline at end of file
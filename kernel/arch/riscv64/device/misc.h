@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cpu.h>
 #include <sus/units.h>
 #include <cstddef>
 
@@ -24,7 +25,8 @@ units::frequency get_clock_freq(void);
 struct TimerInfo {
     units::frequency freq;
     units::frequency expected_freq;
-    units::tick last_ticks;
+    // 各处理器的时钟中断相互独立, 分别记录上一次中断的时刻
+    cpu::PerCPU<units::tick> last_ticks;
     units::tick increment;
 };
 
@@ -1 +1 @@
-sources += entry.S setup.cpp
+sources += entry.S setup.cpp smp.cpp
@@ -15,6 +15,7 @@
 #include <logger.h>
 #include <sus/logger.h>
 #include <sus/types.h>
+#include <sync/spinlock.h>
 #include <new>
 #include <task/scheduler.h>
 #include <task/task.h>
@@ -22,6 +23,12 @@
 extern "C" void handle_trap(csr_scause_t scause, umb_t sepc, umb_t stval,
                             Riscv64Context *ctx) {
     bool from_umode = !ctx->sstatus.spp;
+    // 来自 S-Mode 的陷入可能发生在已持锁的内核代码中, 锁可重入
+    sync::kernel_lock.lock();
+    // 空闲上下文虽运行于 S-Mode, 被打断时同样可以切换到其它线程
+    bool switchable = from_umode ||
+                      (schd::Scheduler::initialized() &&
+                       schd::Scheduler::inst().idle_interrupted(ctx));
     task::TaskManager::inst().reap_recycled();
     if (scause.interrupt) {
         if (scause.cause == 5) {
@@ -31,7 +38,7 @@ extern "C" void handle_trap(csr_scause_t scause, umb_t sepc, umb_t stval,
         // 异常
         Handlers::exception(scause, sepc, stval, ctx);
     }
-    if (from_umode) {
+    if (switchable) {
         auto &scheduler = schd::Scheduler::inst();
         scheduler.schedule();
         auto *tcb = scheduler.current_tcb();
@@ -39,7 +46,15 @@ extern "C" void handle_trap(csr_scause_t scause, umb_t sepc, umb_t stval,
             csr_set_sscratch(
                 reinterpret_cast<csr_sscratch_t>(tcb->kstack_top));
         }
+        // 此时仍运行在上一个线程的内核栈上, 而该线程可能已回到运行队列;
+        // 由 trap.S 切换到下一个线程的内核栈后再释放内核大锁
+        return;
     }
+    sync::kernel_lock.unlock();
+}
+
+extern "C" void trap_exit_unlock(void) {
+    sync::kernel_lock.unlock();
 }
 
 extern "C" void isr_entry(void);
@@ -342,7 +342,9 @@ namespace handlers::paging {
                     loggers::INTERRUPT::DEBUG(
                         "缺页异常可尝试处理: addr=%p, page=%p, tm_pgd=%p",
                         fault_addr.addr(), fault_page.addr(), tm->pgd().addr());
-                    processed |= tm->on_np({fault_addr});
+                    processed |= tm->on_np(
+                        {fault_addr,
+                         scause.cause == Exceptions::STORE_PAGE_FAULT});
 
                     // for debug:
                     if (processed) {
@@ -547,13 +549,14 @@ namespace Handlers {
                Riscv64Context *ctx) {
         // 计算时间差
         units::tick current_ticks = units::tick::from_ticks(csr_get_time());
-        units::tick gap_ticks     = current_ticks - timer_info.last_ticks;
+        units::tick &last_ticks   = timer_info.last_ticks.local();
+        units::tick gap_ticks     = current_ticks - last_ticks;
 
-        TimerTickEvent e = {.last_tick = timer_info.last_ticks,
+        TimerTickEvent e = {.last_tick = last_ticks,
                             .increment = timer_info.increment,
                             .gap_ticks = gap_ticks};
 
-        timer_info.last_ticks = current_ticks;
+        last_ticks = current_ticks;
         schd::Scheduler::inst().do_tick(e);
 
         // 重新设置下一次时钟中断
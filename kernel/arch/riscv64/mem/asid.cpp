@@ -0,0 +1,151 @@
+/**
+ * @file asid.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief SV39 地址空间标识符分配
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <arch/riscv64/csr.h>
+#include <arch/riscv64/mem/asid.h>
+#include <logger.h>
+
+size_t Riscv64AsidAllocator::asid_bits      = 0;
+uint16_t Riscv64AsidAllocator::max_asid     = 0;
+uint64_t Riscv64AsidAllocator::generation   = 1;
+uint32_t Riscv64AsidAllocator::next_asid    = 1;
+uint64_t Riscv64AsidAllocator::rollover_cnt = 0;
+uint64_t Riscv64AsidAllocator::used_map[MAP_WORDS];
+cpu::PerCPU<Riscv64AsidAllocator::Context> Riscv64AsidAllocator::active;
+cpu::PerCPU<Riscv64AsidAllocator::Context> Riscv64AsidAllocator::reserved;
+cpu::PerCPU<bool> Riscv64AsidAllocator::flush_pending;
+
+void Riscv64AsidAllocator::probe() {
+    // 向 satp.asid 写入全 1, 读回后保留下来的位即为实现的 ASID 位
+    csr_satp_t origin = csr_get_satp();
+    csr_satp_t trial  = origin;
+    trial.asid        = 0xFFFF;
+    csr_set_satp(trial);
+    csr_satp_t probed = csr_get_satp();
+    csr_set_satp(origin);
+    asm volatile("sfence.vma");
+
+    asid_bits = 0;
+    while (asid_bits < 16 && (probed.asid & (1ul << asid_bits)) != 0) {
+        asid_bits++;
+    }
+    max_asid = static_cast<uint16_t>((1ul << asid_bits) - 1);
+    // 代切换时每个处理器至多保留一个 ASID, 须留有余量分给新地址空间
+    if (max_asid <= cpu::MAX_CPUS) {
+        loggers::PAGING::INFO("ASID 位宽 %d 过小, 不使用 ASID", asid_bits);
+        max_asid = 0;
+        return;
+    }
+    loggers::PAGING::INFO("ASID 位宽为 %d, 可用 ASID 数 %d", asid_bits,
+                          max_asid);
+}
+
+bool Riscv64AsidAllocator::test_and_set(uint16_t asid) {
+    uint64_t &word   = used_map[asid / 64];
+    const uint64_t m = 1ul << (asid % 64);
+    const bool was   = (word & m) != 0;
+    word            |= m;
+    return was;
+}
+
+bool Riscv64AsidAllocator::loaded(Context ctx) {
+    if (ctx == NO_CONTEXT) {
+        return false;
+    }
+    if (live(ctx)) {
+        return true;
+    }
+    for (size_t cpu = 0; cpu < cpu::online(); cpu++) {
+        if (reserved.of(cpu) == ctx) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Riscv64AsidAllocator::update_reserved(Context ctx, Context new_ctx) {
+    // 同一地址空间可能同时被多个处理器保留, 须全部更新
+    bool hit = false;
+    for (size_t cpu = 0; cpu < cpu::online(); cpu++) {
+        if (reserved.of(cpu) == ctx) {
+            reserved.of(cpu) = new_ctx;
+            hit              = true;
+        }
+    }
+    return hit;
+}
+
+void Riscv64AsidAllocator::rollover() {
+    generation++;
+    next_asid = 1;
+    rollover_cnt++;
+    for (auto &word : used_map) {
+        word = 0;
+    }
+    for (size_t cpu = 0; cpu < cpu::online(); cpu++) {
+        // 代切换以来未再切换地址空间的处理器仍运行其保留的上下文
+        Context ctx    = active.of(cpu);
+        active.of(cpu) = NO_CONTEXT;
+        if (ctx == NO_CONTEXT) {
+            ctx = reserved.of(cpu);
+        }
+        if (ctx != NO_CONTEXT) {
+            test_and_set(asid_of(ctx));
+        }
+        reserved.of(cpu)      = ctx;
+        flush_pending.of(cpu) = true;
+    }
+}
+
+Riscv64AsidAllocator::Context Riscv64AsidAllocator::new_context(Context ctx) {
+    if (ctx != NO_CONTEXT) {
+        const uint16_t asid   = asid_of(ctx);
+        const Context new_ctx = (generation << 16) | asid;
+        // 仍在某个处理器上运行: 沿用保留的 ASID, 不能分给其它地址空间
+        if (update_reserved(ctx, new_ctx)) {
+            return new_ctx;
+        }
+        // 旧 ASID 在本代尚未被占用时沿用之
+        if (!test_and_set(asid)) {
+            return new_ctx;
+        }
+    }
+    while (true) {
+        for (; next_asid <= max_asid; next_asid++) {
+            const auto asid = static_cast<uint16_t>(next_asid);
+            if (!test_and_set(asid)) {
+                next_asid++;
+                return (generation << 16) | asid;
+            }
+        }
+        // 本代 ASID 用尽, 进入下一代; 保留项之外的旧代 ASID 全部作废
+        rollover();
+    }
+}
+
+uint16_t Riscv64AsidAllocator::acquire(Context &ctx) {
+    if (!supported()) {
+        if (!live(ctx)) {
+            ctx = generation << 16;
+        }
+        return 0;
+    }
+    if (!live(ctx)) {
+        ctx = new_context(ctx);
+    }
+    active.local() = ctx;
+    // 代切换后首次切换地址空间, 清除旧代 ASID 在本地 TLB 中的残留项
+    if (flush_pending.local()) {
+        flush_pending.local() = false;
+        asm volatile("sfence.vma");
+    }
+    return asid_of(ctx);
+}
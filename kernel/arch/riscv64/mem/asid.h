@@ -0,0 +1,119 @@
+/**
+ * @file asid.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief SV39 地址空间标识符分配
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cpu.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief ASID 分配器.
+ *
+ * ASID 按代分配: 每个地址空间以 Context 记录其 ASID 及所属的代,
+ * 切换时若代已过期则重新分配. 当前代的 ASID 用尽时进入下一代,
+ * 此后各地址空间在下次切换时重新取得 ASID.
+ *
+ * 代切换时其它处理器可能仍以旧代 ASID 运行某个地址空间, 因此各处理器
+ * 正在使用的 ASID 在新代中保留给原地址空间, 该地址空间重新取得 ASID
+ * 时沿用之, 其余 ASID 才会分给新的地址空间. 各处理器在代切换后首次
+ * 切换地址空间前全局刷新本地 TLB, 清除旧代 ASID 的残留项.
+ *
+ * ASID 0 保留给内核页表; 硬件不支持 ASID 时所有地址空间均使用 0,
+ * 切换时需全局刷新 TLB. 调用者须持有内核大锁.
+ */
+class Riscv64AsidAllocator {
+public:
+    // 高位为代, 低 16 位为 ASID
+    using Context = uint64_t;
+    static constexpr Context NO_CONTEXT = 0;
+
+    /**
+     * @brief 探测硬件实现的 ASID 位宽, 需在开启分页后调用
+     */
+    static void probe();
+
+    static size_t bits() {
+        return asid_bits;
+    }
+
+    static bool supported() {
+        return max_asid != 0;
+    }
+
+    /**
+     * @brief 判断 ctx 是否属于当前代, 即其 ASID 仍然有效
+     */
+    static bool live(Context ctx) {
+        return ctx != NO_CONTEXT && (ctx >> 16) == generation;
+    }
+
+    static uint16_t asid_of(Context ctx) {
+        return static_cast<uint16_t>(ctx & 0xFFFF);
+    }
+
+    /**
+     * @brief 判断 ctx 的 ASID 是否可能仍在某个处理器的 TLB 中有效
+     *
+     * 当前代的上下文, 以及代切换时仍在某个处理器上运行而被保留的
+     * 旧代上下文均属此类; 刷新此类上下文须使用 asid_of(ctx).
+     */
+    static bool loaded(Context ctx);
+
+    /**
+     * @brief 取得地址空间在当前处理器上使用的 ASID, ctx 过期时重新分配
+     *
+     * 调用后当前处理器即以该 ASID 运行此地址空间.
+     */
+    static uint16_t acquire(Context &ctx);
+
+    /**
+     * @brief 已发生的代切换次数
+     */
+    static uint64_t rollovers() {
+        return rollover_cnt;
+    }
+
+private:
+    static constexpr size_t MAP_WORDS = (1ul << 16) / 64;
+
+    static size_t asid_bits;
+    static uint16_t max_asid;
+    static uint64_t generation;
+    static uint32_t next_asid;
+    static uint64_t rollover_cnt;
+    // 当前代中已分配的 ASID
+    static uint64_t used_map[MAP_WORDS];
+    // 各处理器当前运行的上下文; 代切换后置空, 直至该处理器再次切换
+    static cpu::PerCPU<Context> active;
+    // 各处理器在最近一次代切换时运行的上下文, 其 ASID 在新代中保留
+    static cpu::PerCPU<Context> reserved;
+    // 代切换后尚未全局刷新本地 TLB 的处理器
+    static cpu::PerCPU<bool> flush_pending;
+
+    static bool test_and_set(uint16_t asid);
+
+    /**
+     * @brief 若 ctx 被某个处理器保留, 将保留项更新为 new_ctx
+     */
+    static bool update_reserved(Context ctx, Context new_ctx);
+
+    /**
+     * @brief 进入下一代, 保留各处理器正在使用的 ASID
+     */
+    static void rollover();
+
+    /**
+     * @brief 为过期的 ctx 在当前代中分配 ASID
+     */
+    static Context new_context(Context ctx);
+};
@@ -1 +1 @@
-sources += sv39.cpp
+sources += asid.cpp sv39.cpp
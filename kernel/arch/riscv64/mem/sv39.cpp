@@ -9,6 +9,7 @@
  *
  */
 
+#include <arch/riscv64/mem/asid.h>
 #include <arch/riscv64/mem/sv39.h>
 #include <logger.h>
 #include <sustcore/addr.h>
@@ -22,7 +23,7 @@ void Riscv64SV39PageMan<KernelStage::PRE_INIT>::init(void) {
 
 template<>
 void Riscv64SV39PageMan<KernelStage::POST_INIT>::init(void) {
-    // SV39页表管理器不需要特殊的后初始化步骤
-    // 但我们可以在这里设置一些全局状态或日志
+    // 此时已开启分页, 可以安全地探测 ASID 位宽
+    Riscv64AsidAllocator::probe();
     loggers::PAGING::INFO("SV39页表管理器后初始化完成");
 }
\ No newline at end of file
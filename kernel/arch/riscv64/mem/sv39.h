@@ -304,6 +304,12 @@ public:
 
     static void make_root(PhyAddr root) {
         memset(_convert(root).addr(), 0, PAGESIZE);
+        PageFrame *frame = FrameTable::frame<Stage>(root);
+        if (frame != nullptr) {
+            frame->set(PageFrame::PGTABLE);
+            frame->ptes = 0;
+            frame->priv = 0;
+        }
     }
 
 private:
@@ -312,6 +318,97 @@ private:
         return _as<PTE>(__root);
     }
 
+    // 页表项所在页表页的描述符, 不在描述符表覆盖范围内时为 nullptr
+    static PageFrame *table_frame(const PTE *pte) {
+        StageAddr addr(reinterpret_cast<addr_t>(pte));
+        return FrameTable::frame<Stage>(
+            convert<PhyAddr>(addr).page_align_down());
+    }
+
+    /**
+     * @brief 页表中的有效项数
+     *
+     * 无法跟踪的页表视为满, 从而不会被回收
+     */
+    static size_t occupancy(const PTE *table) {
+        PageFrame *frame = table_frame(table);
+        return frame != nullptr ? frame->ptes : PTE_CNT;
+    }
+
+    // 页表项有效位变化时, 同步其所在页表的有效项数
+    static void account(const PTE *pte, bool valid) {
+        PageFrame *frame = table_frame(pte);
+        if (frame == nullptr) {
+            return;
+        }
+        if (valid) {
+            frame->ptes++;
+        } else {
+            assert(frame->ptes > 0);
+            frame->ptes--;
+        }
+    }
+
+    // 根页表下页表页的总数
+    void count_table(bool added) {
+        PageFrame *frame = FrameTable::frame<Stage>(__root);
+        if (frame != nullptr) {
+            frame->priv = added ? frame->priv + 1 : frame->priv - 1;
+        }
+    }
+
+    /**
+     * @brief 摘下 entry 指向的下一级页表, 并清除 entry
+     *
+     * 调用者需保证该页表已不含有效项, 并负责归还返回的页表页
+     */
+    PhyAddr detach_table(PTE &entry) {
+        PhyAddr table    = from_ppn(entry.ppn);
+        PageFrame *frame = FrameTable::frame<Stage>(table);
+        if (frame != nullptr) {
+            frame->clear(PageFrame::PGTABLE);
+        }
+        clear_entry(entry);
+        count_table(false);
+        return table;
+    }
+
+    /**
+     * @brief 释放 entry 指向的下一级页表, 并清除 entry
+     *
+     * 调用者需保证该页表已不含有效项
+     */
+    void free_table(PTE &entry) {
+        GFP::put_page<Stage>(detach_table(entry), 1);
+    }
+
+    // 立即将页表页交还页框分配器
+    struct PutTable {
+        void operator()(PhyAddr table) const {
+            GFP::put_page<Stage>(table, 1);
+        }
+    };
+
+    /**
+     * @brief 释放 entry 指向的整棵子树 (不含叶页), 并清除 entry
+     *
+     * @param level entry 所在页表的级数
+     */
+    void free_subtree(PTE &entry, int level) {
+        PTE *table = _as<PTE>(from_ppn(entry.ppn));
+        for (size_t i = 0; i < PTE_CNT; i++) {
+            if (!table[i].v) {
+                continue;
+            }
+            if (level + 1 < 2 && !is_leaf(table[i])) {
+                free_subtree(table[i], level + 1);
+            } else {
+                clear_entry(table[i]);
+            }
+        }
+        free_table(entry);
+    }
+
 public:
     explicit constexpr Riscv64SV39PageMan(PhyAddr root) : __root(root) {}
 
@@ -336,6 +433,291 @@ public:
         static_assert(tot_levels - 1 >= 0);
     }
 
+private:
+    // 第 level 级页表中 vaddr 对应的下标
+    static constexpr size_t vpn_at(umb_t va, int level) {
+        return (va >> (30 - 9 * level)) & 0x1FF;
+    }
+
+    // 第 level 级页表项覆盖的地址范围大小
+    static constexpr umb_t level_span(int level) {
+        return 1ul << (30 - 9 * level);
+    }
+
+    static constexpr PageSize level_size(int level) {
+        switch (level) {
+            case 0:  return PageSize::_1G;
+            case 1:  return PageSize::_2M;
+            default: return PageSize::_4K;
+        }
+    }
+
+    static constexpr bool is_leaf(PTE pte) {
+        return pte.v && pte.rwx != RWX::P;
+    }
+
+    static void set_leaf(PTE &pte, PhyAddr paddr, RWX rwx, bool u, bool g) {
+        if (!pte.v) {
+            account(&pte, true);
+        }
+        pte.ppn = to_ppn(paddr);
+        pte.v   = true;
+        pte.rwx = rwx_cast(rwx);
+        pte.u   = u;
+        pte.g   = g;
+        pte.a   = 0;
+        pte.d   = 0;
+        pte.rsw = 0;
+    }
+
+    /**
+     * @brief 取得非叶页表项指向的下一级页表
+     *
+     * @return 页表缺失时, alloc 为 true 则分配并清零一页作为下一级页表,
+     * 否则返回 nullptr
+     */
+    template <bool alloc>
+    Result<PTE *> next_table(PTE &pte) {
+        if (pte.v) {
+            return _as<PTE>(from_ppn(pte.ppn));
+        }
+        if constexpr (!alloc) {
+            return nullptr;
+        } else {
+            auto new_page_res = new_page();
+            propagate(new_page_res);
+            PhyAddr new_pt = new_page_res.value();
+            memset(_convert(new_pt).addr(), 0, PAGESIZE);
+            PageFrame *frame = FrameTable::frame<Stage>(new_pt);
+            if (frame != nullptr) {
+                frame->set(PageFrame::PGTABLE);
+                frame->ptes = 0;
+            }
+            PTE entry;
+            entry.value = 0;
+            entry.ppn   = to_ppn(new_pt);
+            entry.v     = true;
+            set_entry(pte, entry);
+            count_table(true);
+            return _as<PTE>(new_pt);
+        }
+    }
+
+public:
+    /**
+     * @brief 写入页表项, 并维护所在页表的有效项数
+     *
+     * 直接改写页表项有效位的代码都应经由此函数或 clear_entry
+     */
+    static void set_entry(PTE &pte, PTE value) {
+        if (pte.v != value.v) {
+            account(&pte, value.v);
+        }
+        pte.value = value.value;
+    }
+
+    /**
+     * @brief 构造指向 paddr 的 4K 叶页表项, 供 set_entry 写入
+     */
+    static PTE leaf_entry(PhyAddr paddr, RWX rwx, bool u, bool g) {
+        PTE pte;
+        pte.value = 0;
+        pte.ppn   = to_ppn(paddr);
+        pte.v     = true;
+        pte.rwx   = rwx_cast(rwx);
+        pte.u     = u;
+        pte.g     = g;
+        return pte;
+    }
+
+    static void clear_entry(PTE &pte) {
+        PTE empty;
+        empty.value = 0;
+        set_entry(pte, empty);
+    }
+
+    /**
+     * @brief 本页表树中 (不含根) 的页表页数
+     */
+    size_t table_pages() {
+        PageFrame *frame = FrameTable::frame<Stage>(__root);
+        return frame != nullptr ? frame->priv : 0;
+    }
+
+    /**
+     * @brief 释放根页表下的全部页表页, 根页表本身保留
+     *
+     * 叶页不会被释放, 其归属者负责回收
+     */
+    void release_tables() {
+        PTE *pt = root();
+        for (size_t i = 0; i < PTE_CNT; i++) {
+            if (!pt[i].v) {
+                continue;
+            }
+            if (is_leaf(pt[i])) {
+                clear_entry(pt[i]);
+            } else {
+                free_subtree(pt[i], 0);
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief 单次下行遍历 [vstart, vstart + size) 内的叶页表项
+     *
+     * 每张末级页表只查找一次, 其中的页表项被连续访问. 中间页表缺失时,
+     * alloc 为 false 则跳过其覆盖的整个范围, 否则分配之.
+     * 4K 叶项无论有效与否均会回调; 大页叶项仅在有效时以其页大小回调一次.
+     * reclaim 为 true 时, 离开一张页表后若其已不含有效项, 则自下而上
+     * 摘下该页表及变空的上级页表 (根页表除外), 交给 release 归还.
+     *
+     * @param f 形如 bool(VirAddr vaddr, PTE &pte, PageSize size) 的回调,
+     * vaddr 为该项覆盖范围的起始地址, 返回 false 时停止遍历.
+     * 回调修改页表项有效位时须使用 set_entry/clear_entry
+     * @param release 形如 void(PhyAddr table) 的回调, 接收已摘下的页表页.
+     * 其他 hart 的 TLB 可能仍缓存指向它的中间项, 需要在刷新 TLB 之后
+     * 才能归还时, 由调用者暂存
+     * @return 分配页表失败时返回 OUT_OF_MEMORY
+     */
+    template <bool alloc, bool reclaim = false, typename F,
+              typename R = PutTable>
+    Result<void> for_each_pte(VirAddr vstart, size_t size, F f,
+                              R release = {}) {
+        umb_t va        = vstart.page_align_down().arith();
+        const umb_t end = page_align_up(vstart.arith() + size);
+        while (va < end) {
+            // tables[i] 为第 i 级页表, entries[i] 为其中指向下一级页表的项.
+            // 下行至末级页表, 途中遇到大页或缺失的页表则停下
+            PTE *tables[3]  = {root(), nullptr, nullptr};
+            PTE *entries[2] = {nullptr, nullptr};
+            int level       = 0;
+            for (; level < 2; level++) {
+                PTE &pte = tables[level][vpn_at(va, level)];
+                if (is_leaf(pte)) {
+                    break;
+                }
+                auto next_res = next_table<alloc>(pte);
+                propagate(next_res);
+                if (next_res.value() == nullptr) {
+                    break;
+                }
+                entries[level]    = &pte;
+                tables[level + 1] = next_res.value();
+            }
+
+            bool stop = false;
+            if (level < 2) {
+                PTE &pte         = tables[level][vpn_at(va, level)];
+                const umb_t base = va & ~(level_span(level) - 1);
+                stop = pte.v && !f(VirAddr(base), pte, level_size(level));
+                va   = base + level_span(level);
+            } else {
+                for (size_t idx = vpn_at(va, 2); idx < PTE_CNT && va < end;
+                     idx++, va += PAGESIZE)
+                {
+                    if (!f(VirAddr(va), tables[2][idx], PageSize::_4K)) {
+                        stop = true;
+                        break;
+                    }
+                }
+            }
+
+            if constexpr (reclaim) {
+                for (; level > 0 && occupancy(tables[level]) == 0; level--) {
+                    release(detach_table(*entries[level - 1]));
+                }
+            }
+            if (stop) {
+                void_return();
+            }
+        }
+        void_return();
+    }
+
+    /**
+     * @brief 取得 vaddr 所在的末级页表, 必要时分配中间页表
+     *
+     * @return 该处已有大页映射时返回 nullptr
+     */
+    Result<PTE *> leaf_table(VirAddr vaddr) {
+        PTE *pt = root();
+        for (int level = 0; level < 2; level++) {
+            PTE &pte = pt[vpn_at(vaddr.arith(), level)];
+            if (is_leaf(pte)) {
+                return nullptr;
+            }
+            auto next_res = next_table<true>(pte);
+            propagate(next_res);
+            pt = next_res.value();
+        }
+        return pt;
+    }
+
+    // 末级页表中 vaddr 对应的下标
+    static constexpr size_t leaf_index(VirAddr vaddr) {
+        return vpn_at(vaddr.arith(), 2);
+    }
+
+    /**
+     * @brief 判断能否在 vaddr 所在的 2M 区域建立大页映射
+     *
+     * 即该区域尚无任何映射, 且不在 1G 大页之内
+     */
+    bool huge_slot_free(VirAddr vaddr) {
+        PTE &top = root()[vpn_at(vaddr.arith(), 0)];
+        if (!top.v) {
+            return true;
+        }
+        if (is_leaf(top)) {
+            return false;
+        }
+        return !_as<PTE>(from_ppn(top.ppn))[vpn_at(vaddr.arith(), 1)].v;
+    }
+
+    /**
+     * @brief 将覆盖 vaddr 的 2M 大页拆分为 512 个 4K 页
+     *
+     * 各小页继承大页的权限, A/D 位与软件位. 调用者需随后刷新整个地址空间
+     * 的 TLB, 因为被替换的是一个叶项.
+     *
+     * @return 是否发生了拆分; 分配页表失败时返回 OUT_OF_MEMORY
+     */
+    Result<bool> split_huge(VirAddr vaddr) {
+        PTE &top = root()[vpn_at(vaddr.arith(), 0)];
+        if (!top.v || is_leaf(top)) {
+            return false;
+        }
+        PTE &pte = _as<PTE>(from_ppn(top.ppn))[vpn_at(vaddr.arith(), 1)];
+        if (!is_leaf(pte)) {
+            return false;
+        }
+
+        auto new_page_res = new_page();
+        propagate(new_page_res);
+        PhyAddr new_pt = new_page_res.value();
+        PTE *table     = _as<PTE>(new_pt);
+        for (size_t i = 0; i < PTE_CNT; i++) {
+            table[i]     = pte;
+            table[i].ppn = pte.ppn + i;
+        }
+        PageFrame *frame = FrameTable::frame<Stage>(new_pt);
+        if (frame != nullptr) {
+            frame->set(PageFrame::PGTABLE);
+            frame->ptes = PTE_CNT;
+        }
+        count_table(true);
+
+        // 有效位不变, 所在页表的有效项数无需调整
+        PTE entry;
+        entry.value = 0;
+        entry.ppn   = to_ppn(new_pt);
+        entry.v     = true;
+        pte.value   = entry.value;
+        return true;
+    }
+
     // 查询页
     Result<QueryResult> query_page(VirAddr vaddr) {
         // 将vaddr拆分为三级索引
@@ -413,24 +795,12 @@ public:
                     target_pte = &pte;
                     break;
                 }
-                // 分配下一级页表
-                auto new_page_res = new_page();
-                if (!new_page_res.has_value()) {
+                // 分配并清零下一级页表
+                auto next_res = next_table<true>(pte);
+                if (!next_res.has_value()) {
                     loggers::PAGING::ERROR("无法映射页: 无可用物理页");
                     return;
                 }
-                PhyAddr new_pt = new_page_res.value();
-                assert(new_pt.nonnull());
-                // 初始化该页
-                memset(_convert(new_pt).addr(), 0, PAGESIZE);
-                pte.ppn = to_ppn(new_pt);
-                pte.v   = true;
-                pte.rwx = rwx_cast(RWX::P);
-                pte.u   = 0;
-                pte.g   = 0;
-                pte.a   = 0;
-                pte.d   = 0;
-                pte.np  = 0;
                 loggers::PAGING::DEBUG(
                     "VPN[%d] = %d 处页表项 %p 不存在, 构造为 pte = %p", level,
                     vpn[level], &pte, pte.value);
@@ -446,14 +816,7 @@ public:
         }
 
         // 设置目标页表项
-        target_pte->ppn = to_ppn(paddr);
-        target_pte->v   = true;
-        target_pte->rwx = rwx_cast(rwx);
-        target_pte->u   = u;
-        target_pte->g   = g;
-        target_pte->a   = 0;
-        target_pte->d   = 0;
-        target_pte->rsw = 0;
+        set_leaf(*target_pte, paddr, rwx, u, g);
         loggers::PAGING::DEBUG(
             "成功映射 vaddr = %p 到 paddr = %p, rwx = %d, u = %d, g = %d",
             vaddr.addr(), paddr.addr(), rwx_cast(rwx), u, g);
@@ -468,13 +831,20 @@ public:
             const PhyAddr _ps  = pstart.page_align_down();
             // 将 size 向上对齐到4K
             const size_t _size = page_align_up(range_sz);
-            const size_t _cnt  = _size / PAGESIZE;
 
-            // 逐个小页映射
-            for (size_t i = 0; i < _cnt; i++) {
-                VirAddr vaddr = _vs + i * PAGESIZE;
-                PhyAddr paddr = _ps + i * PAGESIZE;
-                map_page<PageSize::_4K>(vaddr, paddr, rwx, u, g);
+            // 单次遍历, 依次填写各末级页表中的页表项
+            auto walk_res = for_each_pte<true>(
+                _vs, _size, [&](VirAddr vaddr, PTE &pte, PageSize size) {
+                    if (size != PageSize::_4K || pte.v) {
+                        loggers::PAGING::ERROR("vaddr = %p 处已有映射!",
+                                               vaddr.addr());
+                        return true;
+                    }
+                    set_leaf(pte, _ps + (vaddr - _vs), rwx, u, g);
+                    return true;
+                });
+            if (!walk_res.has_value()) {
+                loggers::PAGING::ERROR("无法映射页: 无可用物理页");
             }
         } else {
             // 将 vaddr 与 paddr 向下对齐到4K
@@ -532,17 +902,18 @@ public:
         }
 
         QueryResult qres = query_res.value();
-        qres.pte->value  = 0;
+        clear_entry(*qres.pte);
     }
 
     void unmap_range(VirAddr vstart, size_t size) {
-        const VirAddr _vs  = vstart.page_align_down();
-        const size_t _size = page_align_up(size);
-        const size_t _cnt  = _size / PAGESIZE;
-
-        for (size_t i = 0; i < _cnt; ++i) {
-            unmap_page(_vs + i * PAGESIZE);
-        }
+        // 不分配页表, 遍历不会失败; 变空的页表随之归还
+        auto walk_res [[maybe_unused]] = for_each_pte<false, true>(
+            vstart, size, [](VirAddr, PTE &pte, PageSize) {
+                if (pte.v) {
+                    clear_entry(pte);
+                }
+                return true;
+            });
     }
 
     static constexpr umb_t to_rwx_mask(ModifyMask mask) {
@@ -616,11 +987,16 @@ public:
         }
     }
 
-    // 更换页表根
+    // 更换页表根, 使用 ASID 0
     inline static void __switch_root(PhyAddr __root) {
+        __switch_root(__root, 0);
+    }
+
+    // 以指定 ASID 更换页表根
+    inline static void __switch_root(PhyAddr __root, uint16_t asid) {
         csr_satp_t new_satp;
         new_satp.mode = SATPMode::SV39;
-        new_satp.asid = 0;  // TODO: ASID支持
+        new_satp.asid = asid;
         new_satp.ppn  = Riscv64SV39PageMan::to_ppn(__root);
         csr_set_satp(new_satp);
     }
@@ -638,6 +1014,19 @@ public:
     inline static void flush_tlb() {
         asm volatile("sfence.vma");
     }
+
+    // 刷新指定 ASID 的全部非全局 TLB 项
+    inline static void flush_tlb_asid(uint16_t asid) {
+        asm volatile("sfence.vma zero, %0" ::"r"(static_cast<umb_t>(asid))
+                     : "memory");
+    }
+
+    // 刷新指定 ASID 下某一虚拟地址的非全局 TLB 项
+    inline static void flush_tlb_page(VirAddr vaddr, uint16_t asid) {
+        asm volatile("sfence.vma %0, %1" ::"r"(vaddr.arith()),
+                     "r"(static_cast<umb_t>(asid))
+                     : "memory");
+    }
 };
 
 static_assert(ArchPageManTrait<Riscv64SV39PageMan<KernelStage::PRE_INIT>>);
@@ -12,6 +12,7 @@
 #include <arch/riscv64/csr.h>
 #include <arch/riscv64/device/fdt_helper.h>
 #include <arch/riscv64/device/misc.h>
+#include <arch/riscv64/smp.h>
 #include <arch/riscv64/trait.h>
 #include <logger.h>
 #include <libfdt.h>
@@ -60,4 +61,21 @@ void Riscv64Initialization::post_init(void) {
     }
     loggers::DEVICE::INFO("时钟频率: %d Hz = %d KHz = %d MHz", freq.to_hz(), freq.to_khz(), freq.to_mhz());
     init_timer(freq, 100_Hz); // 100Hz的时钟频率意味着每10ms触发一次时钟中断
+
+    // 允许用户态读取 time 计数器, 供模块自行计时
+    csr_scounteren_t scounteren = csr_get_scounteren();
+    scounteren.tm               = 1;
+    csr_set_scounteren(scounteren);
+
+    // 设备树此后不再可访问, 先记录下其余处理器
+    Riscv64SMP::probe();
+}
+
+void Riscv64Initialization::secondary_init(void) {
+    // 计时器与计数器访问权限均为各 hart 独立的状态, 沿用引导核的设置
+    init_timer(timer_info.freq, timer_info.expected_freq);
+
+    csr_scounteren_t scounteren = csr_get_scounteren();
+    scounteren.tm               = 1;
+    csr_set_scounteren(scounteren);
 }
\ No newline at end of file
@@ -0,0 +1,223 @@
+/**
+ * @file smp.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief RISCV64 多处理器启动与核间 TLB 刷新
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <arch/riscv64/csr.h>
+#include <arch/riscv64/description.h>
+#include <arch/riscv64/device/fdt_helper.h>
+#include <arch/riscv64/device/misc.h>
+#include <arch/riscv64/smp.h>
+#include <cpu.h>
+#include <libfdt.h>
+#include <logger.h>
+#include <mem/gfp.h>
+#include <sbi/sbi.h>
+#include <sustcore/addr.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+extern int hart_id;
+extern PhyAddr kernel_root;
+
+extern "C" void secondary_entry(void);
+extern "C" void secondary_virt(void);
+
+namespace {
+    // 传递给 secondary_entry 的启动参数, 布局须与 entry.S 一致
+    struct HartBoot {
+        umb_t cpu;
+        umb_t satp;
+        umb_t stack_top;
+        umb_t entry;
+    };
+    static_assert(offsetof(HartBoot, satp) == 8);
+    static_assert(offsetof(HartBoot, stack_top) == 16);
+    static_assert(offsetof(HartBoot, entry) == 24);
+
+    HartBoot boot_args[cpu::MAX_CPUS];
+
+    // 等待新处理器上线的时限
+    constexpr size_t ONLINE_TIMEOUT_MS = 1000;
+
+    bool wait_online(size_t target) {
+        const umb_t start = csr_get_time();
+        const umb_t limit = timer_info.freq.to_hz() / 1000 * ONLINE_TIMEOUT_MS;
+        while (cpu::online() < target) {
+            if (csr_get_time() - start > limit) {
+                return false;
+            }
+        }
+        return true;
+    }
+}  // namespace
+
+umb_t Riscv64SMP::hartids[cpu::MAX_CPUS];
+umb_t Riscv64SMP::candidates[cpu::MAX_CPUS];
+size_t Riscv64SMP::candidate_cnt = 0;
+
+void Riscv64SMP::probe() {
+    hartids[0]    = static_cast<umb_t>(hart_id);
+    candidate_cnt = 0;
+
+    FDTNodeDesc root = FDTHelper::get_root_node();
+    FDTNodeDesc cpus = FDTHelper::get_subnode(root, "cpus");
+    if (cpus < 0) {
+        loggers::SUSTCORE::WARN("未找到/cpus节点, 仅使用引导核");
+        return;
+    }
+
+    FDTNodeDesc node;
+    fdt_for_each_subnode(node, FDTHelper::fdt, cpus) {
+        FDTPropDesc type = FDTHelper::get_property(node, "device_type");
+        if (type < 0 ||
+            strcmp(FDTHelper::get_property_value_as_string(type), "cpu") != 0)
+        {
+            continue;
+        }
+        FDTPropDesc status = FDTHelper::get_property(node, "status");
+        if (status >= 0) {
+            const char *str = FDTHelper::get_property_value_as_string(status);
+            if (strcmp(str, "okay") != 0 && strcmp(str, "ok") != 0) {
+                continue;
+            }
+        }
+        FDTPropDesc reg = FDTHelper::get_property(node, "reg");
+        if (reg < 0) {
+            continue;
+        }
+        umb_t hartid = FDTHelper::get_property_value_as<dword, 0>(reg);
+        if (hartid == hartids[0]) {
+            continue;
+        }
+        if (candidate_cnt + 1 >= cpu::MAX_CPUS) {
+            loggers::SUSTCORE::WARN("处理器数超过上限 %d, 忽略 hart %d",
+                                    cpu::MAX_CPUS, hartid);
+            continue;
+        }
+        candidates[candidate_cnt++] = hartid;
+    }
+    loggers::SUSTCORE::INFO("设备树中共有 %d 个可用处理器, 引导核为 hart %d",
+                            candidate_cnt + 1, hartids[0]);
+}
+
+void Riscv64SMP::boot_secondaries() {
+    // 新处理器以内核页表开启分页, 使用 ASID 0
+    csr_satp_t satp = {};
+    satp.mode       = SATPMode::SV39;
+    satp.asid       = 0;
+    satp.ppn        = PageMan::to_ppn(kernel_root);
+
+    const PhyAddr entry = convert_pointer(
+        reinterpret_cast<const void *>(secondary_entry));
+
+    for (size_t i = 0; i < candidate_cnt; i++) {
+        const size_t id    = cpu::online();
+        const umb_t target = candidates[i];
+
+        auto stack_res = GFP::get_free_page(BOOT_STACK_PAGES);
+        if (!stack_res.has_value()) {
+            loggers::SUSTCORE::ERROR("无法为 hart %d 分配启动栈", target);
+            break;
+        }
+        PhyAddr stack = stack_res.value();
+        KpaAddr stack_top =
+            convert<KpaAddr>(stack + BOOT_STACK_PAGES * PAGESIZE);
+
+        HartBoot &boot = boot_args[id];
+        boot.cpu       = id;
+        boot.satp      = satp.value;
+        boot.stack_top = stack_top.arith();
+        boot.entry     = reinterpret_cast<umb_t>(secondary_virt);
+        hartids[id]    = target;
+
+        SBIRet ret = sbi_hart_start(target, entry.arith(),
+                                    convert_pointer(&boot).arith());
+        if (ret.error != 0) {
+            loggers::SUSTCORE::WARN("启动 hart %d 失败, 错误码: %d", target,
+                                    ret.error);
+            GFP::put_page(stack, BOOT_STACK_PAGES);
+            continue;
+        }
+
+        // 逐个启动以保证逻辑编号连续; 超时的 hart 可能仍在使用启动栈,
+        // 因此不再回收, 也不再启动其后的 hart
+        if (!wait_online(id + 1)) {
+            loggers::SUSTCORE::ERROR("hart %d 未能在 %d ms 内上线", target,
+                                     ONLINE_TIMEOUT_MS);
+            break;
+        }
+        loggers::SUSTCORE::INFO("hart %d 已上线, 逻辑编号 %d", target, id);
+    }
+    loggers::SUSTCORE::INFO("共 %d 个处理器在线", cpu::online());
+}
+
+umb_t Riscv64SMP::hartid(size_t cpu) {
+    assert(cpu < cpu::online());
+    return hartids[cpu];
+}
+
+bool Riscv64SMP::others_mask(umb_t &mask, umb_t &base) {
+    const size_t online = cpu::online();
+    const size_t self   = cpu::current();
+    constexpr umb_t ALL = ~static_cast<umb_t>(0);
+
+    base = ALL;
+    for (size_t i = 0; i < online; i++) {
+        if (i != self && hartids[i] < base) {
+            base = hartids[i];
+        }
+    }
+    if (base == ALL) {
+        return false;
+    }
+
+    mask = 0;
+    for (size_t i = 0; i < online; i++) {
+        if (i == self) {
+            continue;
+        }
+        umb_t offset = hartids[i] - base;
+        if (offset >= sizeof(umb_t) * 8) {
+            // hart id 跨度超出一个掩码, 退化为通知全部 hart
+            base = ALL;
+            mask = 0;
+            return true;
+        }
+        mask |= static_cast<umb_t>(1) << offset;
+    }
+    return true;
+}
+
+void Riscv64SMP::flush_tlb_others() {
+    umb_t mask, base;
+    if (!others_mask(mask, base)) {
+        return;
+    }
+    sbi_remote_sfence_vma(mask, base, 0, ~static_cast<umb_t>(0));
+}
+
+void Riscv64SMP::flush_tlb_asid_others(uint16_t asid) {
+    umb_t mask, base;
+    if (!others_mask(mask, base)) {
+        return;
+    }
+    sbi_remote_sfence_vma_asid(mask, base, 0, ~static_cast<umb_t>(0), asid);
+}
+
+void Riscv64SMP::flush_tlb_range_others(VirAddr vaddr, size_t size,
+                                        uint16_t asid) {
+    umb_t mask, base;
+    if (!others_mask(mask, base)) {
+        return;
+    }
+    sbi_remote_sfence_vma_asid(mask, base, vaddr.arith(), size, asid);
+}
@@ -0,0 +1,84 @@
+/**
+ * @file smp.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief RISCV64 多处理器启动与核间 TLB 刷新
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <arch/trait.h>
+#include <cpu.h>
+#include <sus/types.h>
+#include <sustcore/addr.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 经 SBI HSM 启动其余 hart, 并经 SBI RFENCE 刷新其它 hart 的 TLB.
+ *
+ * 逻辑编号按上线顺序分配, 引导核为 0. 处理器逐个启动,
+ * 前一个上线后才启动下一个, 因此在线处理器的编号总是连续的.
+ */
+class Riscv64SMP {
+public:
+    /**
+     * @brief 从设备树 /cpus 中枚举可用的 hart
+     *
+     * 需在设备树仍可由内核访问时 (即 Initialization::post_init 中) 调用
+     */
+    static void probe();
+
+    /**
+     * @brief 依次启动 probe 得到的其余 hart
+     *
+     * 各 hart 以内核页表开启分页后进入 secondary_main.
+     * 调用者须持有内核大锁, 新处理器在完成上线登记后等待该锁.
+     */
+    static void boot_secondaries();
+
+    /**
+     * @brief 逻辑编号对应的 hart id
+     */
+    static umb_t hartid(size_t cpu);
+
+    /**
+     * @brief 刷新其它在线处理器的全部 TLB 项
+     */
+    static void flush_tlb_others();
+
+    /**
+     * @brief 刷新其它在线处理器上指定 ASID 的 TLB 项
+     */
+    static void flush_tlb_asid_others(uint16_t asid);
+
+    /**
+     * @brief 刷新其它在线处理器上指定 ASID 下某一区间的 TLB 项
+     */
+    static void flush_tlb_range_others(VirAddr vaddr, size_t size,
+                                       uint16_t asid);
+
+private:
+    // 每个处理器启动阶段使用的内核栈大小
+    static constexpr size_t BOOT_STACK_PAGES = 4;
+
+    // 已分配逻辑编号的 hart
+    static umb_t hartids[cpu::MAX_CPUS];
+    // 设备树中除引导核外的可用 hart
+    static umb_t candidates[cpu::MAX_CPUS];
+    static size_t candidate_cnt;
+
+    /**
+     * @brief 计算除自身外在线处理器的 hart 掩码
+     *
+     * @return 没有其它在线处理器时返回 false
+     */
+    static bool others_mask(umb_t &mask, umb_t &base);
+};
+
+static_assert(SMPTrait<Riscv64SMP>);
@@ -32,6 +32,8 @@ class Riscv64Initialization {
 public:
     static void pre_init(void);
     static void post_init(void);
+    // 其余处理器上线时的架构相关初始化
+    static void secondary_init(void);
 };
 
 static_assert(InitializationTrait<Riscv64Initialization>);
@@ -69,6 +71,10 @@ struct Riscv64Context {
         return this->regs[X1_BASE + 1];  // x2 = sp
     }
 
+    constexpr umb_t &tp() {
+        return this->regs[X1_BASE + 3];  // x4 = tp
+    }
+
     static void switch_to(void *kstack);
     constexpr static size_t CONTEXT_OFFSET = 0;
     inline static Riscv64Context *from_kstack(void *kstack_top) {
@@ -140,6 +146,15 @@ struct Riscv64Interrupt {
         csr_sstatus_t sstatus = csr_get_sstatus();
         return sstatus.sie;
     }
+
+    /**
+     * @brief 等待中断到来
+     *
+     * 关中断时同样会被未决的中断唤醒, 开中断后随即陷入
+     */
+    static void wait() {
+        asm volatile("wfi");
+    }
 };
 
 static_assert(InterruptTrait<Riscv64Interrupt>);
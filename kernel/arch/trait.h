@@ -17,6 +17,7 @@
 
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 
 /**
  * @brief 架构串口 Trait
@@ -52,6 +53,37 @@ concept InitializationTrait = requires() {
     {
         T::post_init()
     } -> std::same_as<void>;
+    {
+        T::secondary_init()
+    } -> std::same_as<void>;
+};
+
+/**
+ * @brief 多处理器管理 Trait
+ *
+ * @tparam T 架构多处理器管理类
+ */
+template <typename T>
+concept SMPTrait = requires(size_t cpu, VirAddr vaddr, size_t size,
+                            uint16_t asid) {
+    {
+        T::probe()
+    } -> std::same_as<void>;
+    {
+        T::boot_secondaries()
+    } -> std::same_as<void>;
+    {
+        T::hartid(cpu)
+    } -> std::convertible_to<umb_t>;
+    {
+        T::flush_tlb_others()
+    } -> std::same_as<void>;
+    {
+        T::flush_tlb_asid_others(asid)
+    } -> std::same_as<void>;
+    {
+        T::flush_tlb_range_others(vaddr, size, asid)
+    } -> std::same_as<void>;
 };
 
 /**
@@ -290,6 +322,9 @@ concept InterruptTrait = requires() {
     {
         T::enabled()
     } -> std::convertible_to<bool>;
+    {
+        T::wait()
+    } -> std::same_as<void>;
 };
 
 // Write-Protection Fault Infomation Trait
@@ -0,0 +1,91 @@
+/**
+ * @file cpu.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 处理器编号与 per-CPU 数据
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+namespace cpu {
+    // 支持的最大处理器数
+    constexpr size_t MAX_CPUS = 8;
+
+    /**
+     * @brief 获得当前处理器的逻辑编号
+     *
+     * 内核态下 tp 寄存器固定保存本处理器的逻辑编号: 引导核在入口处
+     * 将其置 0, 其余处理器由启动参数设置; 陷入时由 trap.S 负责在
+     * 用户 tp 与之间切换. 引导核的逻辑编号恒为 0.
+     *
+     * @return size_t 逻辑编号, 范围为 [0, MAX_CPUS)
+     */
+    inline size_t current() {
+        size_t id;
+        asm volatile("mv %0, tp" : "=r"(id));
+        return id;
+    }
+
+    // 已上线的处理器数, 引导核计入其中
+    inline size_t online_cnt = 1;
+
+    /**
+     * @brief 获得已上线的处理器数
+     *
+     * 逻辑编号按上线顺序连续分配, 因此 [0, online()) 均为在线处理器
+     */
+    inline size_t online() {
+        return __atomic_load_n(&online_cnt, __ATOMIC_ACQUIRE);
+    }
+
+    /**
+     * @brief 由新上线的处理器调用, 登记自身
+     */
+    inline void mark_online() {
+        __atomic_fetch_add(&online_cnt, 1, __ATOMIC_ACQ_REL);
+    }
+
+    /**
+     * @brief per-CPU 数据
+     *
+     * 每个处理器各持有一份 T, 仅应由对应处理器访问本地副本;
+     * 跨处理器读取 (如统计汇总) 需自行保证一致性.
+     *
+     * @tparam T 数据类型
+     */
+    template <typename T>
+    class PerCPU {
+    private:
+        T _slots[MAX_CPUS];
+
+    public:
+        constexpr PerCPU() : _slots() {}
+
+        T &local() {
+            return _slots[current()];
+        }
+        const T &local() const {
+            return _slots[current()];
+        }
+
+        T &of(size_t cpu) {
+            assert(cpu < MAX_CPUS);
+            return _slots[cpu];
+        }
+        const T &of(size_t cpu) const {
+            assert(cpu < MAX_CPUS);
+            return _slots[cpu];
+        }
+
+        static constexpr size_t size() {
+            return MAX_CPUS;
+        }
+    };
+}  // namespace cpu
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <arch/riscv64/description.h>
+#include <cpu.h>
 #include <mem/vma.h>
 #include <sustcore/addr.h>
 
@@ -47,10 +48,16 @@ namespace env {
         }
     };
 
+    /**
+     * @brief 内核运行环境
+     *
+     * 当前地址空间与陷入上下文随处理器而异, 按 per-CPU 保存,
+     * 读写均作用于当前处理器的副本; 内存布局为全局共享.
+     */
     class Environment {
     private:
-        TaskMemoryManager *_tmm = nullptr;
-        Context *_trap_context  = nullptr;
+        cpu::PerCPU<TaskMemoryManager *> _tmm;
+        cpu::PerCPU<Context *> _trap_context;
         MemInfo _meminfo;
     public:
         constexpr Environment() : _meminfo() {}
@@ -58,20 +65,20 @@ namespace env {
         // readers
         [[nodiscard]]
         TaskMemoryManager *tmm() const {
-            return _tmm;
+            return _tmm.local();
         }
         [[nodiscard]]
         TaskMemoryManager *&tmm(key::tmm) {
-            return _tmm;
+            return _tmm.local();
         }
 
         [[nodiscard]]
         Context *trap_context() const {
-            return _trap_context;
+            return _trap_context.local();
         }
         [[nodiscard]]
         Context *&trap_context(key::trap_context) {
-            return _trap_context;
+            return _trap_context.local();
         }
 
         [[nodiscard]]
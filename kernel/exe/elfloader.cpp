@@ -15,6 +15,7 @@
 #include <elf.h>
 #include <env.h>
 #include <exe/elfloader.h>
+#include <exe/image_cache.h>
 #include <logger.h>
 #include <mem/kaddr.h>
 #include <mem/vma.h>
@@ -88,8 +89,15 @@ namespace loader::elf {
         void_return();
     }
 
-    // 将段内内容加载到内存中
-    Result<void> loadsegs(cap::VFileObject &fop, Elf64_Ehdr ehdr) {
+    // 段可按需分页: 文件内容常驻内存, 且段起点页对齐,
+    // 使 Memory 内各页与段内各页一一对应
+    inline bool demand_paged(const Elf64_Phdr &phdr, const uint8_t *image) {
+        return image != nullptr && VirAddr(phdr.p_vaddr).aligned<PAGESIZE>();
+    }
+
+    // 将无法按需分页的段内容加载到内存中
+    Result<void> loadsegs(cap::VFileObject &fop, Elf64_Ehdr ehdr,
+                          const uint8_t *image) {
         // 解析程序头表并将段内容加载到内存中
         for (size_t i = 0; i < ehdr.e_phnum; ++i) {
             Elf64_Phdr phdr{};
@@ -98,7 +106,7 @@ namespace loader::elf {
             auto read_phdr_res = fop.read_exact(offset, &phdr, sizeof(phdr));
             propagate(read_phdr_res);
 
-            if (phdr.p_type != PT_LOAD) {
+            if (phdr.p_type != PT_LOAD || demand_paged(phdr, image)) {
                 continue;  // 目前仅处理可加载段
             }
 
@@ -119,6 +127,98 @@ namespace loader::elf {
         void_return();
     }
 
+    // 在 heap_start 处为 spec 建立一个空堆, 并将其 Memory 放入 holder
+    Result<void> add_heap(TaskSpec &spec, VirAddr heap_start) {
+        auto *heap_mem =
+            new cap::MemoryPayload(0, false, false, VMA::Growth::FLEXUP);
+        auto heap_cap_res = spec.holder->internal_insert_to_free(heap_mem);
+        if (!heap_cap_res.has_value()) {
+            delete heap_mem;
+            propagate_return(heap_cap_res);
+        }
+        auto heap_res = spec.tmm->add_vma(VMA::Type::HEAP, VMA::Growth::FLEXUP,
+                                          VirArea(heap_start, heap_start),
+                                          heap_mem, PageMan::RWX::RW);
+        if (!heap_res.has_value()) {
+            loggers::SUSTCORE::ERROR("无法初始化堆VMA: %d", heap_res.error());
+            propagate_return(heap_res);
+        }
+        // 堆增长到覆盖整个 2M 窗口后, 该窗口以大页映射
+        heap_res.value()->huge = true;
+        spec.heap_vaddr   = heap_start;
+        spec.heap_mem_cap = heap_cap_res.value();
+        void_return();
+    }
+
+    // 切换到 spec 的地址空间, 复制无法按需分页的段, 完成后恢复其权限
+    Result<void> load_eager(TaskSpec &spec, cap::VFileObject &fop,
+                            const Elf64_Ehdr &ehdr, const uint8_t *image) {
+        auto *origin_tmm   = env::inst().tmm();
+        PhyAddr origin_pgd = env::inst().pgd();
+
+        env::inst().tmm(key::elfloader()) = spec.tmm.get();
+        spec.tmm->activate();
+
+        // 开始加载段. 这里在 S-Mode 直接写用户虚拟地址, 需要打开 SUM. 
+        {
+            ker_paddr::SumGuard sum_guard;
+            sum_guard.open();
+            auto load_res = loadsegs(fop, ehdr, image);
+            if (!load_res.has_value()) {
+                env::inst().tmm(key::elfloader()) = origin_tmm;
+                TaskMemoryManager::switch_to(origin_tmm, origin_pgd);
+                propagate_return(load_res);
+            }
+        }
+
+        // 将各个段的VMA的loading标记为false
+        // 同时将其对应的内存权限改回正常值
+        for (auto &vma : spec.tmm->vmas()) {
+            if (!vma.loading) {
+                continue;
+            }
+            vma.loading      = false;
+            PageMan::RWX rwx = VMA::seg2rwx(vma.type);
+            spec.tmm->pman().modify_range_flags<PageMan::make_mask(0b001111)>(
+                vma.varea.begin, vma.size(), rwx, true, false);
+        }
+
+        // 输出每个VMA的开头几个字节以供调试
+        loggers::SUSTCORE::DEBUG("每个VMA的前16字节内容:");
+        for (const auto &vma : spec.tmm->vmas()) {
+            // 按需分页的段尚未映射, 不应为调试输出而缺页
+            if (vma.varea.nullable() || vma.memory->backing != nullptr) {
+                continue;
+            }
+
+            // 打开SUM以访问用户空间地址
+            ker_paddr::SumGuard sum_guard;
+            sum_guard.open();
+
+            loggers::SUSTCORE::DEBUG("  VMA类型: %s, 起始地址: %p",
+                                    to_string(vma.type),
+                                    vma.varea.begin.addr());
+
+            const size_t dump_size = vma.size() < 16 ? vma.size() : 16;
+            const unsigned char *data =
+                reinterpret_cast<const unsigned char *>(vma.varea.begin.addr());
+
+            std::string hex_dump;
+            for (size_t i = 0; i < dump_size; ++i) {
+                char buf[4];
+                sprintf(buf, "%02x ", data[i]);
+                hex_dump += buf;
+            }
+            loggers::SUSTCORE::DEBUG("    前%d字节: %s", dump_size,
+                                    hex_dump.c_str());
+        }
+
+        env::inst().tmm(key::elfloader()) = origin_tmm;
+        TaskMemoryManager::switch_to(origin_tmm, origin_pgd);
+
+        void_return();
+    }
+
     Result<void> load(TaskSpec &spec, const LoadPrm &prm) {
         if (spec.tmm.get() == nullptr) {
             unexpect_return(ErrCode::NULLPTR);
@@ -132,6 +232,14 @@ namespace loader::elf {
         propagate(access_res);
         cap::VFileObject fop(util::nnullforce(access_res.value()));
 
+        // 同一文件已加载过时直接复用缓存的镜像, 无需再读文件
+        const ImageCache::Image *cached = ImageCache::lookup(fop.vind());
+        if (cached != nullptr) {
+            auto map_res = ImageCache::map(*cached, spec);
+            propagate(map_res);
+            return add_heap(spec, cached->heap_vaddr);
+        }
+
         auto fsz_res = fop.size();
         if (!fsz_res.has_value()) {
             propagate_return(fsz_res);
@@ -150,7 +258,15 @@ namespace loader::elf {
 
         spec.entrypoint = VirAddr(ehdr.e_entry);
 
+        // 文件内容常驻内存时, 段按需从中映射或复制, 不在加载时读入
+        const uint8_t *image = nullptr;
+        auto mapping_res     = fop.mapping();
+        if (mapping_res.has_value()) {
+            image = static_cast<const uint8_t *>(mapping_res.value());
+        }
+
         addr_t max_pload_end = 0;
+        bool eager           = false;
 
         // 解析程序头表并为TM添加相应的VMA
         for (size_t i = 0; i < ehdr.e_phnum; ++i) {
@@ -195,30 +311,22 @@ namespace loader::elf {
                                          add_res.error());
                 while (true);
             }
-            add_res->get()->loading = true;  // 标记该VMA正在加载
+            // 段内容只由 VMA (及之后的镜像缓存) 引用, 不放入 capability 表
+            segment_mem->image_owned = true;
+            if (demand_paged(phdr, image)) {
+                segment_mem->set_backing(image + phdr.p_offset, phdr.p_filesz);
+            } else {
+                add_res->get()->loading = true;  // 标记该VMA正在加载
+                eager                   = true;
+            }
 
             if (segvend.arith() > max_pload_end) {
                 max_pload_end = segvend.arith();
             }
         }
 
-        VirAddr heap_start = VirAddr(max_pload_end).page_align_up();
-        auto *heap_mem =
-            new cap::MemoryPayload(0, false, false, VMA::Growth::FLEXUP);
-        auto heap_cap_res = spec.holder->internal_insert_to_free(heap_mem);
-        if (!heap_cap_res.has_value()) {
-            delete heap_mem;
-            propagate_return(heap_cap_res);
-        }
-        auto heap_res = spec.tmm->add_vma(VMA::Type::HEAP, VMA::Growth::FLEXUP,
-                                          VirArea(heap_start, heap_start),
-                                          heap_mem, PageMan::RWX::RW);
-        if (!heap_res.has_value()) {
-            loggers::SUSTCORE::ERROR("无法初始化堆VMA: %d", heap_res.error());
-            propagate_return(heap_res);
-        }
-        spec.heap_vaddr   = heap_start;
-        spec.heap_mem_cap = heap_cap_res.value();
+        auto heap_res = add_heap(spec, VirAddr(max_pload_end).page_align_up());
+        propagate(heap_res);
 
         // 输出TM中的VMA信息以供调试
         loggers::SUSTCORE::DEBUG("ELF加载完成, TM中的VMA列表:");
@@ -228,68 +336,18 @@ namespace loader::elf {
                                     vma.varea.end.addr(), vma.size());
         }
 
-        auto *origin_tmm   = env::inst().tmm();
-        PhyAddr origin_pgd = env::inst().pgd();
-
-        env::inst().tmm(key::elfloader()) = spec.tmm.get();
-        spec.tmm->pman().switch_root();
-        PageMan::flush_tlb();
-
-        // 开始加载段. 这里在 S-Mode 直接写用户虚拟地址, 需要打开 SUM. 
-        {
-            ker_paddr::SumGuard sum_guard;
-            sum_guard.open();
-            auto load_res = loadsegs(fop, ehdr);
-            if (!load_res.has_value()) {
-                env::inst().tmm(key::elfloader()) = origin_tmm;
-                PageMan(origin_pgd).switch_root();
-                PageMan::flush_tlb();
-                propagate_return(load_res);
-            }
-        }
-
-        // 将各个段的VMA的loading标记为false
-        // 同时将其对应的内存权限改回正常值
-        for (auto &vma : spec.tmm->vmas()) {
-            vma.loading      = false;
-            PageMan::RWX rwx = VMA::seg2rwx(vma.type);
-            spec.tmm->pman().modify_range_flags<PageMan::make_mask(0b001111)>(
-                vma.varea.begin, vma.size(), rwx, true, false);
+        if (eager) {
+            auto eager_res = load_eager(spec, fop, ehdr, image);
+            propagate(eager_res);
         }
 
-        // 输出每个VMA的开头几个字节以供调试
-        loggers::SUSTCORE::DEBUG("每个VMA的前16字节内容:");
-        for (const auto &vma : spec.tmm->vmas()) {
-            if (vma.varea.nullable()) {
-                continue;
-            }
-
-            // 打开SUM以访问用户空间地址
-            ker_paddr::SumGuard sum_guard;
-            sum_guard.open();
-
-            loggers::SUSTCORE::DEBUG("  VMA类型: %s, 起始地址: %p",
-                                    to_string(vma.type),
-                                    vma.varea.begin.addr());
-
-            const size_t dump_size = vma.size() < 16 ? vma.size() : 16;
-            const unsigned char *data =
-                reinterpret_cast<const unsigned char *>(vma.varea.begin.addr());
-
-            std::string hex_dump;
-            for (size_t i = 0; i < dump_size; ++i) {
-                char buf[4];
-                sprintf(buf, "%02x ", data[i]);
-                hex_dump += buf;
-            }
-            loggers::SUSTCORE::DEBUG("    前%d字节: %s", dump_size,
-                                    hex_dump.c_str());
+        // 缓存失败不影响本次加载
+        auto cache_res = ImageCache::insert(fop.vind(), spec);
+        if (!cache_res.has_value()) {
+            loggers::SUSTCORE::DEBUG("镜像未能加入缓存: %d",
+                                     cache_res.error());
         }
 
-        env::inst().tmm(key::elfloader()) = origin_tmm;
-        PageMan(origin_pgd).switch_root();
-        PageMan::flush_tlb();
-
         void_return();
     }
 
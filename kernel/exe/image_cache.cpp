@@ -0,0 +1,183 @@
+/**
+ * @file image_cache.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 已加载进程镜像的缓存
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <exe/image_cache.h>
+#include <logger.h>
+#include <mem/vma.h>
+
+namespace loader {
+    ImageCache::Image *ImageCache::images[ImageCache::MAX_IMAGES];
+    size_t ImageCache::clock = 0;
+
+    const ImageCache::Image *ImageCache::lookup(VINode *vind) {
+        for (Image *image : images) {
+            if (image != nullptr && image->vind == vind) {
+                image->last_use = ++clock;
+                return image;
+            }
+        }
+        return nullptr;
+    }
+
+    void ImageCache::release_segments(Image &image) {
+        for (size_t i = 0; i < image.seg_count; i++) {
+            image.segs[i].memory->release();
+        }
+        image.seg_count = 0;
+    }
+
+    void ImageCache::evict(size_t slot) {
+        Image *image = images[slot];
+        if (image == nullptr) {
+            return;
+        }
+        release_segments(*image);
+        image->vind->release();
+        delete image;
+        images[slot] = nullptr;
+    }
+
+    Result<void> ImageCache::insert(VINode *vind, TaskSpec &spec) {
+        if (vind == nullptr || spec.tmm.get() == nullptr) {
+            unexpect_return(ErrCode::NULLPTR);
+        }
+        invalidate(vind);
+
+        auto *image       = new Image();
+        image->vind       = vind;
+        image->entrypoint = spec.entrypoint;
+        image->heap_vaddr = spec.heap_vaddr;
+        image->seg_count  = 0;
+
+        for (auto &vma : spec.tmm->vmas()) {
+            if (vma.type == VMA::Type::HEAP) {
+                continue;
+            }
+            if (image->seg_count == MAX_SEGMENTS) {
+                release_segments(*image);
+                delete image;
+                unexpect_return(ErrCode::NOT_SUPPORTED);
+            }
+
+            // 可写段保存一份 COW 快照, 只读段直接共享
+            cap::MemoryPayload *memory = vma.memory;
+            if (PageMan::is_writable(vma.rwx)) {
+                memory = static_cast<cap::MemoryPayload *>(
+                    vma.memory->clone_payload());
+                if (memory == nullptr) {
+                    release_segments(*image);
+                    delete image;
+                    unexpect_return(ErrCode::OUT_OF_MEMORY);
+                }
+            }
+            memory->image_owned = true;
+            memory->keep();
+            image->segs[image->seg_count++] =
+                Segment{vma.type, vma.varea, vma.rwx, memory};
+        }
+
+        // 快照已引用可写段的页, 当前进程对其的可写映射须转为 COW
+        for (size_t i = 0; i < image->seg_count; i++) {
+            const Segment &seg = image->segs[i];
+            if (!PageMan::is_writable(seg.rwx)) {
+                continue;
+            }
+            auto vma_res = spec.tmm->locate_range(seg.varea);
+            auto protect_res =
+                vma_res.and_then([&spec](util::nonnull<VMA *> vma) {
+                    return spec.tmm->protect_memory_cow(vma->memory);
+                });
+            if (!protect_res.has_value()) {
+                release_segments(*image);
+                delete image;
+                propagate_return(protect_res);
+            }
+        }
+
+        // 优先使用空槽, 否则淘汰最久未命中的项
+        size_t victim = 0;
+        for (size_t i = 0; i < MAX_IMAGES; i++) {
+            if (images[i] == nullptr) {
+                victim = i;
+                break;
+            }
+            if (images[i]->last_use < images[victim]->last_use) {
+                victim = i;
+            }
+        }
+        evict(victim);
+
+        vind->keep();
+        image->last_use = ++clock;
+        images[victim]  = image;
+        void_return();
+    }
+
+    Result<void> ImageCache::map(const Image &image, TaskSpec &spec) {
+        if (spec.tmm.get() == nullptr) {
+            unexpect_return(ErrCode::NULLPTR);
+        }
+
+        for (size_t i = 0; i < image.seg_count; i++) {
+            const Segment &seg         = image.segs[i];
+            cap::MemoryPayload *memory = seg.memory;
+            if (PageMan::is_writable(seg.rwx)) {
+                memory = static_cast<cap::MemoryPayload *>(
+                    seg.memory->clone_payload());
+                if (memory == nullptr) {
+                    unexpect_return(ErrCode::OUT_OF_MEMORY);
+                }
+                memory->image_owned = true;
+            }
+            auto add_res = spec.tmm->add_vma(seg.type, VMA::Growth::FIXED,
+                                             seg.varea, memory, seg.rwx);
+            if (!add_res.has_value()) {
+                if (memory != seg.memory) {
+                    memory->destruct();
+                }
+                propagate_return(add_res);
+            }
+        }
+
+        spec.entrypoint = image.entrypoint;
+        spec.heap_vaddr = image.heap_vaddr;
+        loggers::SUSTCORE::DEBUG("镜像缓存命中, 映射 %d 个段, 入口点 %p",
+                                 image.seg_count, image.entrypoint.addr());
+        void_return();
+    }
+
+    void ImageCache::invalidate(VINode *vind) {
+        for (size_t i = 0; i < MAX_IMAGES; i++) {
+            if (images[i] != nullptr && images[i]->vind == vind) {
+                evict(i);
+            }
+        }
+    }
+
+    void ImageCache::drop(const VSuperblock &vsb) {
+        for (size_t i = 0; i < MAX_IMAGES; i++) {
+            if (images[i] != nullptr && &images[i]->vind->superblock() == &vsb)
+            {
+                evict(i);
+            }
+        }
+    }
+
+    size_t ImageCache::size() {
+        size_t count = 0;
+        for (const Image *image : images) {
+            if (image != nullptr) {
+                count++;
+            }
+        }
+        return count;
+    }
+}  // namespace loader
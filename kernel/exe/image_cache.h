@@ -0,0 +1,102 @@
+/**
+ * @file image_cache.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 已加载进程镜像的缓存
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <exe/task.h>
+#include <mem/vma.h>
+#include <object/memory.h>
+#include <sustcore/addr.h>
+#include <vfs/vfs.h>
+
+#include <cstddef>
+
+namespace loader {
+    /**
+     * @brief 以 inode 为键缓存已加载完成的进程镜像.
+     *
+     * 缓存保存解析出的入口点, 堆起点与各段的布局. 只读段直接持有
+     * 首次加载时的 MemoryPayload, 命中时各进程共享同一 payload;
+     * 可写段持有加载完成时的 COW 快照, 命中时再克隆一份,
+     * 物理页经 GFP 引用计数在首次写入时才复制.
+     * 因此命中后的加载仅需建立 VMA, 无需再读文件.
+     *
+     * 缓存项持有 VINode 的引用, 文件被写入或所在文件系统卸载前须使其失效.
+     */
+    class ImageCache {
+    public:
+        static constexpr size_t MAX_IMAGES   = 16;
+        static constexpr size_t MAX_SEGMENTS = 8;
+
+        struct Segment {
+            VMA::Type type;
+            VirArea varea;
+            PageMan::RWX rwx;
+            // 缓存持有一份引用
+            cap::MemoryPayload *memory;
+        };
+
+        struct Image {
+            VINode *vind;
+            VirAddr entrypoint;
+            VirAddr heap_vaddr;
+            size_t seg_count;
+            Segment segs[MAX_SEGMENTS];
+            // 最近一次命中的时间戳, 用于选择淘汰项
+            size_t last_use;
+        };
+
+        /**
+         * @brief 查找 vind 对应的镜像
+         *
+         * @return 未缓存时返回 nullptr
+         */
+        static const Image *lookup(VINode *vind);
+
+        /**
+         * @brief 将 spec 中刚加载完成的镜像加入缓存
+         *
+         * 需在各段 loading 标记清除后调用. spec.tmm 中可写段的映射
+         * 会转为 COW, 以免其写入污染缓存中的快照. 缓存已满时淘汰最久未用项.
+         *
+         * @param vind 镜像文件的 inode
+         * @param spec 已由 elf::load 填充的 TaskSpec
+         */
+        static Result<void> insert(VINode *vind, TaskSpec &spec);
+
+        /**
+         * @brief 按缓存的镜像为 spec 建立各段 VMA, 并填充入口点与堆起点
+         *
+         * 不创建堆 VMA.
+         */
+        static Result<void> map(const Image &image, TaskSpec &spec);
+
+        /**
+         * @brief 使 vind 对应的缓存项失效
+         */
+        static void invalidate(VINode *vind);
+
+        /**
+         * @brief 使位于 vsb 上的所有缓存项失效
+         */
+        static void drop(const VSuperblock &vsb);
+
+        [[nodiscard]]
+        static size_t size();
+
+    private:
+        static Image *images[MAX_IMAGES];
+        static size_t clock;
+
+        static void release_segments(Image &image);
+        static void evict(size_t slot);
+    };
+}  // namespace loader
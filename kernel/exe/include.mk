@@ -1 +1 @@
-sources += elfloader.cpp
+sources += elfloader.cpp image_cache.cpp
@@ -17,6 +17,7 @@
 #include <cap/capability.h>
 #include <cap/cholder.h>
 #include <cap/permission.h>
+#include <cpu.h>
 #include <device/block.h>
 #include <env.h>
 #include <exe/elfloader.h>
@@ -35,6 +36,7 @@
 #include <sus/types.h>
 #include <sustcore/addr.h>
 #include <symbols.h>
+#include <sync/spinlock.h>
 #include <task/scheduler.h>
 #include <task/task.h>
 #include <task/wait.h>
@@ -152,8 +154,20 @@ Result<void> init_scheduler() {
 
     auto task = load_res.value();
     assert(task->threads.size() == 1);
-    schd::Scheduler::init(task->threads.front());
+
+    auto idle_res = task::TaskManager::inst().create_idle_thread();
+    if (!idle_res.has_value()) {
+        loggers::SUSTCORE::ERROR("创建空闲上下文失败! 错误码: %s",
+                                 to_cstring(idle_res.error()));
+        propagate_return(idle_res);
+    }
+    schd::Scheduler::init(idle_res.value());
     schd::Scheduler::inst().init();
+    // init 与其它进程一样经运行队列调度, 由 run_current 切换过去
+    if (!schd::Scheduler::inst().wakeup_new(&task->threads.front())) {
+        loggers::SUSTCORE::ERROR("唤醒初始进程失败");
+        unexpect_return(ErrCode::CREATION_FAILED);
+    }
     void_return();
 }
 
@@ -174,6 +188,8 @@ void after_init() {
     schd::Scheduler::inst().run_current();
 #endif
 
+    // 不进入用户态时也须释放内核大锁, 其余处理器才能开始调度
+    sync::kernel_lock.unlock();
     while (true);
 }
 
@@ -183,6 +199,9 @@ extern "C" void post_init(void) {
     loggers::SUSTCORE::INFO("已进入 post-init 阶段");
     auto &e = env::inst();
 
+    // 引导核持有内核大锁直至首次进入用户态, 其余处理器在此之前只能等待
+    sync::kernel_lock.lock();
+
     // 将 pre-init 阶段中初始化的子系统再次初始化, 以适应内核虚拟地址空间
     GFP::post_init();
     PageMan::init();
@@ -227,9 +246,33 @@ extern "C" void post_init(void) {
 
     task::wait::WaitReasonManager::init();
 
+    SMP::boot_secondaries();
+
     after_init();
 }
 
+extern "C" void secondary_main(void) {
+    // 陷入入口与 sscratch 均为各 hart 独立的状态
+    Interrupt::init();
+    cpu::mark_online();
+
+    sync::kernel_lock.lock();
+    loggers::SUSTCORE::INFO("处理器 %d 进入内核", cpu::current());
+    Initialization::secondary_init();
+
+    auto idle_res = task::TaskManager::inst().create_idle_thread();
+    if (!idle_res.has_value()) {
+        loggers::SUSTCORE::ERROR("处理器 %d 创建空闲上下文失败! 错误码: %s",
+                                 cpu::current(),
+                                 to_cstring(idle_res.error()));
+        sync::kernel_lock.unlock();
+        while (true);
+    }
+    schd::Scheduler::init(idle_res.value());
+    schd::Scheduler::inst().init();
+    schd::Scheduler::inst().run_current();
+}
+
 extern "C" void redive(void);
 
 void pre_init() {
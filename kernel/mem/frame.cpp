@@ -0,0 +1,81 @@
+/**
+ * @file frame.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 物理页描述符表
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <env.h>
+#include <logger.h>
+#include <mem/frame.h>
+
+#include <cstring>
+
+namespace key {
+    struct frame : public env::key::meminfo {
+    public:
+        frame() = default;
+    };
+}  // namespace key
+
+PhyAddr FrameTable::frames_pa = PhyAddr::null;
+size_t FrameTable::base_pfn   = 0;
+size_t FrameTable::frame_cnt  = 0;
+
+void FrameTable::pre_init() {
+    auto &meminfo = env::inst().meminfo(key::frame());
+
+    // 描述符表覆盖从最低内存区域到 uppm 的所有页
+    PhyAddr lowest = meminfo.uppm;
+    for (size_t i = 0; i < meminfo.region_cnt; ++i) {
+        if (meminfo.regions[i].ptr < lowest) {
+            lowest = meminfo.regions[i].ptr;
+        }
+    }
+    const size_t cnt = topfn(meminfo.uppm.page_align_up()) -
+                       topfn(lowest.page_align_down());
+    const size_t table_bytes = page_align_up(cnt * sizeof(PageFrame));
+
+    // 从第一个足够大的空闲区域头部划出描述符表
+    MemRegion *host = nullptr;
+    for (size_t i = 0; i < meminfo.region_cnt; ++i) {
+        MemRegion &region = meminfo.regions[i];
+        if (region.status != MemRegion::MemoryStatus::FREE) {
+            continue;
+        }
+        PhyAddr start_addr = region.ptr.page_align_up();
+        PhyAddr end_addr   = (region.ptr + region.size).page_align_down();
+        if (end_addr > start_addr && end_addr - start_addr >= table_bytes) {
+            host = &region;
+            break;
+        }
+    }
+    if (host == nullptr ||
+        meminfo.region_cnt >= env::MemInfo::MAX_REGIONS)
+    {
+        loggers::MEMORY::FATAL("无法为物理页描述符表划出 %d 字节内存",
+                               table_bytes);
+        while (true);
+    }
+
+    // 将表所在部分从空闲区域中切出, 登记为保留区域
+    PhyAddr table_pa   = host->ptr.page_align_up();
+    PhyAddr host_end   = host->ptr + host->size;
+    host->ptr          = table_pa + table_bytes;
+    host->size         = host_end - host->ptr;
+    meminfo.regions[meminfo.region_cnt++] = MemRegion{
+        table_pa, table_bytes, MemRegion::MemoryStatus::RESERVED};
+
+    memset(convert<_StageAddr<KernelStage::PRE_INIT>>(table_pa).addr(), 0,
+           table_bytes);
+    frames_pa = table_pa;
+    base_pfn  = topfn(lowest.page_align_down());
+    frame_cnt = cnt;
+
+    loggers::MEMORY::INFO("物理页描述符表位于 %p, 共 %d 项, 占用 %d 页",
+                          table_pa.addr(), cnt, table_bytes / PAGESIZE);
+}
@@ -0,0 +1,127 @@
+/**
+ * @file frame.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 物理页描述符表
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <sustcore/addr.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 物理页描述符.
+ *
+ * 每个受管理的物理页对应一项, 由各内存子系统共享:
+ * GFP 维护 refcount, 页框分配器维护 BUDDY 与 order,
+ * SLUB 维护 SLAB/LARGE 与 priv, 页表管理维护 PGTABLE, ptes 与 priv.
+ */
+struct PageFrame {
+    enum Flag : uint8_t {
+        // 该页为页框分配器中某一空闲块的首页, 块阶数见 order
+        BUDDY   = 1 << 0,
+        // 该页属于某个 slab, priv 为 SlabHeader 指针
+        SLAB    = 1 << 1,
+        // 该页被多个地址空间以 COW 方式共享
+        COW     = 1 << 2,
+        // 该页为 MixedSizeAllocator 大对象的首页, priv 为分配大小的 log2
+        LARGE   = 1 << 3,
+        // 该页为页表页, ptes 为其中的有效项数;
+        // 根页表的 priv 为其下 (不含自身) 的页表页总数
+        PGTABLE = 1 << 4,
+    };
+
+    uint32_t refcount;
+    uint8_t flags;
+    uint8_t order;
+    uint16_t ptes;
+    uintptr_t priv;
+
+    [[nodiscard]]
+    bool test(Flag flag) const {
+        return (flags & flag) != 0;
+    }
+    void set(Flag flag) {
+        flags |= flag;
+    }
+    void clear(Flag flag) {
+        flags &= static_cast<uint8_t>(~flag);
+    }
+};
+
+static_assert(sizeof(PageFrame) == 16, "PageFrame 应保持紧凑");
+
+/**
+ * @brief 物理页描述符表.
+ *
+ * 覆盖从最低内存区域到 uppm 的所有物理页, 大小由探测到的内存决定.
+ * 表本身在 pre_init 阶段从探测到的空闲内存中划出,
+ * 并以 RESERVED 区域登记到 meminfo 中, 因此页框分配器不会再将其分配出去.
+ */
+class FrameTable {
+private:
+    // 表的物理地址, 按阶段转换后访问
+    static PhyAddr frames_pa;
+    static size_t base_pfn;
+    static size_t frame_cnt;
+
+public:
+    /**
+     * @brief 根据探测到的内存构造描述符表, 需在页框分配器初始化前调用
+     */
+    static void pre_init();
+
+    static constexpr size_t topfn(PhyAddr addr) {
+        return addr.arith() / PAGESIZE;
+    }
+    static constexpr PhyAddr frompfn(size_t pfn) {
+        return PhyAddr(pfn * PAGESIZE);
+    }
+
+    static bool initialized() {
+        return frame_cnt != 0;
+    }
+
+    static bool contains(size_t pfn) {
+        return pfn >= base_pfn && pfn - base_pfn < frame_cnt;
+    }
+
+    /**
+     * @brief 判断一段物理页是否都在表的覆盖范围内
+     */
+    static bool contains(PhyAddr addr, size_t page_count) {
+        size_t pfn = topfn(addr);
+        return contains(pfn) && page_count <= base_pfn + frame_cnt - pfn;
+    }
+
+    /**
+     * @brief 获得 pfn 对应的描述符
+     *
+     * @return 不在覆盖范围内时返回 nullptr
+     */
+    template <KernelStage Stage = KernelStage::POST_INIT>
+    static PageFrame *frame(size_t pfn) {
+        using StageAddr = _StageAddr<Stage>;
+        if (!contains(pfn)) {
+            return nullptr;
+        }
+        return convert<StageAddr>(frames_pa).template as<PageFrame>() +
+               (pfn - base_pfn);
+    }
+
+    template <KernelStage Stage = KernelStage::POST_INIT>
+    static PageFrame *frame(PhyAddr addr) {
+        return frame<Stage>(topfn(addr));
+    }
+
+    static size_t size() {
+        return frame_cnt;
+    }
+};
@@ -0,0 +1,59 @@
+/**
+ * @file frame_buddy.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 基于页状态表的Buddy页框分配器
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <env.h>
+#include <logger.h>
+#include <mem/frame_buddy.h>
+#include <sustcore/addr.h>
+
+size_t FrameBuddyAllocator::free_head[FrameBuddyAllocator::MAX_BUDDY_ORDER +
+                                      1];
+size_t FrameBuddyAllocator::free_count[FrameBuddyAllocator::MAX_BUDDY_ORDER +
+                                       1];
+
+void FrameBuddyAllocator::pre_init() {
+    // 初始化空闲块链表
+    for (int i = 0; i <= MAX_BUDDY_ORDER; i++) {
+        free_head[i]  = NIL;
+        free_count[i] = 0;
+    }
+
+    // 空闲块状态记录在 FrameTable 中, 其需先于本分配器初始化
+    if (!FrameTable::initialized()) {
+        loggers::BUDDY::FATAL("物理页描述符表尚未初始化");
+        while (true);
+    }
+
+    auto &meminfo = env::inst().meminfo();
+    for (size_t i = 0; i < meminfo.region_cnt; ++i) {
+        const MemRegion &region = meminfo.regions[i];
+        if (region.status == MemRegion::MemoryStatus::FREE) {
+            PhyAddr start_addr = region.ptr.page_align_up();
+            PhyAddr end_addr   = (region.ptr + region.size).page_align_down();
+            if (end_addr <= start_addr) {
+                continue;
+            }
+            size_t pages = (end_addr - start_addr) / PAGESIZE;
+            loggers::BUDDY::DEBUG("添加可用内存区域 [%p, %p), 共 %d 页",
+                                  start_addr.addr(), end_addr.addr(), pages);
+            add_memory_range<KernelStage::PRE_INIT>(start_addr, pages);
+        }
+    }
+}
+
+void FrameBuddyAllocator::post_init() {
+    // 空闲链表以 PFN 链接, FrameTable 以物理地址记录, 均与阶段无关,
+    // 因此无需迁移
+    for (int i = 0; i <= MAX_BUDDY_ORDER; i++) {
+        loggers::BUDDY::DEBUG("Order %d: %d blocks", i, free_count[i]);
+    }
+    loggers::BUDDY::INFO("FrameBuddyAllocator initialized.");
+}
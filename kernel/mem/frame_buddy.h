@@ -0,0 +1,317 @@
+/**
+ * @file frame_buddy.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 基于页状态表的Buddy页框分配器
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <arch/trait.h>
+#include <logger.h>
+#include <mem/frame.h>
+#include <mem/gfp_def.h>
+#include <sus/types.h>
+#include <sustcore/addr.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 基于页状态表的 Buddy 页框分配器.
+ *
+ * 与 BuddyAllocator 不同, 本分配器借助 FrameTable 中的 BUDDY 标记与 order
+ * 记录某页是否为某一阶空闲块的首页. 释放时通过 pfn ^ (1 << order)
+ * 直接定位伙伴并查表判断能否合并, 每一阶 O(1);
+ * 空闲链表无序, 以 PFN 相互链接并存放于空闲块首页中,
+ * 因此无需在 post_init 阶段迁移链表指针.
+ */
+class FrameBuddyAllocator {
+public:
+    static constexpr int MAX_BUDDY_ORDER = 15;
+
+    static void pre_init();
+
+    static void post_init();
+
+    /**
+     * @brief 分配多个页
+     *
+     * @param frame_count
+     * @return PhyAddr
+     */
+    template <KernelStage Stage = KernelStage::POST_INIT>
+    static Result<PhyAddr> get_free_page(size_t frame_count);
+
+    /**
+     * @brief 按order阶数分配
+     *
+     * @param order
+     * @return PhyAddr
+     */
+    template <KernelStage Stage = KernelStage::POST_INIT>
+    static Result<PhyAddr> get_free_pages_in_order(size_t order);
+
+    /**
+     * @brief 释放多个页
+     *
+     * @param paddr
+     * @param frame_count
+     */
+    template <KernelStage Stage = KernelStage::POST_INIT>
+    static void put_page(PhyAddr paddr, size_t frame_count);
+
+    /**
+     * @brief 按order阶数释放页
+     *
+     * @param paddr
+     * @param order
+     */
+    template <KernelStage Stage = KernelStage::POST_INIT>
+    static void put_page_in_order(PhyAddr paddr, int order);
+
+    /**
+     * @brief 查询某一阶空闲块的数量
+     */
+    static size_t free_blocks(int order) {
+        assert(order >= 0 && order <= MAX_BUDDY_ORDER);
+        return free_count[order];
+    }
+
+private:
+    static constexpr size_t NIL = ~static_cast<size_t>(0);
+
+    /**
+     * @brief 空闲块首页中存放的链表节点, 以 PFN 相互链接
+     */
+    struct FreeBlock {
+        size_t next;
+        size_t prev;
+    };
+
+    static size_t free_head[MAX_BUDDY_ORDER + 1];
+    static size_t free_count[MAX_BUDDY_ORDER + 1];
+
+    static constexpr size_t topfn(PhyAddr paddr) {
+        return FrameTable::topfn(paddr);
+    }
+    static constexpr PhyAddr frompfn(size_t pfn) {
+        return FrameTable::frompfn(pfn);
+    }
+
+    /**
+     * @brief 判断 pfn 是否为 order 阶空闲块的首页
+     */
+    template <KernelStage Stage>
+    static bool free_head_of(size_t pfn, int order) {
+        PageFrame *frame = FrameTable::frame<Stage>(pfn);
+        return frame != nullptr && frame->test(PageFrame::BUDDY) &&
+               frame->order == order;
+    }
+
+    template <KernelStage Stage>
+    static FreeBlock *block(size_t pfn) {
+        using StageAddr = _StageAddr<Stage>;
+        return convert<StageAddr>(frompfn(pfn)).template as<FreeBlock>();
+    }
+
+    template <KernelStage Stage>
+    static void list_push(int order, size_t pfn) {
+        FreeBlock *node = block<Stage>(pfn);
+        node->prev      = NIL;
+        node->next      = free_head[order];
+        if (free_head[order] != NIL) {
+            block<Stage>(free_head[order])->prev = pfn;
+        }
+        free_head[order] = pfn;
+        free_count[order]++;
+        PageFrame *frame = FrameTable::frame<Stage>(pfn);
+        frame->set(PageFrame::BUDDY);
+        frame->order = static_cast<uint8_t>(order);
+    }
+
+    template <KernelStage Stage>
+    static void list_remove(int order, size_t pfn) {
+        FreeBlock *node = block<Stage>(pfn);
+        if (node->prev != NIL) {
+            block<Stage>(node->prev)->next = node->next;
+        } else {
+            free_head[order] = node->next;
+        }
+        if (node->next != NIL) {
+            block<Stage>(node->next)->prev = node->prev;
+        }
+        free_count[order]--;
+        PageFrame *frame = FrameTable::frame<Stage>(pfn);
+        frame->clear(PageFrame::BUDDY);
+        frame->order = 0;
+    }
+
+    /**
+     * @brief 按页数添加一段物理内存范围到Buddy分配器
+     *
+     * @param paddr
+     * @param pages
+     */
+    template <KernelStage Stage>
+    static void add_memory_range(const PhyAddr paddr, const size_t pages);
+
+    /**
+     * @brief 页数转换为order阶数
+     *
+     * @param count
+     * @return int
+     */
+    static constexpr int pages2order(size_t count) {
+        int order = 0;
+        while (order < MAX_BUDDY_ORDER && (1ul << order) < count) {
+            order++;
+        }
+        return order;
+    }
+
+    /**
+     * @brief 按order阶数分配内存块
+     *
+     * @param order
+     * @return PhyAddr
+     */
+    template <KernelStage Stage>
+    static Result<PhyAddr> fetch_frame_order(int order) {
+        // 寻找第一个非空链表
+        int current_order = order;
+        while (current_order <= MAX_BUDDY_ORDER &&
+               free_head[current_order] == NIL)
+        {
+            current_order++;
+        }
+
+        if (current_order > MAX_BUDDY_ORDER) {
+            // 无可用内存块
+            loggers::BUDDY::ERROR("无可用内存块");
+            unexpect_return(ErrCode::OUT_OF_MEMORY);
+        }
+
+        size_t pfn = free_head[current_order];
+        list_remove<Stage>(current_order, pfn);
+
+        // 逐阶分裂, 右半部分作为空闲块放回; 其伙伴 (左半) 正在被分配,
+        // 因此无需尝试合并
+        while (current_order > order) {
+            current_order--;
+            list_push<Stage>(current_order, pfn + (1ul << current_order));
+        }
+        return frompfn(pfn);
+    }
+};
+
+template <KernelStage Stage>
+void FrameBuddyAllocator::add_memory_range(const PhyAddr paddr,
+                                           const size_t pages) {
+    size_t remain = pages;
+    PhyAddr addr  = paddr;
+
+    while (remain > 0) {
+        int order = 0;
+        while (order < MAX_BUDDY_ORDER) {
+            size_t try_pages = 1UL << (order + 1);
+            size_t try_size  = try_pages << 12;
+
+            if (try_pages <= remain && addr.aligned(try_size)) {
+                order++;
+            } else {
+                break;
+            }
+        }
+        put_page_in_order<Stage>(addr, order);
+
+        size_t block_pages  = 1UL << order;
+        addr               += block_pages << 12;
+        remain             -= block_pages;
+    }
+}
+
+template <KernelStage Stage>
+Result<PhyAddr> FrameBuddyAllocator::get_free_page(size_t frame_count) {
+    if (frame_count == 0) {
+        unexpect_return(ErrCode::INVALID_PARAM);
+    }
+    if (frame_count > (1ul << MAX_BUDDY_ORDER)) {
+        loggers::BUDDY::ERROR("请求的页数 %u 超出最大支持的范围", frame_count);
+        unexpect_return(ErrCode::INVALID_PARAM);
+    }
+
+    const int order = pages2order(frame_count);
+    auto fetch_res  = fetch_frame_order<Stage>(order);
+    if (!fetch_res.has_value()) {
+        unexpect_return(fetch_res.error());
+    }
+    const PhyAddr paddr = fetch_res.value();
+
+    // 归还多余部分
+    const size_t allocated_pages = 1ul << order;
+    if (allocated_pages > frame_count) {
+        const PhyAddr remain_addr = paddr + frame_count * PAGESIZE;
+        const size_t remain_pages = allocated_pages - frame_count;
+
+        add_memory_range<Stage>(remain_addr, remain_pages);
+    }
+
+    return paddr;
+}
+
+template <KernelStage Stage>
+Result<PhyAddr> FrameBuddyAllocator::get_free_pages_in_order(size_t order) {
+    if (order > MAX_BUDDY_ORDER) {
+        loggers::BUDDY::ERROR("无可用内存块: order %d 超出范围", order);
+        unexpect_return(ErrCode::INVALID_PARAM);
+    }
+    return fetch_frame_order<Stage>(static_cast<int>(order));
+}
+
+template <KernelStage Stage>
+void FrameBuddyAllocator::put_page(PhyAddr paddr, size_t frame_count) {
+    if (!paddr.nonnull() || frame_count == 0)
+        return;
+
+    assert(paddr.aligned<PAGESIZE>());
+
+    add_memory_range<Stage>(paddr, frame_count);
+}
+
+template <KernelStage Stage>
+void FrameBuddyAllocator::put_page_in_order(const PhyAddr paddr, int order) {
+    if (!paddr.nonnull())
+        return;
+
+    assert(order >= 0);
+    assert(order <= MAX_BUDDY_ORDER);
+    assert(paddr.aligned(1UL << (order + 12)));
+
+    size_t pfn = topfn(paddr);
+    if (!FrameTable::contains(paddr, 1ul << order)) {
+        loggers::BUDDY::ERROR("释放的页 [%p, +%d 阶) 不在管理范围内",
+                              paddr.addr(), order);
+        return;
+    }
+    assert(!FrameTable::frame<Stage>(pfn)->test(PageFrame::BUDDY));
+
+    // 查表判断伙伴是否为同阶空闲块, 是则摘下并合并
+    while (order < MAX_BUDDY_ORDER) {
+        size_t buddy = pfn ^ (1ul << order);
+        if (!free_head_of<Stage>(buddy, order)) {
+            break;
+        }
+        list_remove<Stage>(order, buddy);
+        pfn &= ~(1ul << order);
+        order++;
+    }
+    list_push<Stage>(order, pfn);
+}
+
+static_assert(RawGFP<FrameBuddyAllocator>, "FrameBuddy 不满足 RawGFP");
@@ -42,4 +42,92 @@ void LinearGrowGFP::pre_init() {
 
 void LinearGrowGFP::post_init() {
     // 线性增长GFP不需要在post_init阶段执行任何操作
-}
\ No newline at end of file
+}
+
+void GFP::pcp_refill(PageCache &cache) {
+    auto block_res = RawGFPImpl::get_free_page(PCP_LOW);
+    if (block_res.has_value()) {
+        // 倒序压栈, 使低地址页先被分配
+        PhyAddr base = block_res.value();
+        for (size_t i = PCP_LOW; i > 0; i--) {
+            cache.pages[cache.count++] = base + (i - 1) * PAGESIZE;
+        }
+        cache.refilled += PCP_LOW;
+        return;
+    }
+
+    while (cache.count < PCP_LOW) {
+        auto res = RawGFPImpl::get_free_page(1);
+        if (!res.has_value()) {
+            break;
+        }
+        cache.pages[cache.count++] = res.value();
+        cache.refilled++;
+    }
+}
+
+void GFP::pcp_drain(PageCache &cache, size_t n) {
+    assert(n <= cache.count);
+    for (size_t i = 0; i < n; i++) {
+        RawGFPImpl::put_page(cache.pages[i], 1);
+    }
+    for (size_t i = n; i < cache.count; i++) {
+        cache.pages[i - n] = cache.pages[i];
+    }
+    cache.count   -= n;
+    cache.drained += n;
+}
+
+void GFP::init_zero_frame() {
+    auto res = RawGFPImpl::get_free_page(1);
+    if (!res.has_value()) {
+        loggers::MEMORY::FATAL("无法分配全局零页");
+        while (true);
+    }
+    zero_frame = res.value();
+    clear_pages<KernelStage::POST_INIT>(zero_frame, 1);
+    if (tracked(zero_frame)) {
+        PageFrame *f = frame(zero_frame);
+        f->refcount  = 1;
+        f->flags     = 0;
+        f->ptes      = 0;
+        f->priv      = 0;
+    }
+}
+
+size_t GFP::zero_idle(size_t budget) {
+    ZeroPool &pool = zero_pool.local();
+    size_t done    = 0;
+    while (done < budget && pool.count < ZERO_POOL_HIGH) {
+        // 直接取自 RawGFPImpl, 不占用 pcp 中缓存热的页
+        auto res = RawGFPImpl::get_free_page(1);
+        if (!res.has_value()) {
+            break;
+        }
+        PhyAddr paddr = res.value();
+        clear_pages<KernelStage::POST_INIT>(paddr, 1);
+        pool.pages[pool.count++] = paddr;
+        pool.zeroed++;
+        done++;
+    }
+    return done;
+}
+
+void GFP::zero_pool_drain(ZeroPool &pool) {
+    while (pool.count > 0) {
+        RawGFPImpl::put_page(pool.pages[--pool.count], 1);
+    }
+}
+
+void GFP::drain_zero_pool() {
+    zero_pool_drain(zero_pool.local());
+}
+
+void GFP::drain_all() {
+    const size_t online = cpu::online();
+    for (size_t cpu = 0; cpu < online; cpu++) {
+        PageCache &cache = pcp.of(cpu);
+        pcp_drain(cache, cache.count);
+        zero_pool_drain(zero_pool.of(cpu));
+    }
+}
@@ -11,17 +11,63 @@
 
 #pragma once
 
+#include <cpu.h>
 #include <mem/buddy.h>
+#include <mem/frame.h>
+#include <mem/frame_buddy.h>
 #include <mem/gfp_def.h>
 #include <sustcore/addr.h>
 
+#include <cstdint>
+
 /**
  * @brief 当前 GFP 使用的底层裸页框分配器. 
  *
  * RawGFPImpl 只负责实际页框的分配与释放, 不维护页框共享状态. 
  * GFP 在此基础上叠加引用计数, 用于支持 fork 后的 COW 页面共享. 
+ *
+ * 任何满足 RawGFP 的分配器均可替换于此, 如基于有序链表的 BuddyAllocator.
+ */
+using RawGFPImpl = FrameBuddyAllocator;
+
+/**
+ * @brief per-CPU 单页缓存的统计信息
+ */
+struct PcpStats {
+    // 直接由缓存满足的单页分配次数
+    size_t hits;
+    // 缓存为空, 需要从底层分配器补充的次数
+    size_t misses;
+    // 从底层分配器补充的页数
+    size_t refilled;
+    // 归还给底层分配器的页数
+    size_t drained;
+    // 当前缓存中的页数
+    size_t cached;
+};
+
+/**
+ * @brief 页分配标志
  */
-using RawGFPImpl = BuddyAllocator;
+enum GfpFlags : uint32_t {
+    GFP_NONE = 0,
+    // 要求返回的页内容全为 0
+    GFP_ZERO = 1 << 0,
+};
+
+/**
+ * @brief 预清零页池的统计信息
+ */
+struct ZeroPoolStats {
+    // GFP_ZERO 单页分配直接取自页池的次数
+    size_t hits;
+    // 页池为空, 需要在分配路径上清零的次数
+    size_t misses;
+    // 空闲时清零并放入页池的页数
+    size_t zeroed;
+    // 当前页池中的页数
+    size_t cached;
+};
 
 /**
  * @brief 带引用计数管理的页框分配器接口. 
@@ -29,50 +75,235 @@ using RawGFPImpl = BuddyAllocator;
  * GFP 是内核的统一页框分配器,
  * 其实际通过RawGFPImpl实现页的分配与归还,
  * 并为每个页维护一个引用计数, 以实现 COW 功能.
+ *
+ * post-init 阶段的单页分配与释放优先经过 per-CPU 的 LIFO 缓存 (pcp),
+ * 缓存为空时从 RawGFPImpl 批量补充至 PCP_LOW 页,
+ * 超过 PCP_HIGH 页时批量归还 PCP_BATCH 页.
+ *
+ * 另有 per-CPU 的预清零页池: 由各处理器的空闲上下文调用 zero_idle
+ * 逐步填充, 带 GFP_ZERO 的单页分配优先从中取页, 从而将清零开销
+ * 移出缺页处理路径.
  */
 class GFP {
+public:
+    // 缓存上限, 超过后批量归还
+    constexpr static size_t PCP_HIGH  = 64;
+    // 批量交换的页数
+    constexpr static size_t PCP_BATCH = 16;
+    // 缓存为空时补充到的页数
+    constexpr static size_t PCP_LOW   = PCP_BATCH;
+
+    // 预清零页池上限
+    constexpr static size_t ZERO_POOL_HIGH   = 256;
+    // 空闲上下文每次持锁最多清零的页数
+    constexpr static size_t ZERO_IDLE_BUDGET = 8;
+
 private:
-    // 最大追踪 4GB 内存
-    constexpr static size_t MAX_TRACKED_MEMORY = 4ull * 1024 * 1024 * 1024;
-    constexpr static size_t MAX_TRACKED_PAGES  = MAX_TRACKED_MEMORY / PAGESIZE;
+    struct PageCache {
+        PhyAddr pages[PCP_HIGH + 1];
+        size_t count;
+        size_t hits;
+        size_t misses;
+        size_t refilled;
+        size_t drained;
+    };
+
+    inline static cpu::PerCPU<PageCache> pcp{};
+
+    struct ZeroPool {
+        PhyAddr pages[ZERO_POOL_HIGH];
+        size_t count;
+        size_t hits;
+        size_t misses;
+        size_t zeroed;
+    };
+
+    inline static cpu::PerCPU<ZeroPool> zero_pool{};
+
+    // 全局共享的只读零页, 见 zero_page
+    inline static PhyAddr zero_frame = PhyAddr::null;
+
+    /**
+     * @brief 分配并清零全局零页
+     */
+    static void init_zero_frame();
+
+    /**
+     * @brief 从 RawGFPImpl 补充当前处理器的缓存
+     *
+     * 优先整块分配 PCP_LOW 页再拆分, 失败时退化为逐页分配.
+     */
+    static void pcp_refill(PageCache &cache);
+
+    /**
+     * @brief 将当前处理器缓存栈底 (最冷) 的 n 页归还 RawGFPImpl
+     */
+    static void pcp_drain(PageCache &cache, size_t n);
+
+    /**
+     * @brief 将页池中的页全部归还 RawGFPImpl
+     */
+    static void zero_pool_drain(ZeroPool &pool);
 
     /**
-     * @brief 每个物理页的引用计数. 
+     * @brief 将所有在线处理器的 pcp 与预清零页池全部归还 RawGFPImpl
      *
-     * 数组下标由物理地址除以 PAGESIZE 得到. 值为 0 表示该页当前
-     * 未由 GFP 管理或已归还底层分配器. 
+     * 仅在内存不足的重试路径上调用. 内核入口均持有内核大锁,
+     * 因此可以安全地访问其它处理器的缓存.
+     */
+    static void drain_all();
+
+    /**
+     * @brief 分配一个单页, 优先取自 pcp
+     */
+    static Result<PhyAddr> pcp_alloc() {
+        PageCache &cache = pcp.local();
+        if (cache.count > 0) {
+            cache.hits++;
+        } else {
+            cache.misses++;
+            pcp_refill(cache);
+            if (cache.count == 0) {
+                unexpect_return(ErrCode::OUT_OF_MEMORY);
+            }
+        }
+        return cache.pages[--cache.count];
+    }
+
+    /**
+     * @brief 将引用计数归零的单页放入 pcp
+     */
+    static void pcp_free(PhyAddr addr) {
+        PageCache &cache           = pcp.local();
+        cache.pages[cache.count++] = addr;
+        if (cache.count > PCP_HIGH) {
+            pcp_drain(cache, PCP_BATCH);
+        }
+    }
+
+    /**
+     * @brief 将引用计数归零的一段页交还给下层
+     */
+    template <KernelStage Stage>
+    static void release(PhyAddr addr, size_t page_count) {
+        if constexpr (Stage == KernelStage::POST_INIT) {
+            if (page_count == 1) {
+                pcp_free(addr);
+                return;
+            }
+        }
+        RawGFPImpl::template put_page<Stage>(addr, page_count);
+    }
+
+    /**
+     * @brief 从预清零页池中取出一页
+     */
+    static Result<PhyAddr> zero_pool_pop() {
+        ZeroPool &pool = zero_pool.local();
+        if (pool.count == 0) {
+            unexpect_return(ErrCode::OUT_OF_MEMORY);
+        }
+        return pool.pages[--pool.count];
+    }
+
+    /**
+     * @brief 以机器字为单位将一段物理页清零
+     */
+    template <KernelStage Stage>
+    static void clear_pages(PhyAddr paddr, size_t page_count) {
+        using StageAddr = _StageAddr<Stage>;
+        auto *words     = convert<StageAddr>(paddr).template as<uint64_t>();
+        const size_t n  = page_count * PAGESIZE / sizeof(uint64_t);
+        for (size_t i = 0; i < n; i += 8) {
+            words[i + 0] = 0;
+            words[i + 1] = 0;
+            words[i + 2] = 0;
+            words[i + 3] = 0;
+            words[i + 4] = 0;
+            words[i + 5] = 0;
+            words[i + 6] = 0;
+            words[i + 7] = 0;
+        }
+    }
+
+    /**
+     * @brief 从下层取得连续物理页
      *
-     * TODO: 使用根据当前设备动态决定的refcounts表, 或是使用哈希表
+     * @param zeroed 返回的页是否已清零
      */
-    inline static size_t refcounts[MAX_TRACKED_PAGES] = {};
+    template <KernelStage Stage>
+    static Result<PhyAddr> fetch(size_t page_count, uint32_t flags,
+                                 bool &zeroed) {
+        zeroed = false;
+        if constexpr (Stage != KernelStage::POST_INIT) {
+            return RawGFPImpl::template get_free_page<Stage>(page_count);
+        } else {
+            if (page_count != 1) {
+                auto res =
+                    RawGFPImpl::template get_free_page<Stage>(page_count);
+                if (!res.has_value()) {
+                    // 缓存中的单页可能阻碍了合并, 归还后重试一次
+                    drain_all();
+                    res =
+                        RawGFPImpl::template get_free_page<Stage>(page_count);
+                }
+                return res;
+            }
+
+            if (flags & GFP_ZERO) {
+                auto res = zero_pool_pop();
+                if (res.has_value()) {
+                    zero_pool.local().hits++;
+                    zeroed = true;
+                    return res;
+                }
+                zero_pool.local().misses++;
+            }
+            auto res = pcp_alloc();
+            if (!res.has_value()) {
+                // 内存紧张时动用预清零页池
+                res    = zero_pool_pop();
+                zeroed = res.has_value();
+            }
+            if (!res.has_value()) {
+                // 空闲页可能滞留在其它处理器的缓存中
+                drain_all();
+                res = pcp_alloc();
+            }
+            return res;
+        }
+    }
 
     /**
-     * @brief 将物理地址转换为引用计数表下标. 
+     * @brief 获得一段物理页中第 i 页的描述符.
      *
-     * @param addr 需要查询的物理地址. 
-     * @return 物理页在 refcounts 中的下标. 
+     * 引用计数保存在 FrameTable 的 refcount 中. 值为 0 表示该页当前
+     * 未由 GFP 管理或已归还底层分配器.
      */
-    static size_t topfn(PhyAddr addr) {
-        return addr.page_align_down().arith() / PAGESIZE;
+    template <KernelStage Stage = KernelStage::POST_INIT>
+    static PageFrame *frame(PhyAddr addr, size_t i = 0) {
+        return FrameTable::frame<Stage>(FrameTable::topfn(addr) + i);
     }
 
     /**
-     * @brief 判断一段物理页是否在引用计数表可跟踪范围内. 
+     * @brief 判断一段物理页是否在描述符表可跟踪范围内.
      *
-     * @param addr 起始物理地址. 
-     * @param page_count 页数. 
-     * @return true 表示整段页都可被 refcounts 跟踪. 
+     * @param addr 起始物理地址.
+     * @param page_count 页数.
+     * @return true 表示整段页都可被跟踪.
      */
     static bool tracked(PhyAddr addr, size_t page_count = 1) {
-        size_t pfn = topfn(addr);
-        return pfn < MAX_TRACKED_PAGES && page_count <= MAX_TRACKED_PAGES - pfn;
+        return FrameTable::contains(addr.page_align_down(), page_count);
     }
 
 public:
     /**
-     * @brief 初始化 pre-init 阶段的底层裸页框分配器. 
+     * @brief 初始化物理页描述符表与 pre-init 阶段的底层裸页框分配器.
+     *
+     * 描述符表从探测到的内存中划出, 需先于底层分配器初始化.
      */
     static void pre_init() {
+        FrameTable::pre_init();
         RawGFPImpl::pre_init();
     }
 
@@ -81,6 +312,17 @@ public:
      */
     static void post_init() {
         RawGFPImpl::post_init();
+        init_zero_frame();
+    }
+
+    /**
+     * @brief 全局共享的只读零页.
+     *
+     * 该页在 post_init 中分配, 永不释放, 也不属于任何 Memory.
+     * 只能以只读方式映射, 写入前须替换为实际分配的页.
+     */
+    static PhyAddr zero_page() {
+        return zero_frame;
     }
 
     /**
@@ -88,19 +330,28 @@ public:
      *
      * @tparam Stage 当前内核初始化阶段. 
      * @param page_count 需要分配的 4KiB 页数. 
+     * @param flags 分配标志, 见 GfpFlags.
      * @return 成功时返回起始物理地址;失败时返回底层分配器错误. 
      */
     template <KernelStage Stage = KernelStage::POST_INIT>
-    static Result<PhyAddr> get_free_page(size_t page_count = 1) {
-        auto res = RawGFPImpl::template get_free_page<Stage>(page_count);
+    static Result<PhyAddr> get_free_page(size_t page_count = 1,
+                                         uint32_t flags   = GFP_NONE) {
+        bool zeroed = false;
+        auto res    = fetch<Stage>(page_count, flags, zeroed);
         if (!res.has_value()) {
             unexpect_return(res.error());
         }
         PhyAddr paddr = res.value();
+        if ((flags & GFP_ZERO) && !zeroed) {
+            clear_pages<Stage>(paddr, page_count);
+        }
         if (tracked(paddr, page_count)) {
-            size_t pfn = topfn(paddr);
+            PageFrame *frames = frame<Stage>(paddr);
             for (size_t i = 0; i < page_count; ++i) {
-                refcounts[pfn + i] = 1;
+                frames[i].refcount = 1;
+                frames[i].flags    = 0;
+                frames[i].ptes     = 0;
+                frames[i].priv     = 0;
             }
         }
         return paddr;
@@ -126,27 +377,29 @@ public:
             return;
         }
 
-        size_t pfn       = topfn(addr);
-        size_t run_start = 0;
-        size_t run_len   = 0;
+        PageFrame *frames = frame<Stage>(addr);
+        size_t run_start  = 0;
+        size_t run_len    = 0;
         for (size_t i = 0; i < page_count; ++i) {
-            if (refcounts[pfn + i] > 0) {
-                refcounts[pfn + i]--;
+            PageFrame &f = frames[i];
+            if (f.refcount > 0) {
+                f.refcount--;
+            }
+            if (f.refcount <= 1) {
+                f.clear(PageFrame::COW);
             }
-            if (refcounts[pfn + i] == 0) {
+            if (f.refcount == 0) {
                 if (run_len == 0) {
                     run_start = i;
                 }
                 run_len++;
             } else if (run_len != 0) {
-                RawGFPImpl::template put_page<Stage>(
-                    addr + run_start * PAGESIZE, run_len);
+                release<Stage>(addr + run_start * PAGESIZE, run_len);
                 run_len = 0;
             }
         }
         if (run_len != 0) {
-            RawGFPImpl::template put_page<Stage>(addr + run_start * PAGESIZE,
-                                                 run_len);
+            release<Stage>(addr + run_start * PAGESIZE, run_len);
         }
     }
 
@@ -154,7 +407,7 @@ public:
      * @brief 增加连续物理页的引用计数. 
      *
      * COW 建立共享映射时调用本函数, 表示另一个地址空间也引用了这些
-     * 物理页. 不可跟踪页会被忽略. 
+     * 物理页, 这些页会被标记为 COW. 不可跟踪页会被忽略. 
      *
      * @param addr 起始物理地址. 
      * @param page_count 页数. 
@@ -163,9 +416,10 @@ public:
         if (!tracked(addr, page_count)) {
             return;
         }
-        size_t pfn = topfn(addr);
+        PageFrame *frames = frame(addr);
         for (size_t i = 0; i < page_count; ++i) {
-            refcounts[pfn + i]++;
+            frames[i].refcount++;
+            frames[i].set(PageFrame::COW);
         }
     }
 
@@ -179,6 +433,58 @@ public:
         if (!tracked(addr, 1)) {
             return 1;
         }
-        return refcounts[topfn(addr)];
+        return frame(addr.page_align_down())->refcount;
+    }
+
+    /**
+     * @brief 将当前处理器 pcp 中的页全部归还 RawGFPImpl.
+     */
+    static void drain_pcp() {
+        PageCache &cache = pcp.local();
+        pcp_drain(cache, cache.count);
+    }
+
+    /**
+     * @brief 汇总所有处理器 pcp 的统计信息.
+     */
+    static PcpStats pcp_stats() {
+        PcpStats stats{};
+        for (size_t cpu = 0; cpu < pcp.size(); cpu++) {
+            const PageCache &cache  = pcp.of(cpu);
+            stats.hits             += cache.hits;
+            stats.misses           += cache.misses;
+            stats.refilled         += cache.refilled;
+            stats.drained          += cache.drained;
+            stats.cached           += cache.count;
+        }
+        return stats;
+    }
+
+    /**
+     * @brief 在处理器空闲时预先清零若干页放入当前处理器的页池.
+     *
+     * @param budget 本次最多清零的页数.
+     * @return size_t 实际清零的页数.
+     */
+    static size_t zero_idle(size_t budget = ZERO_IDLE_BUDGET);
+
+    /**
+     * @brief 将当前处理器预清零页池中的页全部归还 RawGFPImpl.
+     */
+    static void drain_zero_pool();
+
+    /**
+     * @brief 汇总所有处理器预清零页池的统计信息.
+     */
+    static ZeroPoolStats zero_pool_stats() {
+        ZeroPoolStats stats{};
+        for (size_t cpu = 0; cpu < zero_pool.size(); cpu++) {
+            const ZeroPool &pool  = zero_pool.of(cpu);
+            stats.hits           += pool.hits;
+            stats.misses         += pool.misses;
+            stats.zeroed         += pool.zeroed;
+            stats.cached         += pool.count;
+        }
+        return stats;
     }
 };
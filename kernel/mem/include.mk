@@ -1 +1 @@
-sources += alloc.cpp gfp.cpp kaddr.cpp buddy.cpp slub.cpp vma.cpp
+sources += alloc.cpp gfp.cpp kaddr.cpp buddy.cpp frame.cpp frame_buddy.cpp page_index.cpp slub.cpp tlb.cpp vma.cpp
@@ -0,0 +1,106 @@
+/**
+ * @file page_index.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 以页号为键的基数树
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <mem/gfp.h>
+#include <mem/page_index.h>
+
+#include <cassert>
+
+PageIndex::Node *PageIndex::alloc_node() {
+    auto page_res = GFP::get_free_page(1, GFP_ZERO);
+    if (!page_res.has_value()) {
+        return nullptr;
+    }
+    nodes++;
+    return convert<KpaAddr>(page_res.value()).as<Node>();
+}
+
+void PageIndex::free_node(Node *node) {
+    GFP::put_page(convert<PhyAddr>(KpaAddr(node)), 1);
+    nodes--;
+}
+
+PageIndex::~PageIndex() {
+    clear([](size_t, PhyAddr) {});
+}
+
+const uintptr_t *PageIndex::leaf_slot(size_t idx) const {
+    if (idx >= capacity()) {
+        return nullptr;
+    }
+    const uintptr_t *slot = &root;
+    for (size_t level = height; level > 0; level--) {
+        if (*slot == 0) {
+            return nullptr;
+        }
+        const auto *node = reinterpret_cast<const Node *>(*slot);
+        slot             = &node->slots[slot_of(idx, level - 1)];
+    }
+    return slot;
+}
+
+PhyAddr PageIndex::get(size_t idx) const {
+    const uintptr_t *slot = leaf_slot(idx);
+    if (slot == nullptr) {
+        return PhyAddr::null;
+    }
+    return PhyAddr(*slot);
+}
+
+Result<PhyAddr> PageIndex::set(size_t idx, PhyAddr paddr) {
+    assert(paddr.nonnull());
+
+    // 增高树直至覆盖 idx, 原根槽成为新根的 0 号槽;
+    // 树为空时无需保留原根, 直接增高即可
+    while (idx >= capacity()) {
+        assert(height < MAX_HEIGHT);
+        if (root != 0) {
+            Node *node = alloc_node();
+            if (node == nullptr) {
+                unexpect_return(ErrCode::OUT_OF_MEMORY);
+            }
+            node->slots[0] = root;
+            root           = reinterpret_cast<uintptr_t>(node);
+        }
+        height++;
+    }
+
+    uintptr_t *slot = &root;
+    for (size_t level = height; level > 0; level--) {
+        if (*slot == 0) {
+            Node *child = alloc_node();
+            if (child == nullptr) {
+                unexpect_return(ErrCode::OUT_OF_MEMORY);
+            }
+            *slot = reinterpret_cast<uintptr_t>(child);
+        }
+        auto *node = reinterpret_cast<Node *>(*slot);
+        slot       = &node->slots[slot_of(idx, level - 1)];
+    }
+
+    PhyAddr old(*slot);
+    if (*slot == 0) {
+        count++;
+    }
+    *slot = paddr.arith();
+    return old;
+}
+
+Result<PhyAddr> PageIndex::replace(size_t idx, PhyAddr paddr) {
+    assert(paddr.nonnull());
+    uintptr_t *slot = leaf_slot(idx);
+    if (slot == nullptr || *slot == 0) {
+        unexpect_return(ErrCode::PAGE_NOT_PRESENT);
+    }
+    PhyAddr old(*slot);
+    *slot = paddr.arith();
+    return old;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file page_index.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 以页号为键的基数树
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <sus/types.h>
+#include <sustcore/addr.h>
+#include <sustcore/errcode.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 以页号为键, 物理页地址为值的基数树.
+ *
+ * 每个节点恰好占一页, 含 FANOUT 个槽; 叶层槽存放物理地址,
+ * 其余层槽存放子节点指针, 空槽为 0. 根本身也是一个槽: 树高为 0 时
+ * 只覆盖页号 0, 根槽直接存放其物理地址, 因此单页的 payload 不分配节点.
+ * 树高随最大页号按需增长, 查找, 插入均为 O(height),
+ * 截断只遍历被截去的部分. 节点直接从 GFP 以 GFP_ZERO 分配.
+ */
+class PageIndex {
+public:
+    static constexpr size_t FANOUT_SHIFT = 9;
+    static constexpr size_t FANOUT       = 1ul << FANOUT_SHIFT;
+    // 页号最多 64 - 12 位
+    static constexpr size_t MAX_HEIGHT = (64 - 12 + FANOUT_SHIFT - 1) /
+                                         FANOUT_SHIFT;
+
+private:
+    struct Node {
+        uintptr_t slots[FANOUT];
+    };
+    static_assert(sizeof(Node) == PAGESIZE, "节点应恰好占一页");
+
+    // 根槽, 覆盖 FANOUT^height 个页号; height 为 0 时即页号 0 的叶槽
+    uintptr_t root = 0;
+    size_t height  = 0;
+    size_t count   = 0;
+    size_t nodes   = 0;
+
+    Node *alloc_node();
+    void free_node(Node *node);
+
+    static constexpr size_t slot_of(size_t idx, size_t level) {
+        return (idx >> (level * FANOUT_SHIFT)) & (FANOUT - 1);
+    }
+
+    // 高度为 height 的子树覆盖的页号数
+    static constexpr size_t span_of(size_t height) {
+        return 1ul << (height * FANOUT_SHIFT);
+    }
+
+    [[nodiscard]]
+    size_t capacity() const {
+        if (height * FANOUT_SHIFT >= 64) {
+            return ~static_cast<size_t>(0);
+        }
+        return span_of(height);
+    }
+
+    /**
+     * @brief 查找 idx 所在的叶槽
+     *
+     * @return 中间节点缺失时返回 nullptr
+     */
+    const uintptr_t *leaf_slot(size_t idx) const;
+
+    uintptr_t *leaf_slot(size_t idx) {
+        return const_cast<uintptr_t *>(
+            static_cast<const PageIndex *>(this)->leaf_slot(idx));
+    }
+
+    template <typename F>
+    static void walk(uintptr_t slot, size_t height, size_t base, F &f) {
+        if (height == 0) {
+            f(base, PhyAddr(slot));
+            return;
+        }
+        const auto *node  = reinterpret_cast<const Node *>(slot);
+        const size_t span = span_of(height - 1);
+        for (size_t i = 0; i < FANOUT; i++) {
+            if (node->slots[i] != 0) {
+                walk(node->slots[i], height - 1, base + i * span, f);
+            }
+        }
+    }
+
+    /**
+     * @brief 移除 slot 子树中页号不小于 from 的项
+     *
+     * 子树变空时释放其节点并将 slot 置 0.
+     */
+    template <typename F>
+    void prune(uintptr_t &slot, size_t height, size_t base, size_t from,
+               F &f) {
+        if (height == 0) {
+            f(base, PhyAddr(slot));
+            slot = 0;
+            count--;
+            return;
+        }
+        auto *node        = reinterpret_cast<Node *>(slot);
+        const size_t span = span_of(height - 1);
+        bool empty        = true;
+        for (size_t i = 0; i < FANOUT; i++) {
+            uintptr_t &child = node->slots[i];
+            const size_t idx = base + i * span;
+            if (child != 0 && idx + span > from) {
+                prune(child, height - 1, idx, from, f);
+            }
+            empty = empty && child == 0;
+        }
+        if (empty) {
+            free_node(node);
+            slot = 0;
+        }
+    }
+
+public:
+    PageIndex() = default;
+    ~PageIndex();
+
+    PageIndex(const PageIndex &)            = delete;
+    PageIndex &operator=(const PageIndex &) = delete;
+
+    /**
+     * @brief 查询页号对应的物理页
+     *
+     * @return 不存在时返回 PhyAddr::null
+     */
+    [[nodiscard]]
+    PhyAddr get(size_t idx) const;
+
+    /**
+     * @brief 设置页号对应的物理页, 必要时增高树并分配中间节点
+     *
+     * @param paddr 非空物理地址
+     * @return 原先的物理页, 不存在时为 PhyAddr::null
+     */
+    Result<PhyAddr> set(size_t idx, PhyAddr paddr);
+
+    /**
+     * @brief 替换已存在项的物理页
+     *
+     * @return 原先的物理页; 不存在时返回 PAGE_NOT_PRESENT
+     */
+    Result<PhyAddr> replace(size_t idx, PhyAddr paddr);
+
+    /**
+     * @brief 按页号升序遍历所有项
+     *
+     * @param f 形如 void(size_t idx, PhyAddr paddr) 的回调
+     */
+    template <typename F>
+    void for_each(F f) const {
+        if (root != 0) {
+            walk(root, height, 0, f);
+        }
+    }
+
+    /**
+     * @brief 移除所有页号不小于 from 的项, 并释放变空的节点
+     *
+     * @param f 对每个被移除项调用的回调, 形如 void(size_t, PhyAddr)
+     */
+    template <typename F>
+    void truncate(size_t from, F f) {
+        if (root == 0 || from >= capacity()) {
+            return;
+        }
+        prune(root, height, 0, from, f);
+        if (root == 0) {
+            height = 0;
+        }
+    }
+
+    /**
+     * @brief 移除所有项
+     */
+    template <typename F>
+    void clear(F f) {
+        truncate(0, f);
+    }
+
+    [[nodiscard]]
+    size_t size() const {
+        return count;
+    }
+
+    [[nodiscard]]
+    bool empty() const {
+        return count == 0;
+    }
+
+    /**
+     * @brief 当前分配的节点数, 不含内联于根槽的单项
+     */
+    [[nodiscard]]
+    size_t node_count() const {
+        return nodes;
+    }
+};
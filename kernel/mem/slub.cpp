@@ -13,8 +13,27 @@
 #include <mem/slub.h>
 
 namespace slub {
-    SlubAllocator<MixedSizeAllocator::AllocRecord>
-        MixedSizeAllocator::AllocRecord::SLUB;
-    util::IntrusiveList<MixedSizeAllocator::AllocRecord>
-        MixedSizeAllocator::alloc_records;
+    SlubAllocator<SlabHeader> SlabHeaderCache::SLUB;
+
+    void SlabHeaderCache::init() {
+        new (&SLUB) SlubAllocator<SlabHeader>();
+    }
+
+    SlabHeader *SlabHeaderCache::alloc() {
+        SlabHeader *slab = SLUB.alloc();
+        if (slab == nullptr) {
+            return nullptr;
+        }
+        return new (slab) SlabHeader{};
+    }
+
+    void SlabHeaderCache::free(SlabHeader *slab) {
+        slab->~SlabHeader();
+        SLUB.free(slab);
+    }
+
+    void MixedSizeAllocator::init() {
+        SlabHeaderCache::init();
+        Helper::init();
+    }
 }  // namespace slub
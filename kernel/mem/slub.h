@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <cpu.h>
 #include <logger.h>
 #include <mem/alloc_def.h>
+#include <mem/frame.h>
 #include <mem/gfp.h>
 #include <sus/list.h>
 #include <sustcore/addr.h>
@@ -32,16 +34,51 @@ namespace slub {
     template <typename ObjType>
     class SlubCollection;
 
-    constexpr size_t PAGES_PER_SLAB = 1;
-    constexpr size_t SLAB_BYTES     = PAGESIZE * PAGES_PER_SLAB;
     constexpr size_t ALIGN          = 16;
     constexpr int SLAB_KMAX         = 2048;
+    // slab 最多占用 2^MAX_SLAB_ORDER 个页
+    constexpr size_t MAX_SLAB_ORDER = 3;
+    // 对象不小于该大小时, SlabHeader 放在 slab 之外
+    constexpr size_t OFF_SLAB_MIN   = PAGESIZE / 8;
 
     struct SlubStats {
         size_t total_slabs;
         size_t objects_inuse;
         size_t objects_total;
         size_t memory_usage_bytes;
+        // 单个对象实际占用的字节数
+        size_t object_size;
+        // 每个 slab 占用的页数
+        size_t pages_per_slab;
+        // SlabHeader 是否位于 slab 之外
+        bool off_slab;
+        // 暂存在各处理器 magazine 中的空闲对象数
+        size_t objects_cached;
+        // magazine 命中/未命中次数 (分配与释放合计)
+        size_t magazine_hits;
+        size_t magazine_misses;
+
+        /**
+         * @brief 当前利用率, 即在用对象字节数占总占用内存的千分比
+         */
+        [[nodiscard]]
+        size_t utilization() const {
+            if (memory_usage_bytes == 0) {
+                return 0;
+            }
+            return objects_inuse * object_size * 1000 / memory_usage_bytes;
+        }
+
+        /**
+         * @brief 满载利用率, 即所有对象都在用时的千分比, 反映 slab 布局的浪费
+         */
+        [[nodiscard]]
+        size_t full_utilization() const {
+            if (memory_usage_bytes == 0) {
+                return 0;
+            }
+            return objects_total * object_size * 1000 / memory_usage_bytes;
+        }
     };
 
     void init_chrono_overhead();
@@ -60,17 +97,189 @@ namespace slub {
         size_t inuse{};
         size_t total{};
         SlabState state{};
+        // 对象区域起始地址
+        void *base{};
+        // 单个对象大小
+        size_t obj_size{};
+        // 所属的 SlubAllocator 实例
+        const void *owner{};
         SlabHeader()
             : list_head({}),
               freelist(nullptr),
               inuse(0),
               total(0),
-              state(SlabState::EMPTY) {}
+              state(SlabState::EMPTY),
+              base(nullptr),
+              obj_size(0),
+              owner(nullptr) {}
     };
 
     static_assert(
         util::IntrusiveListNodeTrait<SlabHeader, &SlabHeader::list_head>,
         "SlabHeader fails to be a valid intrusive list node");
+    static_assert(sizeof(SlabHeader) < OFF_SLAB_MIN,
+                  "SlabHeader 自身必须使用 slab 内头部, 否则会递归分配");
+
+    /**
+     * @brief slab 页在物理页描述符中的登记.
+     *
+     * slab 的每一页带有 SLAB 标记, priv 为其 SlabHeader 指针;
+     * MixedSizeAllocator 大对象的首页带有 LARGE 标记, priv 为分配大小的
+     * log2. off-slab 的 SlubAllocator 借此从对象地址找到 SlabHeader,
+     * MixedSizeAllocator 借此在 O(1) 时间内确定释放对象的尺寸类.
+     */
+    class SlabPageTable {
+    private:
+        static PageFrame *frame_of(const void *ptr) {
+            PhyAddr paddr = convert<PhyAddr>(KpaAddr((void *)ptr));
+            return FrameTable::frame(paddr);
+        }
+
+    public:
+        static bool ready() {
+            return FrameTable::initialized();
+        }
+
+        /**
+         * @brief 将 [base, base + pages * PAGESIZE) 登记为属于 slab
+         *
+         * @return 任一页超出表范围时撤销已登记的页并返回 false
+         */
+        static bool set_slab(void *base, size_t pages, SlabHeader *slab) {
+            auto *cur = static_cast<char *>(base);
+            for (size_t i = 0; i < pages; i++, cur += PAGESIZE) {
+                PageFrame *frame = frame_of(cur);
+                if (frame == nullptr) {
+                    for (size_t j = 0; j < i; j++) {
+                        clear(static_cast<char *>(base) + j * PAGESIZE);
+                    }
+                    return false;
+                }
+                frame->set(PageFrame::SLAB);
+                frame->priv = reinterpret_cast<uintptr_t>(slab);
+            }
+            return true;
+        }
+
+        /**
+         * @brief 查询对象所在的 slab
+         *
+         * @return 不属于任何 slab 时返回 nullptr
+         */
+        static SlabHeader *slab_of(const void *ptr) {
+            PageFrame *frame = frame_of(ptr);
+            if (frame == nullptr || !frame->test(PageFrame::SLAB)) {
+                return nullptr;
+            }
+            return reinterpret_cast<SlabHeader *>(frame->priv);
+        }
+
+        static bool set_large(void *head, uint8_t shift) {
+            PageFrame *frame = frame_of(head);
+            if (frame == nullptr) {
+                return false;
+            }
+            frame->set(PageFrame::LARGE);
+            frame->priv = shift;
+            return true;
+        }
+
+        /**
+         * @brief 查询大对象分配大小的 log2
+         *
+         * @return ptr 所在页不是大对象首页时返回 0
+         */
+        static uint8_t large_shift(const void *ptr) {
+            PageFrame *frame = frame_of(ptr);
+            if (frame == nullptr || !frame->test(PageFrame::LARGE)) {
+                return 0;
+            }
+            return static_cast<uint8_t>(frame->priv);
+        }
+
+        static void clear(const void *head) {
+            PageFrame *frame = frame_of(head);
+            if (frame != nullptr) {
+                frame->clear(PageFrame::SLAB);
+                frame->clear(PageFrame::LARGE);
+                frame->priv = 0;
+            }
+        }
+    };
+
+    /**
+     * @brief 编译期选出的 slab 布局
+     */
+    struct SlabLayout {
+        size_t order;
+        bool off_slab;
+        // 每个 slab 可容纳的对象数
+        size_t capacity;
+        // slab 内对象区域的起始偏移
+        size_t offset;
+    };
+
+    /**
+     * @brief 为给定对象选择 slab 阶数与头部位置
+     *
+     * 大对象将 SlabHeader 放在 slab 之外, 避免头部挤掉一个对象.
+     * 从 0 阶开始尝试, 取浪费比例最小的阶数; 浪费不超过 1/16
+     * 时即停止, 避免无谓地增大 slab.
+     */
+    constexpr SlabLayout calc_slab_layout(size_t obj_size, size_t obj_align) {
+        const bool off_slab = obj_size >= OFF_SLAB_MIN;
+        const size_t offset =
+            off_slab ? 0 : align_up(sizeof(SlabHeader), obj_align);
+        SlabLayout best{0, off_slab, 0, offset};
+        size_t best_waste = 0;
+        size_t best_bytes = 1;
+        for (size_t order = 0; order <= MAX_SLAB_ORDER; order++) {
+            const size_t bytes = PAGESIZE << order;
+            if (bytes < offset + obj_size) {
+                continue;
+            }
+            const size_t capacity = (bytes - offset) / obj_size;
+            const size_t waste    = bytes - capacity * obj_size;
+            if (best.capacity == 0 || waste * best_bytes < best_waste * bytes) {
+                best       = {order, off_slab, capacity, offset};
+                best_waste = waste;
+                best_bytes = bytes;
+            }
+            if (waste * 16 <= bytes) {
+                break;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief 根据对象大小选择 magazine 容量, 对象越大缓存越少
+     */
+    constexpr size_t magazine_capacity(size_t obj_size) {
+        if (obj_size <= 256) {
+            return 32;
+        }
+        if (obj_size <= 1024) {
+            return 16;
+        }
+        return 8;
+    }
+
+    template <typename ObjType>
+    class SlubAllocator;
+
+    /**
+     * @brief off-slab SlabHeader 的来源
+     */
+    class SlabHeaderCache {
+    private:
+        static SlubAllocator<SlabHeader> SLUB;
+
+    public:
+        static void init();
+        static SlabHeader *alloc();
+        static void free(SlabHeader *slab);
+    };
 
     template <typename ObjType>
     struct size_of_type : public std::size_constant<sizeof(ObjType)> {};
@@ -79,7 +288,7 @@ namespace slub {
     struct align_of_type : public std::size_constant<alignof(ObjType)> {};
 
     template <typename ObjType>
-    concept HugeObjectType = (size_of_type<ObjType>::value >= SLAB_KMAX);
+    concept HugeObjectType = (size_of_type<ObjType>::value > SLAB_KMAX);
 
     template <typename ObjType>
     class SlubAllocator {
@@ -108,45 +317,83 @@ namespace slub {
         static constexpr size_t obj_size_ =
             round_up_pow2(max(raw_obj_size_, ptr_size_), obj_align_);
 
-        constexpr static size_t pages_      = PAGES_PER_SLAB;
-        constexpr static size_t slab_bytes_ = SLAB_BYTES;
-
         static_assert(is_pow2(obj_align_), "obj_align_ must be power-of-two");
 
+        constexpr static SlabLayout layout_ =
+            calc_slab_layout(obj_size_, obj_align_);
+        constexpr static size_t pages_      = static_cast<size_t>(1)
+                                         << layout_.order;
+        constexpr static size_t slab_bytes_ = pages_ * PAGESIZE;
+        static_assert(layout_.capacity > 0, "每个 slab 至少应包含一个对象");
+
+        constexpr static size_t mag_capacity_ = magazine_capacity(obj_size_);
+        // 每次与 slab 之间批量交换的对象数
+        constexpr static size_t mag_batch_    = mag_capacity_ / 2;
+
+        /**
+         * @brief per-CPU 对象缓存
+         *
+         * 以栈的方式缓存最近释放的对象, 热点的 free/alloc 对
+         * 直接在此完成而不触碰 slab 链表. 空时从 slab 批量补充,
+         * 满时将最早放入的一批对象归还 slab.
+         */
+        struct Magazine {
+            void *objs[mag_capacity_];
+            size_t count;
+            size_t hits;
+            size_t misses;
+        };
+
     public:
         SlubAllocator();
         ObjType *alloc();
         void free(ObjType *ptr);
 
+        /**
+         * @brief 将当前处理器 magazine 中的对象全部归还 slab
+         */
+        void drain() {
+            Magazine &mag = magazines_.local();
+            flush(mag, mag.count);
+        }
+
         SlubStats get_stats() const {
-            size_t total_slabs   = partial.size() + full.size() + empty.size();
-            size_t objects_total = 0;
-            if (total_slabs > 0) {
-                // All slabs have same capacity
-                // We can get it from any slab, or calculate it.
-                // Since we don't have a slab instance, we calculate it.
-                auto base = (uintptr_t)0;
-                auto cur  = align_up(base + sizeof(SlabHeader), obj_align_);
-                auto end  = base + slab_bytes_;
-                size_t per_slab = 0;
-                while (cur + obj_size_ <= end) {
-                    per_slab++;
-                    cur += obj_size_;
-                }
-                objects_total = total_slabs * per_slab;
+            size_t total_slabs = partial.size() + full.size() + empty.size();
+            size_t header_bytes =
+                layout_.off_slab ? total_slabs * sizeof(SlabHeader) : 0;
+            size_t cached = 0, hits = 0, misses = 0;
+            for (size_t cpu = 0; cpu < magazines_.size(); cpu++) {
+                const Magazine &mag  = magazines_.of(cpu);
+                cached              += mag.count;
+                hits                += mag.hits;
+                misses              += mag.misses;
             }
-            return {total_slabs, inuse_objects_, objects_total,
-                    total_slabs * slab_bytes_};
+            return {total_slabs,
+                    inuse_objects_ - cached,
+                    total_slabs * layout_.capacity,
+                    total_slabs * slab_bytes_ + header_bytes,
+                    obj_size_,
+                    pages_,
+                    layout_.off_slab,
+                    cached,
+                    hits,
+                    misses};
         }
 
     private:
         util::IntrusiveList<SlabHeader> partial{};
         util::IntrusiveList<SlabHeader> full{};
         util::IntrusiveList<SlabHeader> empty{};
+        // 从 slab 中取出的对象数, 包含暂存在 magazine 中的对象
         size_t inuse_objects_ = 0;
+        cpu::PerCPU<Magazine> magazines_{};
+
+        void *slab_alloc();
+        void refill(Magazine &mag);
+        void flush(Magazine &mag, size_t n);
 
         SlabHeader *new_slab();
-        void init_slab_headers(SlabHeader *slab);
+        void init_slab_headers(SlabHeader *slab, void *base);
         SlabHeader *slab_of(void *p);
 
         void to_empty(SlabHeader *slab);
@@ -191,7 +438,8 @@ namespace slub {
             return {
                 inuse_objects_,  // Each huge object is effectively its own slab
                 inuse_objects_, inuse_objects_,
-                inuse_objects_ * obj_pages * PAGESIZE};
+                inuse_objects_ * obj_pages * PAGESIZE,
+                sizeof(ObjType), obj_pages, false, 0, 0, 0};
         }
 
     private:
@@ -200,24 +448,27 @@ namespace slub {
 
     template <typename ObjType>
     SlabHeader *SlubAllocator<ObjType>::slab_of(void *p) {
-        auto ptr  = reinterpret_cast<uintptr_t>(p);
-        auto base = align_down(ptr, slab_bytes_);
-        return reinterpret_cast<SlabHeader *>(base);
+        if constexpr (layout_.off_slab) {
+            return SlabPageTable::slab_of(p);
+        } else {
+            // slab 由 GFP 按 2 的幂次页数分配, 天然按 slab_bytes_ 对齐
+            auto ptr  = reinterpret_cast<uintptr_t>(p);
+            auto base = align_down(ptr, slab_bytes_);
+            return reinterpret_cast<SlabHeader *>(base);
+        }
     }
 
     template <typename ObjType>
-    void SlubAllocator<ObjType>::init_slab_headers(SlabHeader *slab) {
-        auto base       = reinterpret_cast<uintptr_t>(slab);
-        auto slab_start = base + sizeof(SlabHeader);
-        slab_start      = align_up(slab_start, obj_align_);
-
-        constexpr size_t total =
-            (slab_bytes_ - align_up(sizeof(SlabHeader), obj_align_)) /
-            obj_size_;
-        static_assert(total > 0, "每个 slab 至少应包含一个对象");
+    void SlubAllocator<ObjType>::init_slab_headers(SlabHeader *slab,
+                                                   void *base) {
+        auto slab_start = reinterpret_cast<uintptr_t>(base) + layout_.offset;
+        constexpr size_t total = layout_.capacity;
 
-        slab->total = total;
-        slab->inuse = 0;
+        slab->total    = total;
+        slab->inuse    = 0;
+        slab->base     = reinterpret_cast<void *>(slab_start);
+        slab->obj_size = obj_size_;
+        slab->owner    = this;
 
         void *head = nullptr;
 
@@ -233,15 +484,43 @@ namespace slub {
 
     template <typename ObjType>
     SlabHeader *SlubAllocator<ObjType>::new_slab() {
+        if constexpr (layout_.off_slab) {
+            if (!SlabPageTable::ready()) {
+                loggers::SLUB::ERROR("页描述符表尚未初始化, 无法创建 off-slab");
+                return nullptr;
+            }
+        }
         Result<PhyAddr> gfp_res = GFP::get_free_page(pages_);
         if (!gfp_res.has_value()) {
             loggers::SLUB::ERROR("无法分配新的 slab 内存");
             return nullptr;
         }
-        PhyAddr paddr    = gfp_res.value();
-        KpaAddr kpaddr   = convert<KpaAddr>(paddr);
-        SlabHeader *slab = new (kpaddr.addr()) SlabHeader{};
-        init_slab_headers(slab);
+        PhyAddr paddr  = gfp_res.value();
+        KpaAddr kpaddr = convert<KpaAddr>(paddr);
+
+        SlabHeader *slab = nullptr;
+        if constexpr (layout_.off_slab) {
+            slab = SlabHeaderCache::alloc();
+            if (slab == nullptr) {
+                loggers::SLUB::ERROR("无法分配 off-slab 头部");
+                GFP::put_page(paddr, pages_);
+                return nullptr;
+            }
+        } else {
+            slab = new (kpaddr.addr()) SlabHeader{};
+        }
+        init_slab_headers(slab, kpaddr.addr());
+
+        // 登记到页描述符表; off-slab 依赖该表定位头部,
+        // MixedSizeAllocator::free 依赖该表定位尺寸类, 失败即不可用
+        if (!SlabPageTable::set_slab(kpaddr.addr(), pages_, slab)) {
+            loggers::SLUB::ERROR("slab %p 超出页描述符表范围", kpaddr.addr());
+            if constexpr (layout_.off_slab) {
+                SlabHeaderCache::free(slab);
+            }
+            GFP::put_page(paddr, pages_);
+            return nullptr;
+        }
         return slab;
     }
 
@@ -281,7 +560,7 @@ namespace slub {
     }
 
     template <typename ObjType>
-    ObjType *SlubAllocator<ObjType>::alloc() {
+    void *SlubAllocator<ObjType>::slab_alloc() {
         SlabHeader *slab = nullptr;
         if (!partial.empty()) {
             slab = &partial.back();
@@ -310,15 +589,50 @@ namespace slub {
         if (slab->inuse == slab->total) {
             to_full(slab);
         }
-        return (ObjType *)obj;
+        return obj;
     }
 
     template <typename ObjType>
-    void SlubAllocator<ObjType>::inner_free(void *ptr) {
-        if (!ptr) {
-            loggers::SLUB::WARN("can't free null pointer");
-            return;
+    void SlubAllocator<ObjType>::refill(Magazine &mag) {
+        while (mag.count < mag_batch_) {
+            void *obj = slab_alloc();
+            if (obj == nullptr) {
+                break;
+            }
+            mag.objs[mag.count++] = obj;
+        }
+    }
+
+    template <typename ObjType>
+    void SlubAllocator<ObjType>::flush(Magazine &mag, size_t n) {
+        assert(n <= mag.count);
+        // 归还栈底 (最早放入, 最冷) 的 n 个对象, 保留热对象
+        for (size_t i = 0; i < n; i++) {
+            inner_free(mag.objs[i]);
         }
+        for (size_t i = n; i < mag.count; i++) {
+            mag.objs[i - n] = mag.objs[i];
+        }
+        mag.count -= n;
+    }
+
+    template <typename ObjType>
+    ObjType *SlubAllocator<ObjType>::alloc() {
+        Magazine &mag = magazines_.local();
+        if (mag.count > 0) {
+            mag.hits++;
+            return static_cast<ObjType *>(mag.objs[--mag.count]);
+        }
+        mag.misses++;
+        refill(mag);
+        if (mag.count == 0) {
+            return nullptr;
+        }
+        return static_cast<ObjType *>(mag.objs[--mag.count]);
+    }
+
+    template <typename ObjType>
+    void SlubAllocator<ObjType>::inner_free(void *ptr) {
         SlabHeader *slab_header         = slab_of(ptr);
         *reinterpret_cast<void **>(ptr) = slab_header->freelist;
         slab_header->freelist           = ptr;
@@ -337,8 +651,20 @@ namespace slub {
             loggers::SLUB::WARN("can't free null pointer");
             return;
         }
+        SlabHeader *slab_header = slab_of(ptr);
+        if (slab_header == nullptr || slab_header->owner != this) {
+            loggers::SLUB::ERROR("对象%p不属于该 SLUB", ptr);
+            return;
+        }
 
-        inner_free(ptr);
+        Magazine &mag = magazines_.local();
+        if (mag.count == mag_capacity_) {
+            mag.misses++;
+            flush(mag, mag_batch_);
+        } else {
+            mag.hits++;
+        }
+        mag.objs[mag.count++] = ptr;
     }
 
     template <typename ObjType>
@@ -413,53 +739,12 @@ namespace slub {
             return n;
         }
 
-        struct AllocRecord {
-            void *ptr;
-            size_t size;
-            // TODO: 改成用哈希表/红黑树?
-            util::ListHead<AllocRecord> list_head{};
-            static SlubAllocator<AllocRecord> SLUB;
-
-            constexpr AllocRecord(void *ptr, size_t size)
-                : ptr(ptr), size(size) {}
-            constexpr AllocRecord() : AllocRecord(nullptr, 0) {}
-
-            inline void *operator new(size_t sz) {
-                assert(sz == sizeof(AllocRecord));
-                return SLUB.alloc();
-            }
-            inline void operator delete(void *ptr) {
-                SLUB.free(static_cast<AllocRecord *>(ptr));
-            }
-        };
-        static util::IntrusiveList<AllocRecord> alloc_records;
-
-        static bool add_record(void *ptr, size_t rsz) {
-            auto *record = new AllocRecord(ptr, rsz);
-            auto inserted = alloc_records.insert(alloc_records.end(), *record);
-            if (inserted == alloc_records.end()) {
-                loggers::MEMORY::ERROR(
-                    "无法记录分配: ptr=%p size=%u record=%p prev=%p next=%p",
-                    ptr, static_cast<unsigned int>(rsz), record,
-                    record->list_head.prev, record->list_head.next);
-                delete record;
-                return false;
+        static constexpr uint8_t log2(size_t rsz) {
+            uint8_t shift = 0;
+            while ((static_cast<size_t>(1) << shift) < rsz) {
+                shift++;
             }
-            return true;
-        }
-
-        static AllocRecord *get_record(void *ptr) {
-            for (auto &rec : alloc_records) {
-                if (rec.ptr == ptr) {
-                    return &rec;
-                }
-            }
-            return nullptr;
-        }
-
-        static void remove_record(AllocRecord *record) {
-            alloc_records.remove(*record);
-            delete record;
+            return shift;
         }
 
         static constexpr size_t get_pages(size_t rsz) {
@@ -500,7 +785,7 @@ namespace slub {
         }
 
         static void _free(void *ptr, size_t rsz) {
-            if (rsz >= KMAX) {
+            if (rsz > KMAX) {
                 const size_t pages = get_pages(rsz);
                 KpaAddr kpaddr     = (KpaAddr)ptr;
                 GFP::put_page(convert<PhyAddr>(kpaddr), pages);
@@ -524,25 +809,21 @@ namespace slub {
         }
 
     public:
-        static void init() {
-            // 构造AllocRecord的SLUB
-            new (&alloc_records) util::IntrusiveList<AllocRecord>();
-            new (&AllocRecord::SLUB)
-                SlubAllocator<MixedSizeAllocator::AllocRecord>;
-            Helper::init();
-        }
+        static void init();
 
         static void *malloc(size_t sz) {
             const size_t rsz = std::max(up2pow(sz), KMIN);
-            assert(Helper::contains(rsz) || rsz >= KMAX);
-            void *ptr = (rsz >= KMAX) ? large_malloc(rsz) : small_malloc(rsz);
+            assert(Helper::contains(rsz) || rsz > KMAX);
+            void *ptr = (rsz > KMAX) ? large_malloc(rsz) : small_malloc(rsz);
             if (ptr == nullptr) {
                 loggers::MEMORY::ERROR("无法分配内存!");
                 return nullptr;
             }
             loggers::MEMORY::DEBUG("分配了 %p, size = %d(实际大小为%d)", ptr,
                                    sz, rsz);
-            if (!add_record(ptr, rsz)) {
+            // 小对象所在 slab 已在创建时登记, 大对象需登记其首页
+            if (rsz > KMAX && !SlabPageTable::set_large(ptr, log2(rsz))) {
+                loggers::MEMORY::ERROR("地址%p超出页描述符表范围", ptr);
                 _free(ptr, rsz);
                 assert(false);
                 return nullptr;
@@ -551,13 +832,23 @@ namespace slub {
         }
 
         static void free(void *ptr) {
-            AllocRecord *record = get_record(ptr);
-            if (record == nullptr) {
+            const uint8_t shift = SlabPageTable::large_shift(ptr);
+            if (shift != 0) {
+                // 大对象独占其首页, 释放后清除描述符以捕获重复释放
+                if (!KpaAddr(ptr).aligned<PAGESIZE>()) {
+                    loggers::MEMORY::ERROR("地址%p不是大对象的起始地址", ptr);
+                    return;
+                }
+                SlabPageTable::clear(ptr);
+                _free(ptr, static_cast<size_t>(1) << shift);
+                return;
+            }
+            SlabHeader *slab = SlabPageTable::slab_of(ptr);
+            if (slab == nullptr) {
                 loggers::MEMORY::ERROR("未查询到地址%p分配记录", ptr);
                 return;
             }
-            _free(ptr, record->size);
-            remove_record(record);
+            _free(ptr, slab->obj_size);
         }
     };
 
@@ -0,0 +1,68 @@
+/**
+ * @file tlb.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 批量 TLB 失效
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <mem/gfp.h>
+#include <mem/tlb.h>
+#include <mem/vma.h>
+
+TlbStats TlbGather::_stats = {};
+
+void TlbGather::add_range(const VirArea &varea) {
+    if (varea.nullable() || full) {
+        return;
+    }
+    VirArea area(varea.begin.page_align_down(), varea.end.page_align_up());
+    page_cnt += area.size() / PAGESIZE;
+    if (page_cnt > FULL_FLUSH_PAGES) {
+        full = true;
+        return;
+    }
+
+    // 与上一区间首尾相接时直接合并, 顺序解除映射时最为常见
+    if (range_cnt > 0 && ranges[range_cnt - 1].end == area.begin) {
+        ranges[range_cnt - 1].end = area.end;
+        return;
+    }
+    if (range_cnt == MAX_RANGES) {
+        full = true;
+        return;
+    }
+    ranges[range_cnt++] = area;
+}
+
+void TlbGather::add_table(PhyAddr table) {
+    // 借用页表页的首个字作为链接. 链接是页对齐的物理地址, 最低位为 0,
+    // 刷新前经由过时的中间项遍历到本页的硬件只会看到无效项
+    *convert<KpaAddr>(table).as<PhyAddr>() = tables;
+    tables                                 = table;
+    full                                   = true;
+}
+
+void TlbGather::finish() {
+    if (full) {
+        tmm.flush_tlb();
+        _stats.full_flushes++;
+    } else {
+        for (size_t i = 0; i < range_cnt; i++) {
+            tmm.flush_tlb_range(ranges[i]);
+        }
+        _stats.page_flushes += page_cnt;
+    }
+    range_cnt = 0;
+    page_cnt  = 0;
+    full      = false;
+
+    while (tables.nonnull()) {
+        PhyAddr table = tables;
+        tables        = *convert<KpaAddr>(table).as<PhyAddr>();
+        GFP::put_page(table, 1);
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file tlb.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 批量 TLB 失效
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <sus/types.h>
+#include <sustcore/addr.h>
+
+#include <cstddef>
+#include <cstdint>
+
+class TaskMemoryManager;
+
+struct TlbStats {
+    // 按页失效的次数
+    uint64_t page_flushes;
+    // 退化为整个地址空间失效的次数
+    uint64_t full_flushes;
+};
+
+/**
+ * @brief 收集一次页表操作中失效的虚拟地址, 在操作结束时统一刷新 TLB.
+ *
+ * 相邻的区间会被合并; 结束时若失效页数不超过 FULL_FLUSH_PAGES,
+ * 逐页以本地址空间的 ASID 刷新, 否则刷新该 ASID 下的全部 TLB 项.
+ * 区间数超出 MAX_RANGES 时同样退化为全部刷新.
+ * 操作中摘下的页表页在刷新之后才交还页框分配器.
+ * 析构时自动调用 finish().
+ */
+class TlbGather {
+public:
+    static constexpr size_t MAX_RANGES       = 16;
+    static constexpr size_t FULL_FLUSH_PAGES = 64;
+
+    explicit TlbGather(TaskMemoryManager &tmm) : tmm(tmm) {}
+    ~TlbGather() {
+        finish();
+    }
+
+    TlbGather(const TlbGather &)            = delete;
+    TlbGather &operator=(const TlbGather &) = delete;
+
+    /**
+     * @brief 记录失效的一页
+     */
+    void add_page(VirAddr vaddr) {
+        add_range(VirArea(vaddr, vaddr + PAGESIZE));
+    }
+
+    /**
+     * @brief 记录失效的一段区间, 按页对齐扩展
+     */
+    void add_range(const VirArea &varea);
+
+    /**
+     * @brief 记录一张已从页表树中摘下的页表页, 刷新后归还
+     *
+     * 按地址的刷新只作用于叶项, 因此同时要求刷新整个地址空间,
+     * 以丢弃缓存的中间项
+     */
+    void add_table(PhyAddr table);
+
+    /**
+     * @brief 要求结束时刷新整个地址空间
+     */
+    void flush_all() {
+        full = true;
+    }
+
+    /**
+     * @brief 执行收集到的刷新, 归还暂存的页表页并清空记录
+     */
+    void finish();
+
+    [[nodiscard]]
+    size_t pages() const {
+        return page_cnt;
+    }
+
+    static TlbStats stats() {
+        return _stats;
+    }
+
+private:
+    TaskMemoryManager &tmm;
+    VirArea ranges[MAX_RANGES];
+    size_t range_cnt = 0;
+    size_t page_cnt  = 0;
+    bool full        = false;
+    // 待归还页表页链表的首页, 链接存放在各页的首个字中
+    PhyAddr tables   = PhyAddr::null;
+
+    static TlbStats _stats;
+};
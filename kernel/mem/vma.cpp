@@ -20,6 +20,8 @@
 
 #include <cstring>
 
+extern PhyAddr kernel_root;
+
 namespace {
     bool valid_user_area(const VirArea &varea) {
         return varea.begin <= varea.end && is_user_vaddr(varea.begin) &&
@@ -50,22 +52,163 @@ namespace {
         }
         return vma.mem_offset + (aligned_vaddr - vma.varea.begin);
     }
+
+    bool covers(const VMA &vma, VirAddr vaddr) {
+        return within(vma.varea, vaddr) ||
+               (vma.varea.size() == 0 && vma.varea.begin == vaddr);
+    }
+
+    constexpr size_t HUGE_SIZE  = PageMan::psize(PageMan::PageSize::_2M);
+    constexpr size_t HUGE_PAGES = HUGE_SIZE / PAGESIZE;
+
+    // 读缺页时可映射共享零页的 VMA: 私有, 可写且无需物理连续,
+    // 首次写入经 COW 分配实际的页
+    bool zero_eligible(const VMA &vma) {
+        return !vma.loading && !vma.memory->shared &&
+               !vma.memory->continuity && PageMan::is_writable(vma.rwx);
+    }
+
+    // fork 时可直接共享 Memory 的 VMA: 只读, 不在加载中, 且 Memory 为
+    // 加载器或镜像缓存持有的段内容 (无 capability 可借以写入或调整其大小).
+    // 镜像缓存同样引用该 Memory, 因此不能以引用计数判断
+    bool sharable_readonly(const VMA &vma) {
+        return !vma.loading && vma.memory->image_owned &&
+               !PageMan::is_writable(vma.rwx);
+    }
+
+    // 可由大页支撑的 VMA:
+    // - 物理连续的 Memory, 其页本就成块分配, 以大页映射不额外占用内存;
+    // - 设置了 huge 的 VMA (如 ELF 加载器建立的堆), 窗口内首次缺页即
+    //   分配整个 2M 块, 以内存换取更少的 TLB 缺失.
+    // 栈等其余 VMA 通常只用到窗口中的少数几页, 默认以 4K 页映射
+    bool huge_eligible(const VMA &vma) {
+        return !vma.loading && (vma.memory->continuity || vma.huge);
+    }
+
+    // 大页内各页均只被一个 Memory 持有
+    bool huge_exclusive(PhyAddr base) {
+        for (size_t i = 0; i < HUGE_PAGES; i++) {
+            if (GFP::ref_count(base + i * PAGESIZE) > 1) {
+                return false;
+            }
+        }
+        return true;
+    }
 }  // namespace
 
+template <typename Pred>
+VMA *TaskMemoryManager::find_at(VirAddr vaddr, Pred pred) const {
+    VMA *vma = vma_tree.last_such_that(
+        [vaddr](const VMA &v) { return v.varea.begin <= vaddr; });
+    for (; vma != nullptr; vma = VMATree::prev(vma)) {
+        if (covers(*vma, vaddr) && pred(*vma)) {
+            return vma;
+        }
+        // 非空 VMA 互不相交, 更靠前的 VMA 均在其起点之前结束
+        if (!vma->varea.nullable() && vma->varea.begin < vaddr) {
+            break;
+        }
+    }
+    return nullptr;
+}
+
+VMA *TaskMemoryManager::find_intersecting(const VirArea &varea,
+                                          const VMA *exclude) const {
+    if (varea.nullable()) {
+        return nullptr;
+    }
+    VMA *vma = vma_tree.last_such_that(
+        [&varea](const VMA &v) { return v.varea.begin < varea.end; });
+    for (; vma != nullptr; vma = VMATree::prev(vma)) {
+        if (vma == exclude || vma->varea.nullable()) {
+            continue;
+        }
+        if (is_intersecting(vma->varea, varea)) {
+            return vma;
+        }
+        // 该 VMA 在 varea 之前结束, 更靠前的 VMA 亦然
+        break;
+    }
+    return nullptr;
+}
+
+void TaskMemoryManager::set_area(VMA &vma, const VirArea &varea) {
+    vma_tree.remove(vma);
+    vma.varea = varea;
+    vma_tree.insert(vma);
+}
+
 TaskMemoryManager::TaskMemoryManager(PhyAddr _pgd)
-    : vma_list(), _pgd(_pgd), _pman(_pgd) {
+    : vma_list(), vma_tree(), _pgd(_pgd), _pman(_pgd) {
     PageMan::make_root(_pgd);
     ker_paddr::mapping_kernel_areas(_pman);
 }
 
+void TaskMemoryManager::activate() {
+    uint16_t asid = AsidAllocator::acquire(_asid_ctx);
+    PageMan::__switch_root(_pgd, asid);
+    if (!AsidAllocator::supported()) {
+        PageMan::flush_tlb();
+    }
+}
+
+// 同一地址空间可能同时在多个处理器上运行, 刷新须同时通知其它处理器
+void TaskMemoryManager::flush_tlb() {
+    if (!AsidAllocator::loaded(_asid_ctx)) {
+        return;
+    }
+    uint16_t asid = AsidAllocator::asid_of(_asid_ctx);
+    PageMan::flush_tlb_asid(asid);
+    SMP::flush_tlb_asid_others(asid);
+}
+
+void TaskMemoryManager::flush_tlb_page(VirAddr vaddr) {
+    flush_tlb_range(VirArea(vaddr, vaddr + PAGESIZE));
+}
+
+void TaskMemoryManager::flush_tlb_range(const VirArea &varea) {
+    if (!AsidAllocator::loaded(_asid_ctx)) {
+        return;
+    }
+    uint16_t asid = AsidAllocator::asid_of(_asid_ctx);
+    for (VirAddr vaddr = varea.begin; vaddr < varea.end; vaddr += PAGESIZE) {
+        PageMan::flush_tlb_page(vaddr, asid);
+    }
+    SMP::flush_tlb_range_others(varea.begin, varea.end - varea.begin, asid);
+}
+
+void TaskMemoryManager::switch_to(TaskMemoryManager *tmm, PhyAddr pgd) {
+    if (tmm != nullptr && tmm->pgd() == pgd) {
+        tmm->activate();
+        return;
+    }
+    PageMan(pgd).switch_root();
+    PageMan::flush_tlb();
+}
+
+void TaskMemoryManager::activate_kernel() {
+    if (PageMan::read_root() == kernel_root) {
+        return;
+    }
+    PageMan::__switch_root(kernel_root, 0);
+    if (!AsidAllocator::supported()) {
+        PageMan::flush_tlb();
+    }
+}
+
 TaskMemoryManager::~TaskMemoryManager() {
     auto &&list = std::move(vma_list);
+    TlbGather tlb(*this);
+    tlb.flush_all();
     for (VMA &vma : list) {
-        unmap_pages(vma.varea);
+        unmap_pages(vma.varea, tlb);
         delete util::owner(&vma);
     }
-    _pman.flush_tlb();
-    // TODO: 释放页表
+    // 释放剩余的页表页 (含内核区域映射所用的页表), 根页表由调用者释放
+    loggers::PAGING::DEBUG("TMM %p: 释放 %d 个页表页", _pgd.addr(),
+                           _pman.table_pages());
+    tlb.finish();
+    _pman.release_tables();
 }
 
 Result<util::nonnull<VMA *>> TaskMemoryManager::add_vma(
@@ -83,77 +226,103 @@ Result<util::nonnull<VMA *>> TaskMemoryManager::add_vma(
 
     VMA *vma = new VMA(this, type, growth, varea, memory, rwx, mem_offset);
     vma_list.push_back(*vma);
+    vma_tree.insert(*vma);
     return util::nonnull(*vma);
 }
 
 Result<util::nonnull<VMA *>> TaskMemoryManager::clone_vma(
     util::nonnull<VMA *> vma, TaskMemoryManager &dst) {
-    return __check_vma(vma).and_then([&dst](VMA *vma) {
-        return dst.add_vma(vma->type, vma->growth, vma->varea, vma->memory,
-                           vma->rwx, vma->mem_offset);
-    });
+    return __check_vma(vma).and_then(
+        [&dst](VMA *vma) -> Result<util::nonnull<VMA *>> {
+            auto add_res = dst.add_vma(vma->type, vma->growth, vma->varea,
+                                       vma->memory, vma->rwx, vma->mem_offset);
+            propagate(add_res);
+            add_res.value()->huge = vma->huge;
+            return add_res;
+        });
 }
 
 Result<util::nonnull<VMA *>> TaskMemoryManager::locate(VirAddr vaddr) {
-    for (auto &vma : vma_list) {
-        if (within(vma.varea, vaddr) ||
-            (vma.varea.size() == 0 && vma.varea.begin == vaddr))
-        {
-            return util::nonnull(vma);
-        }
+    if (_last_hit != nullptr && covers(*_last_hit, vaddr)) {
+        return util::nonnull(*_last_hit);
     }
-    unexpect_return(ErrCode::ENTRY_NOT_FOUND);
+    VMA *vma = find_at(vaddr, [](const VMA &) { return true; });
+    if (vma == nullptr) {
+        unexpect_return(ErrCode::ENTRY_NOT_FOUND);
+    }
+    _last_hit = vma;
+    return util::nonnull(*vma);
 }
 
 Result<util::nonnull<VMA *>> TaskMemoryManager::locate_range(
     const VirArea &varea) {
-    for (auto &vma : vma_list) {
-        if (is_intersecting(vma.varea, varea)) {
-            return util::nonnull(vma);
-        }
+    VMA *vma = find_intersecting(varea, nullptr);
+    if (vma == nullptr) {
+        unexpect_return(ErrCode::ENTRY_NOT_FOUND);
     }
-    unexpect_return(ErrCode::ENTRY_NOT_FOUND);
+    return util::nonnull(*vma);
 }
 
 Result<util::nonnull<VMA *>> TaskMemoryManager::locate_memory(
     cap::MemoryPayload *memory, VirAddr vaddr) {
-    for (auto &vma : vma_list) {
-        if (vma.memory == memory &&
-            (within(vma.varea, vaddr) ||
-             (vma.varea.size() == 0 && vma.varea.begin == vaddr)))
-        {
-            return util::nonnull(vma);
-        }
+    VMA *vma = find_at(
+        vaddr, [memory](const VMA &v) { return v.memory == memory; });
+    if (vma == nullptr) {
+        unexpect_return(ErrCode::ENTRY_NOT_FOUND);
     }
-    unexpect_return(ErrCode::ENTRY_NOT_FOUND);
+    return util::nonnull(*vma);
 }
 
 Result<void> TaskMemoryManager::remove_vma(util::nonnull<VMA *> vma) {
     return __check_vma(vma).and_then([this](VMA *vma) {
-        unmap_pages(vma->varea);
+        TlbGather tlb(*this);
+        unmap_pages(vma->varea, tlb);
         vma_list.remove(*vma);
+        vma_tree.remove(*vma);
+        if (_last_hit == vma) {
+            _last_hit = nullptr;
+        }
         delete util::owner(vma);
-        _pman.flush_tlb();
+        tlb.finish();
         void_return();
     });
 }
 
-void TaskMemoryManager::unmap_pages(const VirArea &varea) {
+void TaskMemoryManager::unmap_pages(const VirArea &varea, TlbGather &tlb) {
     VirArea map_area = page_outer_area(varea);
     if (map_area.nullable()) {
         return;
     }
 
-    size_t page_count = map_area.size() / PAGESIZE;
-    for (size_t i = 0; i < page_count; ++i) {
-        VirAddr vaddr  = map_area.begin + i * PAGESIZE;
-        auto query_res = _pman.query_page(vaddr);
-        if (!query_res.has_value()) {
+    // 区间端点落在大页中间时先拆分, 以免解除区间外的映射.
+    // 拆分失败时整个大页被解除, 区间外的页仍在 Memory 中, 再次访问时
+    // 按缺页重新映射
+    const VirAddr edges[] = {map_area.begin, map_area.end};
+    for (VirAddr edge : edges) {
+        if (edge.aligned(HUGE_SIZE)) {
             continue;
         }
-
-        _pman.unmap_page(vaddr);
+        auto split_res = _pman.split_huge(edge);
+        if (!split_res.has_value()) {
+            loggers::PAGING::WARN("unmap_pages: 无法拆分大页: addr=%p",
+                                  edge.addr());
+        } else if (split_res.value()) {
+            tlb.flush_all();
+        }
     }
+
+    // 不分配页表, 遍历不会失败; 变空的页表交给 tlb, 刷新后才归还
+    auto walk_res [[maybe_unused]] = _pman.for_each_pte<false, true>(
+        map_area.begin, map_area.size(),
+        [&tlb](VirAddr vaddr, PageMan::PTE &pte, PageMan::PageSize size) {
+            if (!pte.v) {
+                return true;
+            }
+            PageMan::clear_entry(pte);
+            tlb.add_range(VirArea(vaddr, vaddr + PageMan::psize(size)));
+            return true;
+        },
+        [&tlb](PhyAddr table) { tlb.add_table(table); });
 }
 
 Result<VirArea> TaskMemoryManager::grow_vma(util::nonnull<VMA *> vma,
@@ -195,29 +364,27 @@ Result<VirArea> TaskMemoryManager::grow_vma(util::nonnull<VMA *> vma,
         unexpect_return(ErrCode::INVALID_PARAM);
     }
 
-    if (!varea.nullable()) {
-        for (auto &other : vma_list) {
-            if (&other != target && is_intersecting(other.varea, varea)) {
-                unexpect_return(ErrCode::BUSY);
-            }
-        }
+    if (find_intersecting(varea, target) != nullptr) {
+        unexpect_return(ErrCode::BUSY);
     }
 
+    // 扩展不改动已有映射, 无需刷新
+    TlbGather tlb(*this);
     if (shrink_up) {
         VirArea unmap_area = page_inner_area(VirArea(varea.end, old_area.end));
         if (!unmap_area.nullable()) {
-            unmap_pages(unmap_area);
+            unmap_pages(unmap_area, tlb);
         }
     } else if (shrink_down) {
         VirArea unmap_area =
             page_inner_area(VirArea(old_area.begin, varea.begin));
         if (!unmap_area.nullable()) {
-            unmap_pages(unmap_area);
+            unmap_pages(unmap_area, tlb);
         }
     }
 
-    target->varea = varea;
-    _pman.flush_tlb();
+    set_area(*target, varea);
+    tlb.finish();
     return target->varea;
 }
 
@@ -230,42 +397,53 @@ bool TaskMemoryManager::has_memory_mapping(cap::MemoryPayload *memory) const {
     return false;
 }
 
+Result<void> TaskMemoryManager::write_protect_pages(const VirArea &varea,
+                                                    TlbGather &tlb) {
+    bool huge = false;
+
+    auto walk_res [[maybe_unused]] = _pman.for_each_pte<false>(
+        varea.begin, varea.size(),
+        [&](VirAddr vaddr, PageMan::PTE &pte, PageMan::PageSize size) {
+            if (!pte.v) {
+                return true;
+            }
+            if (size == PageMan::PageSize::_1G) {
+                huge = true;
+                return false;
+            }
+            PageMan::RWX rwx = PageMan::rwx(pte);
+            if (PageMan::is_writable(rwx)) {
+                pte.rwx = rwx_cast(PageMan::without_write(rwx));
+                PageMan::set_cow(&pte, true);
+                tlb.add_range(VirArea(vaddr, vaddr + PageMan::psize(size)));
+            }
+            return true;
+        });
+    if (huge) {
+        unexpect_return(ErrCode::NOT_SUPPORTED);
+    }
+    void_return();
+}
+
 Result<void> TaskMemoryManager::protect_memory_cow(cap::MemoryPayload *memory) {
     if (memory == nullptr || memory->shared) {
         void_return();
     }
+    TlbGather tlb(*this);
     for (auto &vma : vma_list) {
         if (vma.memory != memory) {
             continue;
         }
-        VirArea map_area  = page_outer_area(vma.varea);
-        size_t page_count = map_area.size() / PAGESIZE;
-        for (size_t i = 0; i < page_count; ++i) {
-            VirAddr vaddr  = map_area.begin + i * PAGESIZE;
-            auto query_res = _pman.query_page(vaddr);
-            if (!query_res.has_value()) {
-                if (query_res.error() == ErrCode::PAGE_NOT_PRESENT) {
-                    continue;
-                }
-                propagate_return(query_res);
-            }
-            auto qres = query_res.value();
-            if (qres.size != PageMan::PageSize::_4K) {
-                unexpect_return(ErrCode::NOT_SUPPORTED);
-            }
-            PageMan::RWX rwx = PageMan::rwx(*qres.pte);
-            if (PageMan::is_writable(rwx)) {
-                qres.pte->rwx = rwx_cast(PageMan::without_write(rwx));
-                PageMan::set_cow(qres.pte, true);
-            }
-        }
+        auto protect_res = write_protect_pages(page_outer_area(vma.varea), tlb);
+        propagate(protect_res);
     }
-    _pman.flush_tlb();
+    tlb.finish();
     void_return();
 }
 
 void TaskMemoryManager::unmap_memory_tail(cap::MemoryPayload *memory,
                                           size_t new_size) {
+    TlbGather tlb(*this);
     for (auto &vma : vma_list) {
         if (vma.memory != memory) {
             continue;
@@ -274,10 +452,11 @@ void TaskMemoryManager::unmap_memory_tail(cap::MemoryPayload *memory,
         VirAddr new_end =
             vma.varea.begin + (keep < vma.size() ? keep : vma.size());
         if (new_end < vma.varea.end) {
-            unmap_pages(VirArea(new_end, vma.varea.end));
-            vma.varea.end = new_end;
+            unmap_pages(VirArea(new_end, vma.varea.end), tlb);
+            set_area(vma, VirArea(vma.varea.begin, new_end));
         }
     }
+    tlb.finish();
 }
 
 Result<void> TaskMemoryManager::sync_memory_vmas(cap::MemoryPayload *memory) {
@@ -313,6 +492,118 @@ Result<cap::MemoryPayload *> TaskMemoryManager::cloned_memory_for(
     unexpect_return(ErrCode::ENTRY_NOT_FOUND);
 }
 
+bool TaskMemoryManager::map_huge(VMA &vma, VirAddr vaddr) {
+    if (!huge_eligible(vma)) {
+        return false;
+    }
+    VirAddr base = vaddr.align_down(HUGE_SIZE);
+    if (base < vma.varea.begin || vma.varea.end - base < HUGE_SIZE) {
+        return false;
+    }
+    size_t mem_offset = memory_offset_for_page(vma, base);
+    if (mem_offset % HUGE_SIZE != 0 || !_pman.huge_slot_free(base)) {
+        return false;
+    }
+    // 物理页部分存在, 不连续或被共享时退回 4K 映射
+    auto block_res = vma.memory->ensure_huge(mem_offset);
+    if (!block_res.has_value()) {
+        return false;
+    }
+
+    _pman.map_page<PageMan::PageSize::_2M>(base, block_res.value(), vma.rwx,
+                                           true, false);
+    auto query_res = _pman.query_page(base);
+    if (!query_res.has_value() ||
+        query_res.value().size != PageMan::PageSize::_2M)
+    {
+        // 页表分配失败; 物理块已记入 Memory, 由 4K 路径逐页映射
+        return false;
+    }
+    flush_tlb_page(base);
+    loggers::PAGING::DEBUG("TM::on_np: 以大页映射 [%p, +2M) -> %p",
+                           base.addr(), block_res.value().addr());
+    return true;
+}
+
+Result<void> TaskMemoryManager::set_fault_around(size_t pages) {
+    if (pages > MAX_FAULT_AROUND_PAGES || (pages & (pages - 1)) != 0) {
+        unexpect_return(ErrCode::INVALID_PARAM);
+    }
+    _fault_around = pages;
+    void_return();
+}
+
+size_t TaskMemoryManager::fault_around(VMA &vma, VirAddr vaddr) {
+    // 加载中的 VMA 按内核页映射, 不预先映射其余页
+    if (_fault_around <= 1 || vma.loading) {
+        return 0;
+    }
+    const size_t window = _fault_around * PAGESIZE;
+    VirAddr start       = vaddr.align_down(window);
+    VirAddr end         = start + window;
+    VirArea inner       = page_inner_area(vma.varea);
+    if (start < inner.begin) {
+        start = inner.begin;
+    }
+    if (end > inner.end) {
+        end = inner.end;
+    }
+    if (end <= start) {
+        return 0;
+    }
+
+    size_t mapped = 0;
+
+    // 窗口位于 vaddr 所在的末级页表之内, 不会分配页表
+    auto walk_res [[maybe_unused]] = _pman.for_each_pte<false>(
+        start, end - start,
+        [&](VirAddr va, PageMan::PTE &pte, PageMan::PageSize size) {
+            if (pte.v || size != PageMan::PageSize::_4K) {
+                return true;
+            }
+            // 尚未分配的页可映射后备页, 可写 VMA 中按 COW 映射
+            size_t mem_offset = memory_offset_for_page(vma, va);
+            auto page_res     = vma.memory->lookup_page(mem_offset);
+            bool borrowed     = !page_res.has_value();
+            if (borrowed) {
+                page_res = vma.memory->backing_page(mem_offset);
+            }
+            if (!page_res.has_value()) {
+                return true;
+            }
+            PhyAddr paddr = page_res.value();
+            bool cow_page = PageMan::is_writable(vma.rwx) &&
+                            (borrowed || (!vma.memory->shared &&
+                                          GFP::ref_count(paddr) > 1));
+            PageMan::PTE entry = PageMan::leaf_entry(
+                paddr, cow_page ? PageMan::without_write(vma.rwx) : vma.rwx,
+                true, false);
+            PageMan::set_cow(&entry, cow_page);
+            PageMan::set_entry(pte, entry);
+            mapped++;
+            return true;
+        });
+    if (mapped > 0) {
+        loggers::PAGING::DEBUG("TM::fault_around: [%p, %p) 映射 %d 页",
+                               start.addr(), end.addr(), mapped);
+    }
+    return mapped;
+}
+
+bool TaskMemoryManager::map_borrowed(VMA &vma, VirAddr vaddr, PhyAddr paddr) {
+    _pman.map_page<PageMan::PageSize::_4K>(
+        vaddr, paddr, PageMan::without_write(vma.rwx), true, false);
+    auto query_res = _pman.query_page(vaddr);
+    if (!query_res.has_value()) {
+        loggers::PAGING::ERROR("TM::on_np: 无法映射借用页: addr=%p",
+                               vaddr.addr());
+        return false;
+    }
+    PageMan::set_cow(query_res.value().pte, PageMan::is_writable(vma.rwx));
+    flush_tlb_page(vaddr);
+    return true;
+}
+
 bool TaskMemoryManager::on_np(const NoPresentEvent &e) {
     loggers::PAGING::DEBUG(
         "TM::on_np: access_address=%p, tm_pgd=%p, pman_root=%p",
@@ -327,8 +618,38 @@ bool TaskMemoryManager::on_np(const NoPresentEvent &e) {
     VMA *vma = locate_res.value();
 
     VirAddr aligned_vaddr = e.access_address.page_align_down();
-    size_t mem_offset     = memory_offset_for_page(*vma, aligned_vaddr);
-    auto page_res         = vma->memory->ensure_page(mem_offset);
+    // 该页已由其它路径 (如 fault_around) 映射, 本次异常来自过期的 TLB 项
+    auto present_res = _pman.query_page(aligned_vaddr);
+    if (present_res.has_value()) {
+        flush_tlb_page(aligned_vaddr);
+        return true;
+    }
+
+    // 读取尚未分配的页时映射后备页或零页, 写入时才分配实际的页;
+    // 可使用大页的窗口无论读写都直接分配整块
+    size_t mem_offset = memory_offset_for_page(*vma, aligned_vaddr);
+    if (!e.write && !vma->loading) {
+        auto backing_res = vma->memory->backing_page(mem_offset);
+        if (backing_res.has_value()) {
+            if (!map_borrowed(*vma, aligned_vaddr, backing_res.value())) {
+                return false;
+            }
+            fault_around(*vma, aligned_vaddr);
+            return true;
+        }
+    }
+    // 大页须先于零页尝试: 否则读缺页以 4K 映射零页后, 该 2M 窗口已有
+    // 页表项, 之后的写缺页无法再使用大页, 结果将取决于访问顺序
+    if (map_huge(*vma, e.access_address)) {
+        return true;
+    }
+    if (!e.write && zero_eligible(*vma) && !vma->memory->backed(mem_offset) &&
+        !vma->memory->lookup_page(mem_offset).has_value())
+    {
+        return map_borrowed(*vma, aligned_vaddr, GFP::zero_page());
+    }
+
+    auto page_res = vma->memory->ensure_page(mem_offset);
     if (!page_res.has_value()) {
         loggers::TASK::ERROR("无法处理缺页异常: err=%d", page_res.error());
         return false;
@@ -351,7 +672,8 @@ bool TaskMemoryManager::on_np(const NoPresentEvent &e) {
             PageMan::set_cow(query_res.value().pte, true);
         }
     }
-    _pman.flush_tlb();
+    flush_tlb_page(aligned_vaddr);
+    fault_around(*vma, aligned_vaddr);
 
     // 调试: 使用当前硬件页表根再次查询该页
     PhyAddr hw_root = PageMan::read_root();
@@ -393,8 +715,29 @@ bool TaskMemoryManager::on_wp(VirAddr fault_addr) {
         return false;
     }
     auto qres = query_res.value();
+    if (qres.size == PageMan::PageSize::_2M && PageMan::is_cow(*qres.pte)) {
+        // 大页内各页均未被共享时整体恢复写权限, 否则拆分后按 4K 处理
+        if (huge_exclusive(PageMan::get_physical_address(*qres.pte))) {
+            qres.pte->rwx = rwx_cast(vma->rwx);
+            PageMan::set_cow(qres.pte, false);
+            flush_tlb_page(aligned_vaddr);
+            return true;
+        }
+        auto split_res = _pman.split_huge(aligned_vaddr);
+        if (!split_res.has_value()) {
+            loggers::PAGING::ERROR("TM::on_wp: 无法拆分大页: addr=%p",
+                                   aligned_vaddr.addr());
+            return false;
+        }
+        flush_tlb();
+        query_res = _pman.query_page(aligned_vaddr);
+        if (!query_res.has_value()) {
+            return false;
+        }
+        qres = query_res.value();
+    }
     if (qres.size != PageMan::PageSize::_4K) {
-        loggers::PAGING::ERROR("TM::on_wp: COW 暂不支持大页: addr=%p",
+        loggers::PAGING::ERROR("TM::on_wp: COW 暂不支持 1G 大页: addr=%p",
                                aligned_vaddr.addr());
         return false;
     }
@@ -406,10 +749,23 @@ bool TaskMemoryManager::on_wp(VirAddr fault_addr) {
 
     PhyAddr old_paddr = PageMan::get_physical_address(*qres.pte);
     PageMan::RWX rwx  = vma->rwx;
+    size_t mem_offset = memory_offset_for_page(*vma, aligned_vaddr);
+    if (!vma->memory->lookup_page(mem_offset).has_value()) {
+        // 首次写入零页或后备页: 为 Memory 分配实际的页,
+        // 其若已被共享则继续复制
+        auto page_res = vma->memory->ensure_page(mem_offset);
+        if (!page_res.has_value()) {
+            loggers::PAGING::ERROR("TM::on_wp: 无法替换借用页: err=%d",
+                                   page_res.error());
+            return false;
+        }
+        old_paddr = page_res.value();
+        PageMan::set_paddr(qres.pte, old_paddr);
+    }
     if (GFP::ref_count(old_paddr) <= 1) {
         qres.pte->rwx = rwx_cast(rwx);
         PageMan::set_cow(qres.pte, false);
-        PageMan::flush_tlb();
+        flush_tlb_page(aligned_vaddr);
         return true;
     }
 
@@ -422,8 +778,7 @@ bool TaskMemoryManager::on_wp(VirAddr fault_addr) {
     PhyAddr new_paddr = new_page_res.value();
     memcpy(convert<KpaAddr>(new_paddr).addr(),
            convert<KpaAddr>(old_paddr).addr(), PAGESIZE);
-    size_t mem_offset = memory_offset_for_page(*vma, aligned_vaddr);
-    auto replace_res  = vma->memory->replace_page(mem_offset, new_paddr);
+    auto replace_res = vma->memory->replace_page(mem_offset, new_paddr);
     if (!replace_res.has_value()) {
         GFP::put_page(new_paddr, 1);
         loggers::PAGING::ERROR("TM::on_wp: 更新 Memory 页失败: err=%d",
@@ -434,71 +789,45 @@ bool TaskMemoryManager::on_wp(VirAddr fault_addr) {
     PageMan::set_paddr(qres.pte, new_paddr);
     qres.pte->rwx = rwx_cast(rwx);
     PageMan::set_cow(qres.pte, false);
-    PageMan::flush_tlb();
+    flush_tlb_page(aligned_vaddr);
     return true;
 }
 
 Result<void> TaskMemoryManager::clone_to_cow(TaskMemoryManager &dst) {
+    // 子进程不复制页表项, 首次访问时经 on_np 从 Memory 映射
+    TlbGather tlb(*this);
     for (auto &vma : vma_list) {
-        auto *memory =
-            static_cast<cap::MemoryPayload *>(vma.memory->clone_payload());
+        bool share_ro              = sharable_readonly(vma);
+        cap::MemoryPayload *memory = vma.memory;
+        if (!share_ro) {
+            memory = static_cast<cap::MemoryPayload *>(
+                vma.memory->clone_payload());
+        }
+        if (memory == nullptr) {
+            unexpect_return(ErrCode::OUT_OF_MEMORY);
+        }
         auto add_res = dst.add_vma(vma.type, vma.growth, vma.varea, memory,
                                    vma.rwx, vma.mem_offset);
-        propagate(add_res);
-
-        VirArea map_area = page_outer_area(vma.varea);
-        if (map_area.nullable()) {
-            continue;
-        }
-        auto clone_res = clone_vma_pages_to_cow(vma, map_area, dst);
-        propagate(clone_res);
-    }
-    _pman.flush_tlb();
-    dst.pman().flush_tlb();
-    void_return();
-}
-
-Result<void> TaskMemoryManager::clone_vma_pages_to_cow(const VMA &vma,
-                                                       const VirArea &map_area,
-                                                       TaskMemoryManager &dst) {
-    size_t page_count = map_area.size() / PAGESIZE;
-    for (size_t i = 0; i < page_count; ++i) {
-        VirAddr vaddr  = map_area.begin + i * PAGESIZE;
-        auto query_res = _pman.query_page(vaddr);
-        if (!query_res.has_value()) {
-            if (query_res.error() == ErrCode::PAGE_NOT_PRESENT) {
-                continue;
+        if (!add_res.has_value()) {
+            if (memory != vma.memory) {
+                memory->destruct();
             }
-            propagate_return(query_res);
+            propagate_return(add_res);
         }
+        add_res.value()->huge = vma.huge;
 
-        auto qres = query_res.value();
-        if (qres.size != PageMan::PageSize::_4K) {
-            loggers::PAGING::ERROR("clone_to_cow: COW 暂不支持大页: addr=%p",
-                                   vaddr.addr());
-            unexpect_return(ErrCode::NOT_SUPPORTED);
+        // 共享的 Memory 无需 COW; 私有 Memory 的页已被子进程引用,
+        // 父进程可写的映射须转为 COW
+        if (share_ro || vma.memory->shared) {
+            continue;
         }
-
-        PhyAddr paddr    = PageMan::get_physical_address(*qres.pte);
-        PageMan::RWX rwx = PageMan::rwx(*qres.pte);
-        bool cow_page    = !vma.memory->shared && (PageMan::is_writable(rwx) ||
-                                                PageMan::is_cow(*qres.pte));
-        PageMan::RWX child_rwx = cow_page ? PageMan::without_write(rwx) : rwx;
-
-        dst.pman().map_page<PageMan::PageSize::_4K>(
-            vaddr, paddr, child_rwx, PageMan::is_user_accessible(*qres.pte),
-            PageMan::is_global(*qres.pte));
-
-        if (cow_page) {
-            qres.pte->rwx = rwx_cast(PageMan::without_write(rwx));
-            PageMan::set_cow(qres.pte, true);
-
-            auto dst_query_res = dst.pman().query_page(vaddr);
-            if (!dst_query_res.has_value()) {
-                propagate_return(dst_query_res);
-            }
-            PageMan::set_cow(dst_query_res.value().pte, true);
+        VirArea map_area = page_outer_area(vma.varea);
+        if (map_area.nullable()) {
+            continue;
         }
+        auto protect_res = write_protect_pages(map_area, tlb);
+        propagate(protect_res);
     }
+    tlb.finish();
     void_return();
 }
@@ -12,10 +12,12 @@
 #pragma once
 
 #include <arch/description.h>
+#include <mem/tlb.h>
 #include <object/memory.h>
 #include <sus/list.h>
 #include <sus/nonnull.h>
 #include <sus/range.h>
+#include <sus/tree.h>
 #include <sus/types.h>
 #include <sustcore/addr.h>
 #include <sustcore/epacks.h>
@@ -86,7 +88,21 @@ struct VMA {
     VirArea varea;
     bool loading =
         false;  // 是否正在加载 (如ELF加载）, 用于处理缺页异常时区分是正常访问还是加载过程中访问
+    /// 是否允许以 2M 大页映射非物理连续的 Memory, 默认不允许. 
+    bool huge = false;
     util::ListHead<VMA> list_head = {};
+    util::rbtree::RBNode<VMA> rb_node = {};
+
+    /**
+     * @brief VMA 在索引树中的顺序: 按起始地址, 其次按结束地址
+     */
+    struct Order {
+        bool operator()(const VMA &lhs, const VMA &rhs) const {
+            return lhs.varea.begin < rhs.varea.begin ||
+                   (lhs.varea.begin == rhs.varea.begin &&
+                    lhs.varea.end < rhs.varea.end);
+        }
+    };
 
     constexpr VMA() = default;
     /**
@@ -111,7 +127,8 @@ struct VMA {
           rwx(rwx),
           mem_offset(mem_offset),
           varea(varea),
-          list_head({}) {
+          list_head({}),
+          rb_node({}) {
         assert(memory != nullptr);
         memory->keep();
     }
@@ -130,7 +147,9 @@ struct VMA {
           mem_offset(other.mem_offset),
           varea(other.varea),
           loading(other.loading),
-          list_head({}) {
+          huge(other.huge),
+          list_head({}),
+          rb_node({}) {
         assert(memory != nullptr);
         memory->keep();
     }
@@ -167,10 +186,26 @@ constexpr const char *to_string(VMA::Type type) {
 
 // Task Memory
 class TaskMemoryManager {
+public:
+    /// 默认的缺页窗口页数 (64K)
+    static constexpr size_t FAULT_AROUND_PAGES = 16;
+    /// 缺页窗口不跨越末级页表
+    static constexpr size_t MAX_FAULT_AROUND_PAGES = 512;
+
 private:
+    using VMATree = util::rbtree::RBTree<VMA, &VMA::rb_node, VMA::Order>;
+
     util::IntrusiveList<VMA> vma_list;
+    // 按地址索引的 VMA, 与 vma_list 包含相同的元素
+    VMATree vma_tree;
+    // 最近一次按地址命中的 VMA, 缺页通常集中在同一 VMA 内
+    VMA *_last_hit = nullptr;
     PhyAddr _pgd;
     PageMan _pman;
+    // 本地址空间的 ASID 及其所属代, 见 AsidAllocator
+    AsidAllocator::Context _asid_ctx = AsidAllocator::NO_CONTEXT;
+    // 缺页时一并映射的窗口页数, 见 fault_around
+    size_t _fault_around = FAULT_AROUND_PAGES;
 
     Result<VMA *> __check_vma(const util::nonnull<VMA *> &vma) {
         if (vma->tm != this) {
@@ -179,9 +214,57 @@ private:
         return vma.get();
     }
 
-    void unmap_pages(const VirArea &varea);
-    Result<void> clone_vma_pages_to_cow(const VMA &vma, const VirArea &map_area,
-                                        TaskMemoryManager &dst);
+    /**
+     * @brief 在索引树中查找覆盖 vaddr 且满足 pred 的 VMA
+     *
+     * 长度为 0 的 VMA 视为覆盖其起始地址.
+     */
+    template <typename Pred>
+    VMA *find_at(VirAddr vaddr, Pred pred) const;
+    /**
+     * @brief 在索引树中查找与 varea 相交的 VMA
+     *
+     * @param exclude 跳过的 VMA, 可为空
+     */
+    VMA *find_intersecting(const VirArea &varea, const VMA *exclude) const;
+    /**
+     * @brief 修改 VMA 的地址范围并同步索引树
+     */
+    void set_area(VMA &vma, const VirArea &varea);
+
+    /**
+     * @brief 解除 varea 内的页映射, 被解除的页记入 tlb
+     */
+    void unmap_pages(const VirArea &varea, TlbGather &tlb);
+    /**
+     * @brief 尝试以 2M 大页映射 vaddr 所在区域
+     *
+     * 仅物理连续的 Memory 与设置了 huge 的 VMA 可使用大页, 且 VMA 须
+     * 完整覆盖对齐的 2M 窗口, 窗口内尚无页表项.
+     *
+     * @return 未能使用大页时返回 false, 由调用者按 4K 页处理
+     */
+    bool map_huge(VMA &vma, VirAddr vaddr);
+    /**
+     * @brief 以只读方式映射不归 Memory 所有的页 (全局零页或后备页)
+     *
+     * 可写 VMA 中按 COW 映射, 首次写入时由 on_wp 分配实际的页.
+     */
+    bool map_borrowed(VMA &vma, VirAddr vaddr, PhyAddr paddr);
+    /**
+     * @brief 为 vaddr 所在对齐窗口内 Memory 已持有的页及后备页建立映射
+     *
+     * 只映射尚无页表项的页, 不分配物理页与页表.
+     *
+     * @return 新映射的页数
+     */
+    size_t fault_around(VMA &vma, VirAddr vaddr);
+    /**
+     * @brief 将 varea 内可写的映射转为只读 COW, 被修改的项记入 tlb
+     *
+     * @return 遇到 1G 大页时返回 NOT_SUPPORTED
+     */
+    Result<void> write_protect_pages(const VirArea &varea, TlbGather &tlb);
 
 public:
     TaskMemoryManager(PhyAddr _pgd);
@@ -282,10 +365,81 @@ public:
         return _pman;
     }
 
+    /**
+     * @brief 本地址空间占用的页表页数 (不含根页表)
+     */
+    [[nodiscard]]
+    size_t page_table_pages() {
+        return _pman.table_pages();
+    }
+
+    /**
+     * @brief 以本地址空间的 ASID 切换到其页表.
+     *
+     * 支持 ASID 时切换无需刷新 TLB; ASID 过期时由 AsidAllocator 重新分配.
+     */
+    void activate();
+
+    /**
+     * @brief 刷新本地址空间在 TLB 中的非全局项.
+     *
+     * 尚未分配, 或已过期且未被任何处理器保留的 ASID 不会有可用的
+     * TLB 项, 此时无需刷新; 被保留的旧代 ASID 仍可能在其它处理器上
+     * 运行, 须照常刷新.
+     */
+    void flush_tlb();
+
+    /**
+     * @brief 刷新本地址空间在 TLB 中某一页的项.
+     */
+    void flush_tlb_page(VirAddr vaddr);
+
+    /**
+     * @brief 刷新本地址空间在 TLB 中某一区间的项.
+     *
+     * 本地逐页刷新, 其它处理器以一次核间请求刷新整个区间.
+     */
+    void flush_tlb_range(const VirArea &varea);
+
+    /**
+     * @brief 切换到指定地址空间.
+     *
+     * tmm 为空或其页表根不为 pgd 时 (如内核页表), 以 ASID 0 切换到 pgd
+     * 并全局刷新 TLB.
+     */
+    static void switch_to(TaskMemoryManager *tmm, PhyAddr pgd);
+
+    /**
+     * @brief 以 ASID 0 切换到内核页表, 供不属于任何进程的空闲上下文使用.
+     *
+     * 用户地址空间不使用 ASID 0, 支持 ASID 时无需刷新 TLB.
+     */
+    static void activate_kernel();
+
+    /**
+     * @brief 设置缺页窗口页数.
+     *
+     * @param pages 须为 2 的幂且不超过 MAX_FAULT_AROUND_PAGES; 0 或 1
+     * 表示每次缺页只映射一页.
+     */
+    Result<void> set_fault_around(size_t pages);
+
+    [[nodiscard]]
+    constexpr size_t fault_around_pages() const {
+        return _fault_around;
+    }
+
     // On No Present Pages
     bool on_np(const NoPresentEvent &e);
     // write protection
     bool on_wp(VirAddr fault_addr);
+    /**
+     * @brief 为 fork 复制地址空间.
+     *
+     * 只复制 VMA 与 Memory, 不复制页表项: 子进程首次访问时经 on_np 建立
+     * 映射. 仅被一个只读 VMA 引用的 Memory 由父子直接共享, 不做 COW;
+     * 父进程私有 Memory 的可写映射转为 COW.
+     */
     Result<void> clone_to_cow(TaskMemoryManager &dst);
 };
 
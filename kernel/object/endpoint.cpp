@@ -42,8 +42,7 @@ namespace cap {
             target_tmm->pgd() != origin_pgd)
         {
             env::inst().tmm(key::endpoint()) = target_tmm;
-            PageMan(target_tmm->pgd()).switch_root();
-            PageMan::flush_tlb();
+            target_tmm->activate();
         }
 
         tcb->coroutines.ipc_handle.resume();
@@ -52,8 +51,7 @@ namespace cap {
             target_tmm->pgd() != origin_pgd)
         {
             env::inst().tmm(key::endpoint()) = origin_tmm;
-            PageMan(origin_pgd).switch_root();
-            PageMan::flush_tlb();
+            TaskMemoryManager::switch_to(origin_tmm, origin_pgd);
         }
     }
 
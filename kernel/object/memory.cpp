@@ -15,6 +15,7 @@
 #include <object/perm.h>
 #include <sustcore/errcode.h>
 
+#include <cassert>
 #include <cstring>
 
 namespace {
@@ -25,6 +26,13 @@ namespace {
         return page_align_down(offset);
     }
 
+    /**
+     * @brief Memory 内偏移所在的页号. 
+     */
+    size_t page_index(size_t offset) {
+        return offset / PAGESIZE;
+    }
+
     /**
      * @brief 判断请求的增长/收缩方式是否被 Memory 属性允许. 
      */
@@ -55,7 +63,12 @@ namespace {
         propagate(paddr_res);
         PhyAddr base = paddr_res.value();
         for (size_t i = 0; i < pages; ++i) {
-            memory->phy_pages.push_back({base + i * PAGESIZE, i * PAGESIZE});
+            auto set_res = memory->phy_pages.set(i, base + i * PAGESIZE);
+            if (!set_res.has_value()) {
+                memory->phy_pages.clear([](size_t, PhyAddr) {});
+                GFP::put_page(base, pages);
+                propagate_return(set_res);
+            }
         }
         void_return();
     }
@@ -71,9 +84,7 @@ namespace cap {
           phy_pages() {}
 
     void MemoryPayload::destruct() {
-        for (auto &page : phy_pages) {
-            GFP::put_page(page.addr, 1);
-        }
+        phy_pages.clear([](size_t, PhyAddr paddr) { GFP::put_page(paddr, 1); });
         delete this;
     }
 
@@ -83,9 +94,23 @@ namespace cap {
         }
 
         auto *cloned = new MemoryPayload(memsz, shared, continuity, growth);
-        for (auto &page : phy_pages) {
-            GFP::keep_page(page.addr, 1);
-            cloned->phy_pages.push_back(page);
+        // 克隆与原 payload 共用后备内容
+        cloned->backing      = backing;
+        cloned->backing_size = backing_size;
+        bool failed          = false;
+        phy_pages.for_each([cloned, &failed](size_t idx, PhyAddr paddr) {
+            if (failed) {
+                return;
+            }
+            if (!cloned->phy_pages.set(idx, paddr).has_value()) {
+                failed = true;
+                return;
+            }
+            GFP::keep_page(paddr, 1);
+        });
+        if (failed) {
+            cloned->destruct();
+            return nullptr;
         }
         return cloned;
     }
@@ -95,12 +120,35 @@ namespace cap {
         if (poff >= memsz) {
             unexpect_return(ErrCode::OUT_OF_BOUNDARY);
         }
-        for (auto &page : phy_pages) {
-            if (page.offset == poff) {
-                return page.addr;
-            }
+        PhyAddr paddr = phy_pages.get(page_index(poff));
+        if (!paddr.nonnull()) {
+            unexpect_return(ErrCode::PAGE_NOT_PRESENT);
+        }
+        return paddr;
+    }
+
+    void MemoryPayload::set_backing(const void *data, size_t size) {
+        assert(!shared && !continuity);
+        backing      = static_cast<const uint8_t *>(data);
+        backing_size = size < memsz ? size : memsz;
+    }
+
+    bool MemoryPayload::backed(size_t offset) const {
+        return backing != nullptr && page_offset(offset) < backing_size;
+    }
+
+    Result<PhyAddr> MemoryPayload::backing_page(size_t offset) const {
+        size_t poff = page_offset(offset);
+        if (!backed(poff) || poff + PAGESIZE > backing_size ||
+            phy_pages.get(page_index(poff)).nonnull())
+        {
+            unexpect_return(ErrCode::PAGE_NOT_PRESENT);
+        }
+        PhyAddr paddr = convert_pointer(backing + poff);
+        if (!paddr.aligned<PAGESIZE>()) {
+            unexpect_return(ErrCode::PAGE_NOT_PRESENT);
         }
-        unexpect_return(ErrCode::PAGE_NOT_PRESENT);
+        return paddr;
     }
 
     Result<PhyAddr> MemoryPayload::ensure_page(size_t offset) {
@@ -112,37 +160,89 @@ namespace cap {
             propagate_return(lookup_res);
         }
 
-        size_t poff   = page_offset(offset);
-        auto page_res = GFP::get_free_page(1);
+        auto page_res = GFP::get_free_page(1, GFP_ZERO);
         propagate(page_res);
         PhyAddr paddr = page_res.value();
-        memset(convert<KpaAddr>(paddr).addr(), 0, PAGESIZE);
-        phy_pages.push_back({paddr, poff});
+        if (backed(offset)) {
+            size_t poff = page_offset(offset);
+            size_t len  = backing_size - poff;
+            memcpy(convert<KpaAddr>(paddr).addr(), backing + poff,
+                   len < PAGESIZE ? len : PAGESIZE);
+        }
+        auto set_res = phy_pages.set(page_index(offset), paddr);
+        if (!set_res.has_value()) {
+            GFP::put_page(paddr, 1);
+            propagate_return(set_res);
+        }
         return paddr;
     }
 
-    Result<void> MemoryPayload::replace_page(size_t offset, PhyAddr new_addr) {
-        size_t poff = page_offset(offset);
-        for (auto &page : phy_pages) {
-            if (page.offset == poff) {
-                GFP::put_page(page.addr, 1);
-                page.addr = new_addr;
-                void_return();
+    Result<PhyAddr> MemoryPayload::ensure_huge(size_t offset) {
+        constexpr size_t huge  = PageMan::psize(PageMan::PageSize::_2M);
+        constexpr size_t pages = huge / PAGESIZE;
+        if (offset % huge != 0 || offset + huge > memsz) {
+            unexpect_return(ErrCode::INVALID_PARAM);
+        }
+        // 后备内容须逐页填充
+        if (backing != nullptr) {
+            unexpect_return(ErrCode::NOT_SUPPORTED);
+        }
+
+        const size_t first = page_index(offset);
+        PhyAddr base       = phy_pages.get(first);
+        if (base.nonnull()) {
+            if (!base.aligned(huge)) {
+                unexpect_return(ErrCode::NOT_SUPPORTED);
+            }
+            for (size_t i = 0; i < pages; ++i) {
+                PhyAddr paddr = phy_pages.get(first + i);
+                if (paddr != base + i * PAGESIZE || GFP::ref_count(paddr) != 1)
+                {
+                    unexpect_return(ErrCode::NOT_SUPPORTED);
+                }
             }
+            return base;
+        }
+        for (size_t i = 1; i < pages; ++i) {
+            if (phy_pages.get(first + i).nonnull()) {
+                unexpect_return(ErrCode::NOT_SUPPORTED);
+            }
+        }
+
+        // 页框分配器的块按其大小自然对齐
+        auto block_res = GFP::get_free_page(pages, GFP_ZERO);
+        propagate(block_res);
+        base = block_res.value();
+        assert(base.aligned(huge));
+
+        // 这些页号同属页索引的一个叶节点, 先插入末页以确保该叶节点存在
+        // (页号 0 可内联于根槽, 不能代为分配), 其余插入不再分配节点
+        const size_t last = first + pages - 1;
+        auto set_res      = phy_pages.set(last, base + (pages - 1) * PAGESIZE);
+        if (!set_res.has_value()) {
+            GFP::put_page(base, pages);
+            propagate_return(set_res);
+        }
+        for (size_t i = 0; i + 1 < pages; ++i) {
+            auto res [[maybe_unused]] =
+                phy_pages.set(first + i, base + i * PAGESIZE);
+            assert(res.has_value());
         }
-        unexpect_return(ErrCode::PAGE_NOT_PRESENT);
+        return base;
+    }
+
+    Result<void> MemoryPayload::replace_page(size_t offset, PhyAddr new_addr) {
+        auto replace_res = phy_pages.replace(page_index(offset), new_addr);
+        propagate(replace_res);
+        GFP::put_page(replace_res.value(), 1);
+        void_return();
     }
 
     void MemoryPayload::release_pages_from(size_t offset) {
-        size_t poff = page_offset(offset);
-        for (auto it = phy_pages.begin(); it != phy_pages.end();) {
-            if (it->offset >= poff) {
-                GFP::put_page(it->addr, 1);
-                it = phy_pages.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        phy_pages.truncate(page_index(page_offset(offset)),
+                           [](size_t, PhyAddr paddr) {
+                               GFP::put_page(paddr, 1);
+                           });
     }
 
     Result<void> MemoryPayload::resize(size_t newsz) {
@@ -170,10 +270,9 @@ namespace cap {
                 void_return();
             }
 
-            auto new_base_res = GFP::get_free_page(new_pages);
+            auto new_base_res = GFP::get_free_page(new_pages, GFP_ZERO);
             propagate(new_base_res);
             PhyAddr new_base = new_base_res.value();
-            memset(convert<KpaAddr>(new_base).addr(), 0, new_pages * PAGESIZE);
 
             size_t copy_pages = old_pages < new_pages ? old_pages : new_pages;
             for (size_t i = 0; i < copy_pages; ++i) {
@@ -185,12 +284,16 @@ namespace cap {
                 }
             }
 
-            for (auto &page : phy_pages) {
-                GFP::put_page(page.addr, 1);
-            }
-            phy_pages.clear();
+            phy_pages.clear(
+                [](size_t, PhyAddr paddr) { GFP::put_page(paddr, 1); });
             for (size_t i = 0; i < new_pages; ++i) {
-                phy_pages.push_back({new_base + i * PAGESIZE, i * PAGESIZE});
+                auto set_res = phy_pages.set(i, new_base + i * PAGESIZE);
+                if (!set_res.has_value()) {
+                    phy_pages.clear([](size_t, PhyAddr) {});
+                    GFP::put_page(new_base, new_pages);
+                    memsz = 0;
+                    propagate_return(set_res);
+                }
             }
         } else if (newsz < memsz) {
             release_pages_from(newsz);
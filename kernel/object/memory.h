@@ -13,31 +13,12 @@
 
 #include <arch/description.h>
 #include <cap/capability.h>
-#include <sus/list.h>
+#include <mem/page_index.h>
 #include <sustcore/addr.h>
 
 class TaskMemoryManager;
 
 namespace cap {
-    /**
-     * @brief Memory Capability 已分配物理页记录. 
-     *
-     * addr 是物理页起始地址, offset 是该页在 Memory payload 中的页对齐偏移. 
-     */
-    struct PhyPage {
-        /// 物理页起始地址. 
-        PhyAddr addr;
-        /// 该物理页在 Memory payload 内的偏移. 
-        size_t offset;
-
-        /**
-         * @brief 比较两个物理页记录是否完全相同. 
-         */
-        constexpr bool operator==(const PhyPage &other) const noexcept {
-            return addr == other.addr && offset == other.offset;
-        }
-    };
-
     /**
      * @brief Memory Capability 支持的 VMA 增长/收缩方向. 
      *
@@ -64,7 +45,7 @@ namespace cap {
      * @brief Memory Capability 的 payload. 
      *
      * MemoryPayload 表示一段承诺大小的物理内存. 物理页按需分配, 
-     * 由 phy_pages 记录已经实际分配的页. VMA 只持有该 payload 的引用, 
+     * 由 phy_pages 以页号为键记录已经实际分配的页. VMA 只持有该 payload 的引用, 
      * 物理页生命周期由 payload 统一管理. 
      */
     struct MemoryPayload : public _PayloadHelper<PayloadType::MEMORY> {
@@ -76,8 +57,16 @@ namespace cap {
         bool continuity;
         /// 允许的增长/收缩方式. 
         MemoryGrowth growth;
-        /// 已实际分配的物理页列表. 
-        util::ArrayList<PhyPage> phy_pages;
+        /// 已实际分配的物理页, 以 Memory 内页号为键. 
+        PageIndex phy_pages;
+        /// 后备内容, 偏移 [0, backing_size) 的页在分配前取自此处; 
+        /// 为 nullptr 时没有后备内容. 
+        const uint8_t *backing = nullptr;
+        /// 后备内容的字节数. 
+        size_t backing_size = 0;
+        /// 是否为 ELF 加载器或镜像缓存持有的段内容; 此类 Memory 不经任何
+        /// capability 暴露, 无法被写入或调整大小. clone 时不继承. 
+        bool image_owned = false;
 
         /**
          * @brief 构造 Memory payload. 
@@ -101,7 +90,7 @@ namespace cap {
          * shared Memory 返回自身; 非 shared Memory 创建新 payload, 
          * 并让已分配页通过 GFP 引用计数进入 COW 共享状态. 
          *
-         * @return 克隆后的 payload. 
+         * @return 克隆后的 payload; 页索引节点分配失败时返回 nullptr. 
          */
         Payload *clone_payload() override;
 
@@ -112,15 +101,53 @@ namespace cap {
          * @return 已分配物理页地址; 未分配返回 PAGE_NOT_PRESENT. 
          */
         Result<PhyAddr> lookup_page(size_t offset) const;
+        /**
+         * @brief 设置后备内容. 
+         *
+         * 用于按需加载文件内容 (如 initrd 中的 ELF 段). data 须在
+         * payload 及其克隆存活期间保持有效且不变. 
+         *
+         * @param data 后备内容起始地址 (内核地址), 对应 Memory 偏移 0. 
+         * @param size 后备内容字节数, 超出 memsz 的部分被忽略. 
+         */
+        void set_backing(const void *data, size_t size);
+        /**
+         * @brief 判断指定偏移所在页是否含有后备内容. 
+         */
+        [[nodiscard]]
+        bool backed(size_t offset) const;
+        /**
+         * @brief 查询可直接映射的后备页. 
+         *
+         * 仅当该页尚未分配, 且后备内容在此处页对齐并完整覆盖该页时成功. 
+         * 返回的页不归 payload 所有, 只能以只读方式映射, 
+         * 写入前须经 ensure_page 替换为私有页. 
+         *
+         * @param offset Memory 内偏移, 可以非页对齐. 
+         * @return 后备页的物理地址; 不可直接映射时返回 PAGE_NOT_PRESENT. 
+         */
+        Result<PhyAddr> backing_page(size_t offset) const;
         /**
          * @brief 确保指定偏移对应的物理页存在. 
          *
-         * 未分配时会懒分配一个零页并加入 phy_pages. 
+         * 未分配时会懒分配一个零页并加入 phy_pages, 有后备内容时
+         * 以其填充. 查找与插入均为 O(树高), 不随已分配页数增长. 
          *
          * @param offset Memory 内偏移, 可以非页对齐. 
          * @return 物理页地址. 
          */
         Result<PhyAddr> ensure_page(size_t offset);
+        /**
+         * @brief 确保从 offset 开始的一个大页区域由对齐的连续物理块支撑. 
+         *
+         * 区域内尚无物理页时分配一个按大页对齐的零块; 已全部存在,
+         * 物理连续且对齐, 并且均未被 COW 共享时直接返回. 其余情形返回
+         * NOT_SUPPORTED, 调用者应退回按 4K 页处理. 
+         *
+         * @param offset Memory 内偏移, 须按大页对齐. 
+         * @return 物理块起始地址. 
+         */
+        Result<PhyAddr> ensure_huge(size_t offset);
         /**
          * @brief 将指定偏移对应的物理页替换为新页. 
          *
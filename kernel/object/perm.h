@@ -102,6 +102,11 @@ namespace perm::pcb {
     constexpr b64 EXECUTE     = 0x20'0000;
 }  // namespace perm::pcb
 
+namespace perm::tcb {
+    // 修改线程调度参数的权限
+    constexpr b64 SETSCHED = 0x01'0000;
+}  // namespace perm::tcb
+
 namespace perm::sintobj {
     // SharedIntObjectect的权限定义
     // 该对象仅用于测试能力系统, 因此权限非常简单
@@ -59,6 +59,12 @@ namespace cap {
                     loggers::TASK::ERROR("pcb kill移除线程失败: tid=%d err=%d",
                                          tcb.tid, dequeue_res.error());
                 }
+            } else if (&tcb != current_tcb &&
+                       tcb.basic_entity.state == ThreadState::RUNNING)
+            {
+                // 正在其它处理器上运行, 由该处理器在下一次陷入时切换走
+                tcb.basic_entity
+                    .template flags_set<schd::SchedMeta::FLAGS_NEED_RESCHED>();
             }
             tcb.basic_entity.state = ThreadState::WAITING;
         }
@@ -121,4 +127,37 @@ namespace cap {
         }
         return _obj->pcb;
     }
+
+    Result<void> TCBObject::set_nice(int nice) const {
+        if (!imply(perm::tcb::SETSCHED)) {
+            unexpect_return(ErrCode::INSUFFICIENT_PERMISSIONS);
+        }
+        if (_obj->tcb == nullptr) {
+            unexpect_return(ErrCode::NULLPTR);
+        }
+        return schd::Scheduler::set_nice(util::nnullforce(_obj->tcb), nice);
+    }
+
+    Result<void> TCBObject::set_priority(size_t prio) const {
+        if (!imply(perm::tcb::SETSCHED)) {
+            unexpect_return(ErrCode::INSUFFICIENT_PERMISSIONS);
+        }
+        if (_obj->tcb == nullptr) {
+            unexpect_return(ErrCode::NULLPTR);
+        }
+        return schd::Scheduler::set_priority(util::nnullforce(_obj->tcb),
+                                             prio);
+    }
+
+    Result<void> TCBObject::set_deadline(size_t runtime, size_t period,
+                                         size_t deadline) const {
+        if (!imply(perm::tcb::SETSCHED)) {
+            unexpect_return(ErrCode::INSUFFICIENT_PERMISSIONS);
+        }
+        if (_obj->tcb == nullptr) {
+            unexpect_return(ErrCode::NULLPTR);
+        }
+        return schd::Scheduler::set_deadline(util::nnullforce(_obj->tcb),
+                                             runtime, period, deadline);
+    }
 }  // namespace cap
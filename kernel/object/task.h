@@ -118,5 +118,32 @@ namespace cap {
          */
         explicit TCBObject(util::nonnull<Capability *> cap)
             : CapObj<TCBPayload>(cap) {}
+
+        /**
+         * @brief 设置关联线程的 nice 值. 
+         *
+         * 要求 SETSCHED 权限. nice 值决定线程在 CFS 调度类中的权重,
+         * 线程不属于 CFS 时仅记录, 待其进入 CFS 后生效. 
+         *
+         * @param nice 取值范围为 [-20, 19], 越小获得的 CPU 份额越多. 
+         */
+        Result<void> set_nice(int nice) const;
+        /**
+         * @brief 设置关联线程的静态优先级. 
+         *
+         * 要求 SETSCHED 权限. 优先级决定线程在 RR 调度类中的次序,
+         * 线程不属于 RR 时仅记录, 待其进入 RR 后生效. 
+         *
+         * @param prio 取值范围为 [0, 32), 越大越优先. 
+         */
+        Result<void> set_priority(size_t prio) const;
+        /**
+         * @brief 设置关联线程的 DL 参数. 
+         *
+         * 要求 SETSCHED 权限. runtime 非 0 时线程经准入检查后进入 DL
+         * 调度类, 为 0 时退出 DL. 参数均以时钟中断为单位. 
+         */
+        Result<void> set_deadline(size_t runtime, size_t period,
+                                  size_t deadline) const;
     };
 }  // namespace cap
@@ -9,6 +9,7 @@
  *
  */
 
+#include <exe/image_cache.h>
 #include <object/perm.h>
 #include <object/vfile.h>
 #include <vfs/vfs.h>
@@ -31,6 +32,8 @@ namespace cap {
             loggers::CAPABILITY::ERROR("权限不足");
             return {unexpect, ErrCode::INSUFFICIENT_PERMISSIONS};
         }
+        // 文件内容改变, 已缓存的镜像随之失效
+        loader::ImageCache::invalidate(_vind);
         // 调用VFS的write接口
         return VFS::inst().write(_vind, offset, buf, len);
     }
@@ -54,4 +57,14 @@ namespace cap {
         // 调用VFS的sync接口
         return VFS::inst().sync(_vind);
     }
+
+    Result<const void *> VFileObject::mapping() {
+        using namespace perm::vfile;
+        if (!imply(READ)) {
+            loggers::CAPABILITY::ERROR("权限不足");
+            return {unexpect, ErrCode::INSUFFICIENT_PERMISSIONS};
+        }
+        // 调用VFS的mapping接口
+        return VFS::inst().mapping(_vind);
+    }
 }  // namespace cap
@@ -32,6 +32,12 @@ namespace cap {
         Result<size_t> write(off_t offset, const void *buf, size_t len);
         Result<size_t> size();
         Result<void> sync();
+        Result<const void *> mapping();
+
+        [[nodiscard]]
+        VINode *vind() const {
+            return _vind;
+        }
 
         /**
          * @brief 读取一定长度的数据到缓冲区
@@ -0,0 +1,252 @@
+/**
+ * @file cfs.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 按加权虚拟运行时间公平分配 CPU 的调度器
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <schd/schdbase.h>
+#include <sus/nonnull.h>
+#include <sustcore/errcode.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace schd::cfs {
+    // nice 0 的实体运行一个时钟中断所增加的虚拟运行时间
+    constexpr uint64_t TICK_VRUNTIME = 1 << 20;
+
+    /**
+     * @brief 运行 ticks 个时钟中断后, 权重为 weight 的实体增加的虚拟运行时间
+     */
+    constexpr uint64_t vruntime_delta(size_t ticks, uint32_t weight) {
+        return ticks * TICK_VRUNTIME * NICE_0_WEIGHT / weight;
+    }
+
+    /**
+     * @brief 将实体的虚拟运行时间从 from 队列的基准换算到 to 队列的基准
+     *
+     * 各处理器的虚拟时间独立推进, 迁移时保持实体相对基准的超前或落后量.
+     */
+    constexpr void rebase(Entity &entity, const RunQueue &from,
+                          const RunQueue &to) {
+        if (entity.vruntime >= from.min_vruntime) {
+            entity.vruntime = to.min_vruntime +
+                              (entity.vruntime - from.min_vruntime);
+        } else {
+            uint64_t lag = from.min_vruntime - entity.vruntime;
+            entity.vruntime =
+                lag < to.min_vruntime ? to.min_vruntime - lag : 0;
+        }
+    }
+
+    template <typename SU>
+    class CFS : public BaseSched<SU> {
+    public:
+        using SUType                          = SU;
+        constexpr static ClassType CLASS_TYPE = ClassType::CFS;
+        // 调度周期, 期间每个就绪实体按权重比例各运行一次
+        constexpr static size_t SCHED_LATENCY   = 6;
+        // 单次运行的最少时钟中断数
+        constexpr static size_t MIN_GRANULARITY = 1;
+        // 被唤醒的实体须至少落后当前实体这么多才会抢占
+        constexpr static uint64_t WAKEUP_GRANULARITY = TICK_VRUNTIME;
+        // 睡眠后被唤醒的实体至多获得的补偿, 使交互式线程能尽快得到响应
+        constexpr static uint64_t SLEEPER_CREDIT =
+            SCHED_LATENCY * TICK_VRUNTIME / 2;
+
+    private:
+        constexpr static size_t ENTITY_OFFSET = offsetof(SUType, cfs_entity);
+
+        inline util::nonnull<Entity *> as_entity_cfs(
+            util::nonnull<SUType *> unit) {
+            return util::nnullforce(&unit->cfs_entity);
+        }
+
+        inline util::nonnull<SUType *> asunit_cfs(Entity *entity) {
+            auto *su_ptr = reinterpret_cast<char *>(entity) - ENTITY_OFFSET;
+            return util::nnullforce(reinterpret_cast<SUType *>(su_ptr));
+        }
+
+        void insert(RunQueue &cfs_rq, Entity &entity) {
+            cfs_rq.timeline.insert(entity);
+            cfs_rq.load_weight += entity.weight;
+            entity.queued       = true;
+        }
+
+        void remove(RunQueue &cfs_rq, Entity &entity) {
+            cfs_rq.timeline.remove(entity);
+            cfs_rq.load_weight -= entity.weight;
+            entity.queued       = false;
+        }
+
+        // curr 为正在运行的实体, 基准取其与最左实体中较小者, 且不回退
+        void update_min_vruntime(RunQueue &cfs_rq, const Entity *curr) {
+            uint64_t vruntime = UINT64_MAX;
+            if (curr != nullptr) {
+                vruntime = curr->vruntime;
+            }
+            Entity *leftmost = cfs_rq.timeline.first();
+            if (leftmost != nullptr && leftmost->vruntime < vruntime) {
+                vruntime = leftmost->vruntime;
+            }
+            if (vruntime != UINT64_MAX && vruntime > cfs_rq.min_vruntime) {
+                cfs_rq.min_vruntime = vruntime;
+            }
+        }
+
+    public:
+        /**
+         * @brief 队列尾部的调度单元, 即虚拟运行时间最大者
+         *
+         * 它离被调度最远, 适合迁移到其它处理器.
+         */
+        SUType *last(util::nonnull<RQ *> rq) {
+            Entity *entity = rq->cfs.timeline.last();
+            if (entity == nullptr) {
+                return nullptr;
+            }
+            return asunit_cfs(entity);
+        }
+
+        /**
+         * @brief 修改调度单元的 nice 值
+         *
+         * 在队列中的实体须先移出再以新权重插入, 以保持权重之和正确.
+         */
+        Result<void> set_nice(util::nonnull<RQ *> rq,
+                              util::nonnull<SUType *> unit, int nice) {
+            if (nice < MIN_NICE || nice > MAX_NICE) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            auto entity = as_entity_cfs(unit);
+            if (!entity->queued) {
+                entity->set_nice(nice);
+                void_return();
+            }
+            remove(rq->cfs, *entity);
+            entity->set_nice(nice);
+            insert(rq->cfs, *entity);
+            void_return();
+        }
+
+        Result<void> enqueue(util::nonnull<RQ *> rq,
+                             util::nonnull<SUType *> unit) override {
+            auto meta   = this->asmeta(unit);
+            auto entity = as_entity_cfs(unit);
+            if (entity->queued) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            // 长时间睡眠的实体不能凭积攒的落后量独占 CPU,
+            // 至多比基准提前 SLEEPER_CREDIT
+            uint64_t floor = rq->cfs.min_vruntime > SLEEPER_CREDIT
+                                 ? rq->cfs.min_vruntime - SLEEPER_CREDIT
+                                 : 0;
+            if (entity->vruntime < floor) {
+                entity->vruntime = floor;
+            }
+            meta->state = ThreadState::READY;
+            insert(rq->cfs, *entity);
+            void_return();
+        }
+
+        Result<void> dequeue(util::nonnull<RQ *> rq,
+                             util::nonnull<SUType *> unit) override {
+            auto meta   = this->asmeta(unit);
+            auto entity = as_entity_cfs(unit);
+            if (!entity->queued) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            remove(rq->cfs, *entity);
+            meta->state = ThreadState::EMPTY;
+            void_return();
+        }
+
+        Result<util::nonnull<SUType *>> pick_next(
+            util::nonnull<RQ *> rq) override {
+            Entity *entity = rq->cfs.timeline.first();
+            if (entity == nullptr) {
+                unexpect_return(ErrCode::NO_RUNNABLE_THREAD);
+            }
+            remove(rq->cfs, *entity);
+            entity->slice_ticks = 0;
+            update_min_vruntime(rq->cfs, entity);
+
+            auto unit      = asunit_cfs(entity);
+            auto meta      = this->asmeta(unit);
+            meta->state    = ThreadState::RUNNING;
+            this->cursched = meta;
+            return unit;
+        }
+
+        Result<void> put_prev(util::nonnull<RQ *> rq,
+                              util::nonnull<SUType *> unit) override {
+            auto meta   = this->asmeta(unit);
+            meta->state = ThreadState::READY;
+            insert(rq->cfs, *as_entity_cfs(unit));
+            void_return();
+        }
+
+        Result<void> yield(util::nonnull<RQ *> rq) override {
+            // 为当前进程添加 NEED_RESCHED 标志
+            if (this->cursched != nullptr) {
+                this->cursched
+                    ->template flags_set<SchedMeta::FLAGS_NEED_RESCHED>();
+            }
+            void_return();
+        }
+
+        /**
+         * @brief 每个tick调用一次, 用于更新调度单元的状态
+         *
+         * 按权重累加当前实体的虚拟运行时间; 当其运行时间超过按权重
+         * 分得的调度周期份额时, 添加 NEED_RESCHED 标志.
+         *
+         * @param rq
+         * @param unit
+         * @return Result<void>
+         */
+        Result<void> on_tick(util::nonnull<RQ *> rq,
+                             util::nonnull<SUType *> unit) override {
+            auto entity        = as_entity_cfs(unit);
+            entity->vruntime  += vruntime_delta(1, entity->weight);
+            entity->slice_ticks++;
+            update_min_vruntime(rq->cfs, entity);
+
+            if (rq->cfs.timeline.empty()) {
+                void_return();
+            }
+            uint64_t total = rq->cfs.load_weight + entity->weight;
+            size_t ideal   = SCHED_LATENCY * entity->weight / total;
+            if (ideal < MIN_GRANULARITY) {
+                ideal = MIN_GRANULARITY;
+            }
+            if (entity->slice_ticks >= ideal) {
+                this->asmeta(unit)
+                    ->template flags_set<SchedMeta::FLAGS_NEED_RESCHED>();
+            }
+            void_return();
+        }
+
+        bool check_preempt_curr(util::nonnull<RQ *> rq,
+                                util::nonnull<SUType *> new_su) override {
+            // 只要对方的级别比自己高, 就需要抢占当前任务
+            return true;
+        }
+
+        bool check_preempt_wakeup(util::nonnull<RQ *> rq,
+                                  util::nonnull<SUType *> curr,
+                                  util::nonnull<SUType *> new_su) override {
+            auto curr_entity = as_entity_cfs(curr);
+            auto new_entity  = as_entity_cfs(new_su);
+            return curr_entity->vruntime >
+                   new_entity->vruntime + WAKEUP_GRANULARITY;
+        }
+    };
+}  // namespace schd::cfs
@@ -0,0 +1,275 @@
+/**
+ * @file dl.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 最早截止时间优先 (EDF) 的实时调度器
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <schd/schdbase.h>
+#include <sus/nonnull.h>
+#include <sustcore/errcode.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace schd::dl {
+    /**
+     * @brief 按 EDF 选择线程, 并以恒定带宽服务器 (CBS) 隔离各线程的带宽
+     *
+     * 每个线程每周期至多运行 runtime, 预算用尽即被节流至下一周期,
+     * 因此超支的线程不会挤占其它 DL 线程已准入的带宽.
+     */
+    template <typename SU>
+    class DL : public BaseSched<SU> {
+    public:
+        using SUType                          = SU;
+        constexpr static ClassType CLASS_TYPE = ClassType::DL;
+
+    private:
+        constexpr static size_t ENTITY_OFFSET = offsetof(SUType, dl_entity);
+
+        inline util::nonnull<Entity *> as_entity_dl(
+            util::nonnull<SUType *> unit) {
+            return util::nnullforce(&unit->dl_entity);
+        }
+
+        inline util::nonnull<SUType *> asunit_dl(Entity *entity) {
+            auto *su_ptr = reinterpret_cast<char *>(entity) - ENTITY_OFFSET;
+            return util::nnullforce(reinterpret_cast<SUType *>(su_ptr));
+        }
+
+        void insert(RunQueue &dl_rq, Entity &entity) {
+            if (entity.throttled) {
+                dl_rq.throttled.insert(entity);
+            } else {
+                dl_rq.ready.insert(entity);
+            }
+            entity.queued = true;
+        }
+
+        void remove(RunQueue &dl_rq, Entity &entity) {
+            if (entity.throttled) {
+                dl_rq.throttled.remove(entity);
+            } else {
+                dl_rq.ready.remove(entity);
+            }
+            entity.queued = false;
+        }
+
+        // 正在运行的作业越过截止时间时仍有剩余预算, 记一次错过
+        void check_miss(RunQueue &dl_rq, Entity &entity) {
+            if (entity.missed || entity.runtime_left == 0 ||
+                dl_rq.clock < entity.deadline)
+            {
+                return;
+            }
+            entity.missed = true;
+            entity.misses++;
+            dl_rq.nr_missed++;
+        }
+
+    public:
+        /**
+         * @brief 准入检查
+         *
+         * 要求 0 < runtime <= deadline <= period, 且本处理器上 DL 线程的
+         * 带宽之和 (替换 unit 原有的带宽后) 不超过 MAX_BW.
+         * 检查不修改任何状态.
+         *
+         * @return unit 以新参数运行所需的带宽
+         */
+        Result<uint64_t> admit(util::nonnull<RQ *> rq,
+                               util::nonnull<SUType *> unit, size_t runtime,
+                               size_t period, size_t deadline) {
+            if (runtime == 0 || runtime > deadline || deadline > period) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            uint64_t bw     = bandwidth(runtime, deadline);
+            uint64_t others = rq->dl.total_bw - as_entity_dl(unit)->bw;
+            if (others + bw > MAX_BW) {
+                unexpect_return(ErrCode::BUSY);
+            }
+            return bw;
+        }
+
+        /**
+         * @brief 以新参数开始一个作业, 并在本处理器上预留带宽
+         *
+         * 须先经 admit 检查, 且 unit 不在运行队列中.
+         */
+        void attach(util::nonnull<RQ *> rq, util::nonnull<SUType *> unit,
+                    size_t runtime, size_t period, size_t deadline) {
+            auto entity           = as_entity_dl(unit);
+            rq->dl.total_bw      -= entity->bw;
+            entity->runtime       = runtime;
+            entity->period        = period;
+            entity->rel_deadline  = deadline;
+            entity->bw            = bandwidth(runtime, deadline);
+            entity->throttled     = false;
+            entity->start_job(rq->dl.clock);
+            rq->dl.total_bw      += entity->bw;
+        }
+
+        /**
+         * @brief 释放 unit 预留的带宽, 须保证 unit 不在运行队列中
+         */
+        void detach(util::nonnull<RQ *> rq, util::nonnull<SUType *> unit) {
+            auto entity        = as_entity_dl(unit);
+            rq->dl.total_bw   -= entity->bw;
+            entity->runtime    = 0;
+            entity->bw         = 0;
+            entity->throttled  = false;
+        }
+
+        /**
+         * @brief 推进本处理器的时钟, 为到达下一周期的节流实体补充预算
+         *
+         * 须在每个时钟中断调用一次, 无论当前线程属于哪个调度类.
+         *
+         * @param now 当前时间 (时钟中断数)
+         * @return 本次解除节流的实体中截止时间最早者, 没有时返回 nullptr
+         */
+        SUType *update_clock(util::nonnull<RQ *> rq, uint64_t now) {
+            rq->dl.clock     = now;
+            Entity *earliest = nullptr;
+            Entity *entity   = rq->dl.throttled.first();
+            while (entity != nullptr && entity->next_period <= now) {
+                remove(rq->dl, *entity);
+                entity->throttled = false;
+                entity->start_job(now);
+                insert(rq->dl, *entity);
+                if (earliest == nullptr ||
+                    entity->deadline < earliest->deadline)
+                {
+                    earliest = entity;
+                }
+                entity = rq->dl.throttled.first();
+            }
+            if (earliest == nullptr) {
+                return nullptr;
+            }
+            return asunit_dl(earliest);
+        }
+
+        Result<void> enqueue(util::nonnull<RQ *> rq,
+                             util::nonnull<SUType *> unit) override {
+            auto meta   = this->asmeta(unit);
+            auto entity = as_entity_dl(unit);
+            if (entity->queued) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            const uint64_t now = rq->dl.clock;
+            if (entity->throttled && entity->next_period <= now) {
+                entity->throttled = false;
+                entity->start_job(now);
+            }
+            // CBS 唤醒规则: 剩余预算在截止时间前按原带宽用不完时,
+            // 沿用旧的截止时间会使其挤占他人的带宽, 须开始新作业
+            if (!entity->throttled &&
+                (entity->deadline <= now ||
+                 entity->runtime_left * entity->rel_deadline >
+                     (entity->deadline - now) * entity->runtime))
+            {
+                entity->start_job(now);
+            }
+            meta->state = ThreadState::READY;
+            insert(rq->dl, *entity);
+            void_return();
+        }
+
+        Result<void> dequeue(util::nonnull<RQ *> rq,
+                             util::nonnull<SUType *> unit) override {
+            auto meta   = this->asmeta(unit);
+            auto entity = as_entity_dl(unit);
+            if (!entity->queued) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            remove(rq->dl, *entity);
+            meta->state = ThreadState::EMPTY;
+            void_return();
+        }
+
+        Result<util::nonnull<SUType *>> pick_next(
+            util::nonnull<RQ *> rq) override {
+            Entity *entity = rq->dl.ready.first();
+            if (entity == nullptr) {
+                unexpect_return(ErrCode::NO_RUNNABLE_THREAD);
+            }
+            remove(rq->dl, *entity);
+
+            auto unit      = asunit_dl(entity);
+            auto meta      = this->asmeta(unit);
+            meta->state    = ThreadState::RUNNING;
+            this->cursched = meta;
+            return unit;
+        }
+
+        Result<void> put_prev(util::nonnull<RQ *> rq,
+                              util::nonnull<SUType *> unit) override {
+            auto meta   = this->asmeta(unit);
+            meta->state = ThreadState::READY;
+            insert(rq->dl, *as_entity_dl(unit));
+            void_return();
+        }
+
+        /**
+         * @brief 主动让出 CPU 表示本周期的作业已完成
+         *
+         * 放弃剩余预算并节流至下一周期开始.
+         */
+        Result<void> yield(util::nonnull<RQ *> rq) override {
+            if (this->cursched != nullptr) {
+                auto meta   = util::nnullforce(this->cursched);
+                auto entity = as_entity_dl(this->asunit(meta));
+                entity->runtime_left = 0;
+                entity->throttled    = true;
+                meta->template flags_set<SchedMeta::FLAGS_NEED_RESCHED>();
+            }
+            void_return();
+        }
+
+        /**
+         * @brief 每个tick调用一次, 用于更新调度单元的状态
+         *
+         * 扣减当前实体的预算并检查其是否错过截止时间;
+         * 预算用尽时将其节流并添加 NEED_RESCHED 标志.
+         *
+         * @param rq
+         * @param unit
+         * @return Result<void>
+         */
+        Result<void> on_tick(util::nonnull<RQ *> rq,
+                             util::nonnull<SUType *> unit) override {
+            auto entity = as_entity_dl(unit);
+            if (entity->runtime_left > 0) {
+                entity->runtime_left--;
+            }
+            check_miss(rq->dl, *entity);
+            if (entity->runtime_left == 0) {
+                entity->throttled = true;
+                this->asmeta(unit)
+                    ->template flags_set<SchedMeta::FLAGS_NEED_RESCHED>();
+            }
+            void_return();
+        }
+
+        bool check_preempt_curr(util::nonnull<RQ *> rq,
+                                util::nonnull<SUType *> new_su) override {
+            // 只要对方的级别比自己高, 就需要抢占当前任务
+            return true;
+        }
+
+        bool check_preempt_wakeup(util::nonnull<RQ *> rq,
+                                  util::nonnull<SUType *> curr,
+                                  util::nonnull<SUType *> new_su) override {
+            return as_entity_dl(new_su)->deadline <
+                   as_entity_dl(curr)->deadline;
+        }
+    };
+}  // namespace schd::dl
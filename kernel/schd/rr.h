@@ -20,6 +20,10 @@
 namespace schd::rr {
     struct Entity {
         int slice_cnt = 0;
+        // 静态优先级, 取值范围为 [0, NR_PRIOS)
+        size_t prio   = DEFAULT_PRIO;
+        // 是否位于运行队列中
+        bool queued   = false;
     };
 
     template <typename SU>
@@ -39,36 +43,94 @@ namespace schd::rr {
             return as_entity_rr(this->asunit(meta));
         }
 
+        void insert(RunQueue &rr_rq, SchedMeta &meta, Entity &entity) {
+            rr_rq.lists[entity.prio].push_back(meta);
+            rr_rq.bitmap |= 1u << entity.prio;
+            rr_rq.nr++;
+            entity.queued = true;
+        }
+
+        // 由节点自身的链接直接摘除, 无需遍历队列
+        void remove(RunQueue &rr_rq, SchedMeta &meta, Entity &entity) {
+            PrioList &list = rr_rq.lists[entity.prio];
+            list.erase(PrioList::iterator(&meta));
+            if (list.empty()) {
+                rr_rq.bitmap &= ~(1u << entity.prio);
+            }
+            rr_rq.nr--;
+            entity.queued = false;
+        }
+
     public:
+        /**
+         * @brief 最高非空优先级队尾的调度单元
+         *
+         * 它是同级中离被调度最远的, 适合迁移到其它处理器.
+         */
+        SUType *last(util::nonnull<RQ *> rq) {
+            if (rq->rr.nr == 0) {
+                return nullptr;
+            }
+            SchedMeta &meta = rq->rr.lists[rq->rr.top_prio()].back();
+            return this->asunit(meta);
+        }
+
+        /**
+         * @brief 修改调度单元的静态优先级
+         *
+         * 在队列中的调度单元移到新优先级的队尾.
+         */
+        Result<void> set_prio(util::nonnull<RQ *> rq,
+                              util::nonnull<SUType *> unit, size_t prio) {
+            if (prio >= NR_PRIOS) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            auto meta   = this->asmeta(unit);
+            auto entity = as_entity_rr(unit);
+            if (!entity->queued) {
+                entity->prio = prio;
+                void_return();
+            }
+            remove(rq->rr, *meta, *entity);
+            entity->prio = prio;
+            insert(rq->rr, *meta, *entity);
+            void_return();
+        }
+
         Result<void> enqueue(util::nonnull<RQ *> rq,
                              util::nonnull<SUType *> unit) override {
             auto meta   = this->asmeta(unit);
+            auto entity = as_entity_rr(unit);
+            if (entity->queued) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
             meta->state = ThreadState::READY;
-            rq->rr_list.push_back(*meta);
+            insert(rq->rr, *meta, *entity);
             void_return();
         }
 
         Result<void> dequeue(util::nonnull<RQ *> rq,
                              util::nonnull<SUType *> unit) override {
-            auto meta = this->asmeta(unit);
-            if (!rq->rr_list.contains(*meta)) {
+            auto meta   = this->asmeta(unit);
+            auto entity = as_entity_rr(unit);
+            if (!entity->queued) {
                 unexpect_return(ErrCode::INVALID_PARAM);
             }
-            rq->rr_list.remove(*meta);
+            remove(rq->rr, *meta, *entity);
             meta->state = ThreadState::EMPTY;
             void_return();
         }
 
         Result<util::nonnull<SUType *>> pick_next(util::nonnull<RQ *> rq) override {
-            if (rq->rr_list.empty())
+            if (rq->rr.nr == 0)
                 unexpect_return(ErrCode::NO_RUNNABLE_THREAD);
-            // fetch the first task in the queue
-            SchedMeta &meta = rq->rr_list.front();
-            meta.state      = ThreadState::RUNNING;
-            auto entity    = as_entity_rr(meta);
+            // fetch the first task in the highest non-empty queue
+            SchedMeta &meta   = rq->rr.lists[rq->rr.top_prio()].front();
+            auto entity       = as_entity_rr(meta);
+            remove(rq->rr, meta, *entity);
+            meta.state        = ThreadState::RUNNING;
             entity->slice_cnt = TIME_SLICES;
-            rq->rr_list.pop_front();
-            this->cursched = &meta;
+            this->cursched    = &meta;
             return this->asunit(meta);
         }
 
@@ -76,7 +138,7 @@ namespace schd::rr {
                               util::nonnull<SUType *> unit) override {
             auto meta   = this->asmeta(unit);
             meta->state = ThreadState::READY;
-            rq->rr_list.push_back(*meta);
+            insert(rq->rr, *meta, *as_entity_rr(unit));
             void_return();
         }
 
@@ -116,5 +178,12 @@ namespace schd::rr {
             // 只要对方的级别比自己高, 就需要抢占当前任务
             return true;
         }
+
+        bool check_preempt_wakeup(util::nonnull<RQ *> rq,
+                                  util::nonnull<SUType *> curr,
+                                  util::nonnull<SUType *> new_su) override {
+            // 同一调度类中, 优先级更高的线程就绪时立即抢占
+            return as_entity_rr(new_su)->prio > as_entity_rr(curr)->prio;
+        }
     };
 }  // namespace schd::rr
@@ -13,10 +13,12 @@
 
 #include <sus/list.h>
 #include <sus/nonnull.h>
+#include <sus/tree.h>
 #include <sus/types.h>
 #include <sustcore/errcode.h>
 
 #include <concepts>
+#include <cstdint>
 
 enum class ThreadState {
     EMPTY          = 0,
@@ -43,11 +45,20 @@ namespace schd {
     // BOT is the lowest priority, served as the minimum of the class type
     // however, there is no actual BOT class, it's just a placeholder for the
     // end of the class type range
-    enum class ClassType { BOT = 0, IDLE = 1, FCFS = 2, RR = 3 };
+    enum class ClassType {
+        BOT  = 0,
+        IDLE = 1,
+        FCFS = 2,
+        CFS  = 3,
+        RR   = 4,
+        DL   = 5
+    };
 
     constexpr const char *to_cstring(ClassType type) {
         switch (type) {
+            case ClassType::DL:   return "DL";
             case ClassType::RR:   return "RR";
+            case ClassType::CFS:  return "CFS";
             case ClassType::FCFS: return "FCFS";
             case ClassType::IDLE: return "IDLE";
             case ClassType::BOT:  return "BOT";
@@ -96,9 +107,194 @@ namespace schd {
         }
     };
 
+    namespace rr {
+        // 静态优先级的级数, 数值越大优先级越高
+        constexpr size_t NR_PRIOS     = 32;
+        constexpr size_t DEFAULT_PRIO = 0;
+
+        using PrioList = util::IntrusiveList<SchedMeta, &SchedMeta::rq_head>;
+
+        /**
+         * @brief 按优先级分级的就绪队列
+         *
+         * 每个优先级一个链表, bitmap 的第 i 位表示第 i 级非空,
+         * 取最高优先级只需一次前导零计数.
+         */
+        struct RunQueue {
+            PrioList lists[NR_PRIOS];
+            uint32_t bitmap = 0;
+            size_t nr       = 0;
+
+            static_assert(NR_PRIOS <= sizeof(bitmap) * 8);
+
+            // 最高的非空优先级, 须保证 nr > 0
+            [[nodiscard]]
+            size_t top_prio() const {
+                return sizeof(bitmap) * 8 - 1 - __builtin_clz(bitmap);
+            }
+        };
+    }  // namespace rr
+
+    namespace cfs {
+        constexpr int MIN_NICE           = -20;
+        constexpr int MAX_NICE           = 19;
+        constexpr uint32_t NICE_0_WEIGHT = 1024;
+
+        // nice 每差 1, 权重约差 1.25 倍, 即 CPU 份额约差 10%
+        constexpr uint32_t NICE_TO_WEIGHT[MAX_NICE - MIN_NICE + 1] = {
+            88761, 71755, 56483, 46273, 36291, 29154, 23254, 18705,
+            14949, 11916, 9548,  7620,  6100,  4904,  3906,  3121,
+            2501,  1991,  1586,  1277,  1024,  820,   655,   526,
+            423,   335,   272,   215,   172,   137,   110,   87,
+            70,    56,    45,    36,    29,    23,    18,    15,
+        };
+
+        constexpr uint32_t weight_of(int nice) {
+            return NICE_TO_WEIGHT[nice - MIN_NICE];
+        }
+
+        /**
+         * @brief CFS 调度实体
+         *
+         * 实体按加权虚拟运行时间排序, 权重越大, 运行相同时间增加的
+         * 虚拟运行时间越少, 从而获得越多的 CPU 份额.
+         */
+        struct Entity {
+            util::rbtree::RBNode<Entity> rb_node = {};
+            uint64_t vruntime                    = 0;
+            int nice                             = 0;
+            uint32_t weight                      = NICE_0_WEIGHT;
+            // 本次被选中后已运行的时钟中断数
+            size_t slice_ticks = 0;
+            // 是否位于运行队列的红黑树中
+            bool queued        = false;
+
+            struct Order {
+                bool operator()(const Entity &lhs, const Entity &rhs) const {
+                    return lhs.vruntime < rhs.vruntime;
+                }
+            };
+
+            constexpr void set_nice(int new_nice) {
+                nice   = new_nice;
+                weight = weight_of(new_nice);
+            }
+        };
+
+        using Timeline =
+            util::rbtree::RBTree<Entity, &Entity::rb_node, Entity::Order>;
+
+        struct RunQueue {
+            // 就绪实体, 最左侧为虚拟运行时间最小者
+            Timeline timeline;
+            // 单调不减的虚拟时间基准, 入队的实体以此定位
+            uint64_t min_vruntime = 0;
+            // 树中实体的权重之和
+            uint64_t load_weight  = 0;
+        };
+    }  // namespace cfs
+
+    namespace dl {
+        // 带宽的定点小数位数, 1 << BW_SHIFT 表示独占一个处理器
+        constexpr size_t BW_SHIFT  = 20;
+        constexpr uint64_t BW_UNIT = 1ull << BW_SHIFT;
+        // 单个处理器上可分配给 DL 线程的带宽上限 (95%),
+        // 余下部分留给低级别的调度类, 避免其被完全饿死
+        constexpr uint64_t MAX_BW = BW_UNIT * 95 / 100;
+
+        /**
+         * @brief 运行时间与相对截止时间之比 (定点小数)
+         *
+         * 截止时间短于周期时以截止时间计算, 使准入检查偏于保守.
+         */
+        constexpr uint64_t bandwidth(size_t runtime, size_t deadline) {
+            return (static_cast<uint64_t>(runtime) << BW_SHIFT) / deadline;
+        }
+
+        /**
+         * @brief DL 调度实体
+         *
+         * 时间均以时钟中断为单位. 实体每个周期至多运行 runtime,
+         * 并须在周期开始后的 rel_deadline 内完成; 预算用尽后被节流,
+         * 直至下一周期开始时补充.
+         */
+        struct Entity {
+            util::rbtree::RBNode<Entity> rb_node = {};
+            // 参数
+            size_t runtime      = 0;
+            size_t period       = 0;
+            size_t rel_deadline = 0;
+            uint64_t bw         = 0;
+            // 当前作业剩余的预算与绝对截止时间
+            size_t runtime_left = 0;
+            uint64_t deadline   = 0;
+            // 下一周期的开始时间, 节流的实体于此时补充预算
+            uint64_t next_period = 0;
+            // 是否位于运行队列 (就绪树或节流树) 中
+            bool queued    = false;
+            bool throttled = false;
+            // 当前作业是否已记为错过截止时间, 每个作业至多记一次
+            bool missed    = false;
+            // 累计错过截止时间的作业数
+            size_t misses = 0;
+            // 退出 DL 时恢复的调度类
+            ClassType fallback = ClassType::RR;
+
+            // 就绪实体按绝对截止时间排序
+            struct DeadlineOrder {
+                bool operator()(const Entity &lhs, const Entity &rhs) const {
+                    return lhs.deadline < rhs.deadline;
+                }
+            };
+
+            // 节流实体按补充时间排序
+            struct ReplenishOrder {
+                bool operator()(const Entity &lhs, const Entity &rhs) const {
+                    return lhs.next_period < rhs.next_period;
+                }
+            };
+
+            // 从 now 开始一个新作业
+            constexpr void start_job(uint64_t now) {
+                runtime_left = runtime;
+                deadline     = now + rel_deadline;
+                next_period  = now + period;
+                missed       = false;
+            }
+        };
+
+        using ReadyTree = util::rbtree::RBTree<Entity, &Entity::rb_node,
+                                               Entity::DeadlineOrder>;
+        using ThrottledTree =
+            util::rbtree::RBTree<Entity, &Entity::rb_node,
+                                 Entity::ReplenishOrder>;
+
+        struct RunQueue {
+            // 就绪实体, 最左侧为截止时间最早者
+            ReadyTree ready;
+            // 预算用尽等待补充的实体, 最左侧为最早补充者
+            ThrottledTree throttled;
+            // 当前时间 (时钟中断数), 各处理器取自同一硬件时钟
+            uint64_t clock    = 0;
+            // 归属本处理器的 DL 线程 (含阻塞中的) 的带宽之和
+            uint64_t total_bw = 0;
+            // 本处理器上累计错过截止时间的作业数
+            size_t nr_missed  = 0;
+        };
+    }  // namespace dl
+
     struct RQ {
         util::IntrusiveList<SchedMeta, &SchedMeta::rq_head> fcfs_list;
-        util::IntrusiveList<SchedMeta, &SchedMeta::rq_head> rr_list;
+        rr::RunQueue rr;
+        cfs::RunQueue cfs;
+        dl::RunQueue dl;
+
+        // 各调度类中就绪线程的总数, 节流中的 DL 线程不可运行, 不计入
+        [[nodiscard]]
+        size_t nr_queued() const {
+            return fcfs_list.size() + rr.nr + cfs.timeline.size() +
+                   dl.ready.size();
+        }
     };
 
     template <typename SU>
@@ -188,6 +384,21 @@ namespace schd {
          */
         virtual bool check_preempt_curr(util::nonnull<RQ *> rq,
                                         util::nonnull<SUType *> new_su) = 0;
+
+        /**
+         * @brief 判断同一调度类中新就绪的 new_su 是否要抢占正在运行的 curr
+         *
+         * 默认不抢占, 新线程排队等待 curr 的时间片用尽或主动让出.
+         *
+         * @param rq 调度器的就绪队列
+         * @param curr 当前正在运行的调度单元
+         * @param new_su 新就绪的调度单元
+         */
+        virtual bool check_preempt_wakeup(util::nonnull<RQ *> rq,
+                                          util::nonnull<SUType *> curr,
+                                          util::nonnull<SUType *> new_su) {
+            return false;
+        }
     };
 
     template <template <typename> class SchdPolicy, typename SU>
@@ -0,0 +1,75 @@
+/**
+ * @file spinlock.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief 自旋锁与内核大锁
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cpu.h>
+
+#include <cassert>
+#include <cstddef>
+
+namespace sync {
+    /**
+     * @brief 可重入的自旋锁
+     *
+     * 记录持有者的逻辑处理器编号, 同一处理器可重复获取,
+     * 须以相同次数释放.
+     */
+    class RecursiveSpinLock {
+    private:
+        static constexpr size_t NO_OWNER = ~static_cast<size_t>(0);
+
+        bool _locked  = false;
+        size_t _owner = NO_OWNER;
+        size_t _depth = 0;
+
+    public:
+        constexpr RecursiveSpinLock() = default;
+
+        void lock() {
+            const size_t self = cpu::current();
+            if (__atomic_load_n(&_owner, __ATOMIC_RELAXED) == self) {
+                _depth++;
+                return;
+            }
+            while (__atomic_exchange_n(&_locked, true, __ATOMIC_ACQUIRE)) {
+                while (__atomic_load_n(&_locked, __ATOMIC_RELAXED));
+            }
+            __atomic_store_n(&_owner, self, __ATOMIC_RELAXED);
+            _depth = 1;
+        }
+
+        void unlock() {
+            assert(held());
+            if (--_depth > 0) {
+                return;
+            }
+            __atomic_store_n(&_owner, NO_OWNER, __ATOMIC_RELAXED);
+            __atomic_store_n(&_locked, false, __ATOMIC_RELEASE);
+        }
+
+        [[nodiscard]]
+        bool held() const {
+            return __atomic_load_n(&_owner, __ATOMIC_RELAXED) ==
+                   cpu::current();
+        }
+    };
+
+    /**
+     * @brief 内核大锁
+     *
+     * 内核中的共享数据 (分配器, 任务表, 等待队列等) 尚未细粒度加锁,
+     * 各处理器执行内核代码前须持有此锁: 陷入处理在 handle_trap 中获取,
+     * 返回用户态时由 trap.S 在切换到下一个线程的内核栈之后释放;
+     * 启动阶段由引导核持有, 直至其首次进入用户态.
+     */
+    inline RecursiveSpinLock kernel_lock;
+}  // namespace sync
@@ -29,8 +29,6 @@ namespace syscall {
         sys_write_serial(str.kbuf(), len);
     }
 
-    constexpr size_t MAX_SYSCALL_PATH = 256;
-
     const char *name_of(b64 sysno) {
         switch (sysno) {
             case SYS_WRITE_SERIAL:        return "SYS_WRITE_SERIAL";
@@ -65,6 +63,10 @@ namespace syscall {
             case SYS_MEM_UNMAP:           return "SYS_MEM_UNMAP";
             case SYS_MEM_RESIZE:          return "SYS_MEM_RESIZE";
             case SYS_MEM_QUERY:           return "SYS_MEM_QUERY";
+            case SYS_SPAWN:               return "SYS_SPAWN";
+            case SYS_TCB_SET_NICE:        return "SYS_TCB_SET_NICE";
+            case SYS_TCB_SET_PRIORITY:    return "SYS_TCB_SET_PRIORITY";
+            case SYS_TCB_SET_DEADLINE:    return "SYS_TCB_SET_DEADLINE";
             default:                      return "UNKNOWN_SYSCALL";
         }
     }
@@ -111,6 +113,11 @@ namespace syscall {
                 ret1 = 0;
                 break;
             }
+            case SYS_SPAWN: {
+                ret0 = pcb_spawn(capidx, VirAddr(arg0));
+                ret1 = 0;
+                break;
+            }
             case SYS_CREATE_THREAD: {
                 ret0 = pcb_create_thread(capidx, VirAddr(arg0), VirAddr(arg1),
                                          arg2);
@@ -153,6 +160,21 @@ namespace syscall {
                 ret1 = 0;
                 break;
             }
+            case SYS_TCB_SET_NICE: {
+                ret0 = tcb_set_nice(capidx, static_cast<int>(arg0));
+                ret1 = 0;
+                break;
+            }
+            case SYS_TCB_SET_PRIORITY: {
+                ret0 = tcb_set_priority(capidx, arg0);
+                ret1 = 0;
+                break;
+            }
+            case SYS_TCB_SET_DEADLINE: {
+                ret0 = tcb_set_deadline(capidx, arg0, arg1, arg2);
+                ret1 = 0;
+                break;
+            }
 
             // Notification object operations.
             case SYS_NOTIF_WAIT: {
@@ -46,6 +46,23 @@ namespace syscall {
         return pcb;
     }
 
+    /**
+     * @brief 查找当前进程 capability 空间中的 TCB payload.
+     */
+    static Result<cap::TCBPayload *> lookup_tcb(CapIdx idx,
+                                                cap::Capability **out_cap) {
+        auto cap_res = cap::CHolder::lookup(idx);
+        propagate(cap_res);
+        if (out_cap != nullptr) {
+            *out_cap = cap_res.value();
+        }
+        auto *tcb = cap_res.value()->payload_as<cap::TCBPayload>();
+        if (tcb == nullptr || tcb->tcb == nullptr) {
+            unexpect_return(ErrCode::TYPE_NOT_MATCHED);
+        }
+        return tcb;
+    }
+
     /**
      * @brief 查找当前进程 capability 空间中的 Memory payload.
      */
@@ -64,10 +81,56 @@ namespace syscall {
     }
 
     /**
-     * @brief 将父进程指定 capability 按相同 CapIdx 复制到子 CHolder.
+     * @brief 将父进程 src 处的 capability 复制到子 CHolder 的 dst 处.
      *
      * 该函数只处理 capability transfer 的 CLONE 语义; 对象自身权限检查
-     * 仍由对应 CapObj 方法完成.
+     * 仍由对应 CapObj 方法完成. perm 非 0 时子进程获得降级后的权限.
+     */
+    static Result<void> transfer_cap(cap::CHolder *src_holder,
+                                     TaskMemoryManager *src_tmm,
+                                     cap::CHolder *dst_holder, CapIdx src,
+                                     CapIdx dst, b64 perm) {
+        auto src_res = src_holder->internal_lookup(src);
+        propagate(src_res);
+        cap::Capability *src_cap = src_res.value();
+        if (!src_cap->imply(perm::basic::CLONE)) {
+            unexpect_return(ErrCode::INSUFFICIENT_PERMISSIONS);
+        }
+        b64 dst_perm = src_cap->perm();
+        if (perm != 0) {
+            if (!src_cap->imply(perm)) {
+                unexpect_return(ErrCode::INSUFFICIENT_PERMISSIONS);
+            }
+            dst_perm = perm;
+        }
+
+        cap::Payload *src_payload = src_cap->payload();
+        cap::Payload *payload     = src_payload->clone_payload();
+        if (payload == nullptr) {
+            unexpect_return(ErrCode::OUT_OF_MEMORY);
+        }
+        auto insert_res = dst_holder->internal_insert(dst, payload, dst_perm);
+        if (!insert_res.has_value()) {
+            if (payload != src_payload) {
+                payload->destruct();
+            }
+            propagate_return(insert_res);
+        }
+
+        auto *memory = src_cap->payload_as<cap::MemoryPayload>();
+        if (memory != nullptr && !memory->shared && src_tmm != nullptr) {
+            auto cow_res = src_tmm->protect_memory_cow(memory);
+            if (!cow_res.has_value()) {
+                auto remove_res = dst_holder->internal_remove(dst);
+                assert(remove_res.has_value());
+                propagate_return(cow_res);
+            }
+        }
+        void_return();
+    }
+
+    /**
+     * @brief 将父进程指定 capability 按相同 CapIdx 复制到子 CHolder.
      */
     static Result<void> copy_initial_caps_in_place(cap::CHolder *src_holder,
                                                    TaskMemoryManager *src_tmm,
@@ -85,41 +148,28 @@ namespace syscall {
         caps_buf.sync_from_user();
         auto *caps = reinterpret_cast<CapIdx *>(caps_buf.kbuf());
         for (size_t i = 0; i < caps_sz; ++i) {
-            CapIdx idx   = caps[i];
-            auto src_res = src_holder->internal_lookup(idx);
-            propagate(src_res);
-            cap::Capability *src_cap = src_res.value();
-            if (!src_cap->imply(perm::basic::CLONE)) {
-                unexpect_return(ErrCode::INSUFFICIENT_PERMISSIONS);
-            }
-
-            cap::Payload *src_payload = src_cap->payload();
-            cap::Payload *payload     = src_payload->clone_payload();
-            auto insert_res =
-                dst_holder->internal_insert(idx, payload, src_cap->perm());
-            if (!insert_res.has_value()) {
-                if (payload != src_payload) {
-                    payload->destruct();
-                }
-                propagate_return(insert_res);
-            }
-
-            auto *memory = src_cap->payload_as<cap::MemoryPayload>();
-            if (memory != nullptr && !memory->shared && src_tmm != nullptr) {
-                auto cow_res = src_tmm->protect_memory_cow(memory);
-                if (!cow_res.has_value()) {
-                    auto remove_res = dst_holder->internal_remove(idx);
-                    assert(remove_res.has_value());
-                    propagate_return(cow_res);
-                }
-            }
+            auto transfer_res = transfer_cap(src_holder, src_tmm, dst_holder,
+                                             caps[i], caps[i], 0);
+            propagate(transfer_res);
         }
         void_return();
     }
 
+    /**
+     * @brief 将新进程的 PCB capability 放入调用者 CSpace 的空闲槽.
+     */
+    static Result<CapIdx> return_child_pcb(cap::CHolder *holder,
+                                           task::PCB *pcb) {
+        auto child_cap_res = pcb->cholder->internal_lookup(pcb->pcb_cap);
+        propagate(child_cap_res);
+        return holder->internal_insert_to_free(
+            child_cap_res.value()->payload(), child_cap_res.value()->perm());
+    }
+
     static Result<schd::ClassType> parse_user_sched_class(size_t value) {
         switch (static_cast<schd::ClassType>(value)) {
             case schd::ClassType::RR:
+            case schd::ClassType::CFS:
             case schd::ClassType::FCFS:
             case schd::ClassType::IDLE:
                 return static_cast<schd::ClassType>(value);
@@ -209,18 +259,9 @@ namespace syscall {
             }
         });
 
-        auto pcb               = load_res.value();
-        auto child_pcb_cap_res = pcb->cholder->internal_lookup(pcb->pcb_cap);
-        if (!child_pcb_cap_res.has_value()) {
-            loggers::SYSCALL::ERROR("创建进程失败: 子进程PCB能力不可用 err=%d",
-                                    child_pcb_cap_res.error());
-            return cap::error;
-        }
-
         // 4) 返回子进程 PCB 能力给调用方
-        auto ret_insert_res = current_holder->internal_insert_to_free(
-            child_pcb_cap_res.value()->payload(),
-            child_pcb_cap_res.value()->perm());
+        auto pcb            = load_res.value();
+        auto ret_insert_res = return_child_pcb(current_holder, pcb);
         if (!ret_insert_res.has_value()) {
             loggers::SYSCALL::ERROR("创建进程失败: 返回PCB能力插入失败 err=%d",
                                     ret_insert_res.error());
@@ -233,6 +274,121 @@ namespace syscall {
         return ret_insert_res.value();
     }
 
+    CapIdx pcb_spawn(CapIdx pcb_cap, VirAddr args_uaddr) {
+        cap::Capability *pcb_cap_obj = nullptr;
+        auto pcb_res                 = lookup_pcb(pcb_cap, &pcb_cap_obj);
+        if (!pcb_res.has_value()) {
+            loggers::SYSCALL::ERROR("spawn失败: PCB lookup失败 err=%d",
+                                    pcb_res.error());
+            return cap::error;
+        }
+        cap::PCBObject pcb_obj(util::nnullforce(pcb_cap_obj));
+        auto parent_res = pcb_obj.require_new_process_execute();
+        if (!parent_res.has_value()) {
+            loggers::SYSCALL::ERROR("spawn失败: 权限不足 err=%d",
+                                    parent_res.error());
+            return cap::error;
+        }
+        task::PCB *parent_pcb = parent_res.value();
+        if (parent_pcb->cholder == nullptr || parent_pcb->tmm == nullptr) {
+            loggers::SYSCALL::ERROR("spawn失败: 父PCB状态无效");
+            return cap::error;
+        }
+        auto current_holder_res = cap::CHolder::current();
+        if (!current_holder_res.has_value()) {
+            loggers::SYSCALL::ERROR("spawn失败: 当前CSpace不可用");
+            return cap::error;
+        }
+
+        // 1) 复制参数描述符及其引用的数组
+        UBuffer args_buf(args_uaddr, sizeof(SpawnArgs));
+        args_buf.sync_from_user();
+        SpawnArgs args = *reinterpret_cast<SpawnArgs *>(args_buf.kbuf());
+        if (args.caps_sz > MAX_SPAWN_CAPS || args.maps_sz > MAX_SPAWN_MAPS) {
+            loggers::SYSCALL::ERROR("spawn失败: caps_sz=%u maps_sz=%u 超出上限",
+                                    args.caps_sz, args.maps_sz);
+            return cap::error;
+        }
+        auto sched_res = parse_user_sched_class(args.sched_class);
+        if (!sched_res.has_value()) {
+            loggers::SYSCALL::ERROR("spawn失败: 无效调度类=%u",
+                                    args.sched_class);
+            return cap::error;
+        }
+        UString path(VirAddr(reinterpret_cast<addr_t>(args.path)),
+                     MAX_SYSCALL_PATH);
+        UBuffer caps_buf(VirAddr(reinterpret_cast<addr_t>(args.caps)),
+                         args.caps_sz * sizeof(SpawnCap));
+        UBuffer maps_buf(VirAddr(reinterpret_cast<addr_t>(args.maps)),
+                         args.maps_sz * sizeof(SpawnMap));
+        if (args.caps_sz != 0) {
+            caps_buf.sync_from_user();
+        }
+        if (args.maps_sz != 0) {
+            maps_buf.sync_from_user();
+        }
+        auto *caps = reinterpret_cast<const SpawnCap *>(caps_buf.kbuf());
+        auto *maps = reinterpret_cast<const SpawnMap *>(maps_buf.kbuf());
+
+        // 2) 构造子进程 CSpace 并传递 capability
+        auto child_holder_res = cap::CHolderManager::inst().create_holder();
+        if (!child_holder_res.has_value()) {
+            loggers::SYSCALL::ERROR("spawn失败: 创建子CHolder失败 err=%d",
+                                    child_holder_res.error());
+            return cap::error;
+        }
+        cap::CHolder *child_holder = child_holder_res.value();
+        auto holder_guard          = util::Guard([child_holder]() {
+            auto rm_res =
+                cap::CHolderManager::inst().remove_holder(child_holder->id());
+            assert(rm_res.has_value());
+        });
+        for (size_t i = 0; i < args.caps_sz; ++i) {
+            auto transfer_res =
+                transfer_cap(parent_pcb->cholder, parent_pcb->tmm.get(),
+                             child_holder, caps[i].src, caps[i].dst,
+                             caps[i].perm);
+            if (!transfer_res.has_value()) {
+                loggers::SYSCALL::ERROR("spawn失败: 传递能力 %p -> %p 失败 "
+                                        "err=%d",
+                                        caps[i].src, caps[i].dst,
+                                        transfer_res.error());
+                return cap::error;
+            }
+        }
+
+        // 3) 加载 ELF, 映射 Memory 并启动子进程
+        task::SpawnMapping mappings[MAX_SPAWN_MAPS];
+        for (size_t i = 0; i < args.maps_sz; ++i) {
+            mappings[i] = task::SpawnMapping{
+                maps[i].memory, VirAddr(maps[i].vaddr),
+                static_cast<PageMan::RWX>(maps[i].rwx),
+                static_cast<cap::MemoryGrowth>(maps[i].growth)};
+        }
+        auto spawn_res = task::TaskManager::inst().spawn(task::SpawnSpec{
+            path.kbuf(), child_holder, sched_res.value(), mappings,
+            args.maps_sz});
+        if (!spawn_res.has_value()) {
+            loggers::SYSCALL::ERROR("spawn失败: path=%s, 错误码: %s",
+                                    path.kbuf(),
+                                    to_cstring(spawn_res.error()));
+            return cap::error;
+        }
+        holder_guard.release();
+
+        // 4) 返回子进程 PCB 能力给调用方
+        auto ret_res =
+            return_child_pcb(current_holder_res.value(), spawn_res.value());
+        if (!ret_res.has_value()) {
+            loggers::SYSCALL::ERROR("spawn失败: 返回PCB能力插入失败 err=%d",
+                                    ret_res.error());
+            return cap::error;
+        }
+        loggers::SYSCALL::DEBUG("spawn成功: path=%s, pid=%d", path.kbuf(),
+                                spawn_res.value()->pid);
+        return ret_res.value();
+    }
+
     CapIdx pcb_create_thread(CapIdx pcb_cap, VirAddr entry, VirAddr stack_addr,
                              size_t stack_size) {
         cap::Capability *cap = nullptr;
@@ -392,4 +548,59 @@ namespace syscall {
         }
         return pid_res.value();
     }
+
+    bool tcb_set_nice(CapIdx tcb_cap, int nice) {
+        cap::Capability *cap = nullptr;
+        auto tcb_res         = lookup_tcb(tcb_cap, &cap);
+        if (!tcb_res.has_value()) {
+            loggers::SYSCALL::ERROR("tcb_set_nice lookup失败: err=%d",
+                                    tcb_res.error());
+            return false;
+        }
+        cap::TCBObject obj(util::nnullforce(cap));
+        auto nice_res = obj.set_nice(nice);
+        if (!nice_res.has_value()) {
+            loggers::SYSCALL::ERROR("tcb_set_nice失败: err=%d",
+                                    nice_res.error());
+            return false;
+        }
+        return true;
+    }
+
+    bool tcb_set_priority(CapIdx tcb_cap, size_t prio) {
+        cap::Capability *cap = nullptr;
+        auto tcb_res         = lookup_tcb(tcb_cap, &cap);
+        if (!tcb_res.has_value()) {
+            loggers::SYSCALL::ERROR("tcb_set_priority lookup失败: err=%d",
+                                    tcb_res.error());
+            return false;
+        }
+        cap::TCBObject obj(util::nnullforce(cap));
+        auto prio_res = obj.set_priority(prio);
+        if (!prio_res.has_value()) {
+            loggers::SYSCALL::ERROR("tcb_set_priority失败: err=%d",
+                                    prio_res.error());
+            return false;
+        }
+        return true;
+    }
+
+    bool tcb_set_deadline(CapIdx tcb_cap, size_t runtime, size_t period,
+                          size_t deadline) {
+        cap::Capability *cap = nullptr;
+        auto tcb_res         = lookup_tcb(tcb_cap, &cap);
+        if (!tcb_res.has_value()) {
+            loggers::SYSCALL::ERROR("tcb_set_deadline lookup失败: err=%d",
+                                    tcb_res.error());
+            return false;
+        }
+        cap::TCBObject obj(util::nnullforce(cap));
+        auto dl_res = obj.set_deadline(runtime, period, deadline);
+        if (!dl_res.has_value()) {
+            loggers::SYSCALL::ERROR("tcb_set_deadline失败: err=%d",
+                                    dl_res.error());
+            return false;
+        }
+        return true;
+    }
 }  // namespace syscall
@@ -29,6 +29,17 @@ namespace syscall {
     CapIdx pcb_create_process(CapIdx pcb_cap, const UString &path,
                               VirAddr caps_uaddr, size_t caps_sz,
                               size_t sched_class);
+    /**
+     * @brief 直接创建并启动新进程, 不复制调用者的地址空间.
+     *
+     * 按 SpawnArgs 传递 capability、预先映射 Memory 并加载 ELF,
+     * 整个过程在一次系统调用中完成.
+     *
+     * @param pcb_cap 调用者 PCB capability, 须具有创建与执行进程的权限.
+     * @param args_uaddr 用户态 SpawnArgs 的地址.
+     * @return 子进程 PCB capability; 失败返回 cap::error.
+     */
+    CapIdx pcb_spawn(CapIdx pcb_cap, VirAddr args_uaddr);
     CapIdx pcb_create_thread(CapIdx pcb_cap, VirAddr entry, VirAddr stack_addr,
                              size_t stack_size);
     ForkRet pcb_fork(CapIdx pcb_cap);
@@ -60,4 +71,35 @@ namespace syscall {
                     VirAddr reserved_uaddr, size_t reserved_sz);
     bool pcb_is_current(CapIdx pcb_cap);
     size_t get_pid(CapIdx pcb_cap);
+    /**
+     * @brief 通过 TCB Capability 设置线程的 nice 值. 
+     *
+     * syscall 层只 lookup TCB capability; SETSCHED 权限检查由 TCBObject 完成. 
+     *
+     * @param tcb_cap TCB capability. 
+     * @param nice nice 值, 取值范围为 [-20, 19]. 
+     * @return true 成功; false 失败. 
+     */
+    bool tcb_set_nice(CapIdx tcb_cap, int nice);
+    /**
+     * @brief 通过 TCB Capability 设置线程的静态优先级. 
+     *
+     * @param tcb_cap TCB capability. 
+     * @param prio 优先级, 取值范围为 [0, 32). 
+     * @return true 成功; false 失败. 
+     */
+    bool tcb_set_priority(CapIdx tcb_cap, size_t prio);
+    /**
+     * @brief 通过 TCB Capability 设置线程的 DL 参数. 
+     *
+     * 参数以时钟中断为单位; runtime 为 0 时线程退出 DL 调度类. 
+     *
+     * @param tcb_cap TCB capability. 
+     * @param runtime 每周期的运行预算. 
+     * @param period 周期. 
+     * @param deadline 相对于周期开始的截止时间. 
+     * @return true 成功; false 参数非法, 准入失败或权限不足. 
+     */
+    bool tcb_set_deadline(CapIdx tcb_cap, size_t runtime, size_t period,
+                          size_t deadline);
 }  // namespace syscall
@@ -20,6 +20,9 @@
 #include <cstring>
 
 namespace syscall {
+    // 系统调用中路径参数的最大长度
+    constexpr size_t MAX_SYSCALL_PATH = 256;
+
     // 将用户空间中的数据读取到内核空间中
     class UBuffer {
     private:
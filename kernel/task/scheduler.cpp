@@ -11,8 +11,10 @@
 
 #include <arch/riscv64/description.h>
 #include <env.h>
+#include <mem/gfp.h>
 #include <mem/vma.h>
 #include <sus/nonnull.h>
+#include <sync/spinlock.h>
 #include <task/scheduler.h>
 #include <task/wait.h>
 
@@ -20,11 +22,14 @@
 #include <new>
 
 namespace {
-    alignas(schd::Scheduler) unsigned char scheduler_storage[sizeof(
-        schd::Scheduler)];
+    // 每个处理器各有一个调度器及其运行队列
+    struct SchedulerSlot {
+        alignas(schd::Scheduler) unsigned char storage[sizeof(
+            schd::Scheduler)];
+        schd::Scheduler *inst = nullptr;
+    };
     // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
-    schd::Scheduler *inst_scheduler = nullptr;
-    bool inst_scheduler_initialized = false;
+    cpu::PerCPU<SchedulerSlot> scheduler_slots;
 }  // namespace
 
 namespace key {
@@ -39,27 +44,39 @@ extern "C" [[noreturn]] void isr_restore_user(void *kstack_top);
 
 namespace schd {
     using namespace task;
-    void Scheduler::init(util::nonnull<TCB *> init_tcb) {
-        inst_scheduler = new (scheduler_storage) Scheduler(init_tcb);
-        inst_scheduler_initialized = true;
+    void Scheduler::init(util::nonnull<TCB *> idle_tcb) {
+        auto &slot    = scheduler_slots.local();
+        slot.inst     = new (slot.storage) Scheduler(cpu::current(), idle_tcb);
+        idle_tcb->cpu = cpu::current();
     }
 
     bool Scheduler::initialized() {
-        return inst_scheduler_initialized && inst_scheduler != nullptr;
+        return initialized(cpu::current());
+    }
+
+    bool Scheduler::initialized(size_t cpu) {
+        return scheduler_slots.of(cpu).inst != nullptr;
     }
 
     Scheduler &Scheduler::inst() {
-        if (!initialized()) {
+        return of(cpu::current());
+    }
+
+    Scheduler &Scheduler::of(size_t cpu) {
+        if (!initialized(cpu)) {
             panic("Scheduler 未初始化!");
         }
-        return *inst_scheduler;
+        return *scheduler_slots.of(cpu).inst;
     }
 
     void switch_pgd(TaskMemoryManager *tmm) {
-        // 只在页表不为null且不等于当前页表时才切换
-        if (tmm->pgd().nonnull() && tmm->pgd() != env::inst().pgd()) {
-            PageMan(tmm->pgd()).switch_root();
-            PageMan(tmm->pgd()).flush_tlb();
+        if (tmm == nullptr) {
+            // 空闲上下文不属于任何进程, 只使用内核页表
+            TaskMemoryManager::activate_kernel();
+        } else if (tmm->pgd().nonnull() && tmm->pgd() != env::inst().pgd()) {
+            // 只在页表不为null且不等于当前页表时才切换
+            // 地址空间以各自的 ASID 区分 TLB 项, 切换时无需刷新
+            tmm->activate();
         }
         // 更新 environment 中的 task memory
         env::inst().tmm(key::schd()) = tmm;
@@ -67,9 +84,165 @@ namespace schd {
 
     void Scheduler::switch_to(TCB *tcb) {
         // 切换页表
-        switch_pgd(tcb->task->tmm);
-        _curtcb = tcb;
-        _curpcb = tcb->task;
+        switch_pgd(tcb->task != nullptr ? tcb->task->tmm : nullptr);
+        _curtcb  = tcb;
+        _curpcb  = tcb->task;
+        tcb->cpu = _cpu;
+    }
+
+    size_t Scheduler::load() const {
+        size_t load = _rq.nr_queued();
+        if (_curtcb != nullptr && _curtcb->schd_class != ClassType::IDLE) {
+            load++;
+        }
+        return load;
+    }
+
+    size_t Scheduler::select_cpu() {
+        size_t best      = cpu::current();
+        size_t best_load = inst().load();
+        for (size_t cpu = 0; cpu < cpu::online(); cpu++) {
+            if (!initialized(cpu)) {
+                continue;
+            }
+            size_t load = of(cpu).load();
+            if (load < best_load) {
+                best      = cpu;
+                best_load = load;
+            }
+        }
+        return best;
+    }
+
+    bool Scheduler::idle_interrupted(const Context *ctx) {
+        TCB *idle = idle_schd()->idle_unit;
+        return _curtcb == idle && idle->context() == ctx;
+    }
+
+    void Scheduler::cpu_idle() {
+        // 经陷入返回进入, sstatus.SPIE 已置位, 此时中断已打开
+        while (true) {
+            // 持锁期间关中断, 以免带着内核大锁被切换出去
+            Interrupt::cli();
+            sync::kernel_lock.lock();
+            // 处理器空闲, 借机预先清零若干页, 供之后的缺页处理直接取用
+            size_t zeroed = GFP::zero_idle();
+            sync::kernel_lock.unlock();
+            // 页池已满时才等待; 关中断期间到来的中断同样能将 wfi 唤醒
+            if (zeroed == 0) {
+                Interrupt::wait();
+            }
+            Interrupt::sti();
+        }
+    }
+
+    bool Scheduler::running_anywhere(const PCB *pcb) {
+        for (size_t cpu = 0; cpu < cpu::online(); cpu++) {
+            if (!initialized(cpu)) {
+                continue;
+            }
+            const TCB *cur = of(cpu).current_tcb();
+            if (cur != nullptr && cur->task == pcb) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t Scheduler::select_wake_cpu(TCB *tcb) {
+        const size_t prev = tcb->cpu;
+        if (prev == _cpu || prev >= cpu::online() || !initialized(prev)) {
+            return _cpu;
+        }
+        if (tcb->schd_class == ClassType::DL) {
+            return prev;
+        }
+        return of(prev).load() <= load() ? prev : _cpu;
+    }
+
+    Scheduler *Scheduler::find_busiest() {
+        Scheduler *busiest = nullptr;
+        size_t max_load    = 0;
+        for (size_t cpu = 0; cpu < cpu::online(); cpu++) {
+            if (cpu == _cpu || !initialized(cpu)) {
+                continue;
+            }
+            Scheduler &other = of(cpu);
+            if (other._rq.nr_queued() == 0) {
+                continue;
+            }
+            size_t load = other.load();
+            if (load > max_load) {
+                busiest  = &other;
+                max_load = load;
+            }
+        }
+        return busiest;
+    }
+
+    TCB *Scheduler::migrate_from(Scheduler &src) {
+        // 按调度类优先级选择, 先迁移高优先级的线程;
+        // DL 线程的带宽预留在 src 上, 不参与迁移
+        TCB *tcb = nullptr;
+        if (src._rq.rr.nr > 0) {
+            tcb = src.rr_schd()->last(src.rq());
+        } else if (!src._rq.cfs.timeline.empty()) {
+            tcb = src.cfs_schd()->last(src.rq());
+        } else if (!src._rq.fcfs_list.empty()) {
+            tcb = SchedMeta::asunit<TCB>(
+                util::nnullforce(&src._rq.fcfs_list.back()));
+        }
+        if (tcb == nullptr) {
+            return nullptr;
+        }
+
+        auto dequeue_res = src.dequeue(util::nnullforce(tcb));
+        if (!dequeue_res.has_value()) {
+            loggers::SUSTCORE::ERROR("迁移线程时出队失败! 错误码: %s",
+                                     to_cstring(dequeue_res.error()));
+            return nullptr;
+        }
+        auto enqueue_res = enqueue(util::nnullforce(tcb));
+        if (!enqueue_res.has_value()) {
+            // 放回原处理器, 以免线程丢失
+            loggers::SUSTCORE::ERROR("迁移线程时入队失败! 错误码: %s",
+                                     to_cstring(enqueue_res.error()));
+            auto restore_res = src.enqueue(util::nnullforce(tcb));
+            if (!restore_res.has_value()) {
+                panic("调度器崩溃!");
+            }
+            return nullptr;
+        }
+        _stats.migrations++;
+        return tcb;
+    }
+
+    bool Scheduler::idle_balance() {
+        if (_rq.nr_queued() > 0) {
+            return false;
+        }
+        Scheduler *busiest = find_busiest();
+        if (busiest == nullptr || migrate_from(*busiest) == nullptr) {
+            return false;
+        }
+        _stats.steals++;
+        return true;
+    }
+
+    void Scheduler::periodic_balance() {
+        Scheduler *busiest = find_busiest();
+        if (busiest == nullptr) {
+            return;
+        }
+        // 差距小于 2 时迁移一个线程只会让负载在两侧来回颠簸
+        while (busiest->load() >= load() + 2) {
+            TCB *tcb = migrate_from(*busiest);
+            if (tcb == nullptr) {
+                break;
+            }
+            _stats.pulls++;
+            check_preempt_curr(tcb);
+        }
     }
 
     bool Scheduler::try_wakeup(TCB *tcb, int flags) {
@@ -87,12 +260,21 @@ namespace schd {
     }
 
     bool Scheduler::wakeup(TCB *tcb) {
-        return try_wakeup(tcb, 0);
+        const size_t target = select_wake_cpu(tcb);
+        if (target == _cpu) {
+            if (tcb->cpu != _cpu) {
+                _stats.migrations++;
+            }
+            return try_wakeup(tcb, 0);
+        }
+        // 唤醒到其它处理器时, 由该处理器的下一次时钟中断完成抢占
+        return of(target).try_wakeup(tcb, 0);
     }
 
     bool Scheduler::wakeup_new(TCB *new_tcb) {
-        // 我们目前直接执行try_wakeup
-        return try_wakeup(new_tcb, 0);
+        // 新线程放到负载最轻的处理器上; 放到其它处理器时,
+        // 由该处理器的下一次时钟中断完成抢占
+        return of(select_cpu()).try_wakeup(new_tcb, 0);
     }
 
     Result<util::nonnull<TCB *>> Scheduler::pick_next_task() {
@@ -120,8 +302,21 @@ namespace schd {
         }
 
         bool do_preempt = false;
-        if (new_tcb->schd_class <= _curtcb->schd_class) {
-            // 如果新线程的调度类优先级不高于当前线程, 则不需要抢占
+        if (new_tcb->schd_class < _curtcb->schd_class) {
+            // 如果新线程的调度类优先级低于当前线程, 则不需要抢占
+            return;
+        }
+
+        if (new_tcb->schd_class == _curtcb->schd_class) {
+            // 同一调度类内是否抢占由该调度类决定
+            auto schd_res = schd(new_tcb->schd_class);
+            if (schd_res.has_value() &&
+                schd_res.value()->check_preempt_wakeup(
+                    rq(), util::nnullforce(_curtcb), util::nnullforce(new_tcb)))
+            {
+                _curtcb->basic_entity
+                    .template flags_set<SchedMeta::FLAGS_NEED_RESCHED>();
+            }
             return;
         }
 
@@ -179,6 +374,9 @@ namespace schd {
             }
         }
 
+        // 本处理器即将空闲时, 先尝试从其它处理器窃取线程
+        idle_balance();
+
         // 选择下一个要运行的线程
         auto next_res = pick_next_task();
         if (!next_res.has_value()) {
@@ -196,10 +394,25 @@ namespace schd {
             unexpect_return(schd_res.error());
         }
 
-        return schd_res.value()->enqueue(rq(), tcb);
+        // 从其它处理器迁入的 CFS 线程须换算到本处理器的虚拟时间基准
+        if (tcb->schd_class == ClassType::CFS && tcb->cpu != _cpu &&
+            tcb->cpu < cpu::online() && initialized(tcb->cpu))
+        {
+            cfs::rebase(tcb->cfs_entity, of(tcb->cpu)._rq.cfs, _rq.cfs);
+        }
+
+        auto enqueue_res = schd_res.value()->enqueue(rq(), tcb);
+        propagate(enqueue_res);
+        tcb->cpu = _cpu;
+        void_return();
     }
 
     Result<void> Scheduler::dequeue(util::nonnull<TCB *> tcb) {
+        // 线程可能位于其它处理器的运行队列中
+        if (tcb->cpu != _cpu) {
+            return of(tcb->cpu).dequeue(tcb);
+        }
+
         auto schd_res = schd(tcb->schd_class);
         if (!schd_res.has_value()) {
             unexpect_return(schd_res.error());
@@ -208,6 +421,94 @@ namespace schd {
         return schd_res.value()->dequeue(rq(), tcb);
     }
 
+    Result<void> Scheduler::set_nice(util::nonnull<TCB *> tcb, int nice) {
+        // 只有位于 CFS 运行队列中的线程需要调整所在队列
+        if (tcb->schd_class != ClassType::CFS) {
+            if (nice < cfs::MIN_NICE || nice > cfs::MAX_NICE) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            tcb->cfs_entity.set_nice(nice);
+            void_return();
+        }
+        Scheduler &owner = initialized(tcb->cpu) ? of(tcb->cpu) : inst();
+        return owner.cfs_schd()->set_nice(owner.rq(), tcb, nice);
+    }
+
+    Result<void> Scheduler::set_priority(util::nonnull<TCB *> tcb,
+                                         size_t prio) {
+        if (tcb->schd_class != ClassType::RR) {
+            if (prio >= rr::NR_PRIOS) {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            tcb->rr_entity.prio = prio;
+            void_return();
+        }
+        Scheduler &owner = initialized(tcb->cpu) ? of(tcb->cpu) : inst();
+        return owner.rr_schd()->set_prio(owner.rq(), tcb, prio);
+    }
+
+    Result<void> Scheduler::set_deadline(util::nonnull<TCB *> tcb,
+                                         size_t runtime, size_t period,
+                                         size_t deadline) {
+        Scheduler &owner = initialized(tcb->cpu) ? of(tcb->cpu) : inst();
+        return owner.change_deadline(tcb, runtime, period, deadline);
+    }
+
+    Result<void> Scheduler::change_deadline(util::nonnull<TCB *> tcb,
+                                            size_t runtime, size_t period,
+                                            size_t deadline) {
+        const bool is_dl = tcb->schd_class == ClassType::DL;
+        if (runtime == 0 && !is_dl) {
+            void_return();
+        }
+        if (runtime != 0) {
+            if (tcb->schd_class == ClassType::IDLE ||
+                tcb->schd_class == ClassType::BOT)
+            {
+                unexpect_return(ErrCode::INVALID_PARAM);
+            }
+            auto admit_res =
+                dl_schd()->admit(rq(), tcb, runtime, period, deadline);
+            propagate(admit_res);
+        }
+
+        // 就绪的线程须先移出原队列, 以新的调度类或截止时间重新入队
+        const bool queued = tcb->basic_entity.state == ThreadState::READY;
+        if (queued) {
+            auto dequeue_res = dequeue(tcb);
+            propagate(dequeue_res);
+        }
+
+        if (runtime == 0) {
+            dl_schd()->detach(rq(), tcb);
+            tcb->schd_class = tcb->dl_entity.fallback;
+        } else {
+            if (!is_dl) {
+                tcb->dl_entity.fallback = tcb->schd_class;
+            }
+            dl_schd()->attach(rq(), tcb, runtime, period, deadline);
+            tcb->schd_class = ClassType::DL;
+        }
+
+        if (queued) {
+            auto enqueue_res = enqueue(tcb);
+            propagate(enqueue_res);
+            check_preempt_curr(tcb);
+        } else if (tcb == _curtcb) {
+            // 正在运行的线程在下一次调度时按新的调度类放回
+            tcb->basic_entity
+                .template flags_set<SchedMeta::FLAGS_NEED_RESCHED>();
+        }
+        void_return();
+    }
+
+    ClassType Scheduler::inherited_class(const TCB &tcb) {
+        if (tcb.schd_class == ClassType::DL) {
+            return tcb.dl_entity.fallback;
+        }
+        return tcb.schd_class;
+    }
+
     Result<void> Scheduler::block_current(WaitReasonId reason) {
         return block_current(reason, {});
     }
@@ -262,7 +563,7 @@ namespace schd {
         schedule();
     }
 
-    // RR > FCFS
+    // DL > RR > CFS > FCFS
     void Scheduler::do_tick(const TimerTickEvent &e) {
         if (_curtcb == nullptr) {
             return;
@@ -276,12 +577,39 @@ namespace schd {
             return;
         }
 
-        auto tick_res = schd_res.value()->on_tick(rq(), tcb);
+        // 先推进 DL 时钟, on_tick 据此检查截止时间;
+        // 以硬件时钟换算为时钟中断数, 各处理器的 DL 时钟一致
+        uint64_t now = (e.last_tick + e.gap_ticks) / e.increment;
+        TCB *woken   = dl_schd()->update_clock(rq(), now);
+
+        const size_t missed = tcb->dl_entity.misses;
+        auto tick_res       = schd_res.value()->on_tick(rq(), tcb);
         if (!tick_res.has_value()) {
             loggers::SUSTCORE::ERROR(
                 "调度器处理on_tick失败! 错误码: %s 对应调度类: %s",
                 to_cstring(tick_res.error()), to_cstring(tcb->schd_class));
         }
+        if (tcb->dl_entity.misses != missed) {
+            loggers::SUSTCORE::WARN(
+                "DL 线程 %d 错过截止时间, 累计 %d 次 (处理器 %d 累计 %d 次)",
+                tcb->tid, tcb->dl_entity.misses, _cpu, _rq.dl.nr_missed);
+        }
+        // 补充预算后截止时间更早的线程可抢占当前线程
+        if (woken != nullptr) {
+            check_preempt_curr(woken);
+        }
+
+        _ticks++;
+        if (tcb->schd_class == ClassType::IDLE) {
+            // 空闲时每个时钟中断都尝试窃取, 窃取成功则立即切换
+            if (idle_balance()) {
+                tcb->basic_entity
+                    .template flags_set<SchedMeta::FLAGS_NEED_RESCHED>();
+                return;
+            }
+        } else if (_ticks % BALANCE_INTERVAL == 0) {
+            periodic_balance();
+        }
     }
 
     void Scheduler::init() {
@@ -309,7 +637,12 @@ namespace schd {
             panic("调度器崩溃!");
         }
 
+        // 已有就绪线程 (如引导核上的 init) 时直接切换过去,
+        // 否则进入空闲上下文
+        schedule();
         switch_to(_curtcb);
+        // 此后不再返回; 内核大锁在 isr_restore_user 切换到线程的
+        // 内核栈后释放, 由下一次陷入重新获取
         isr_restore_user(_curtcb->kstack_top);
     }
 }  // namespace schd
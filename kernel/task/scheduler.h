@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cpu.h>
 #include <schd/idle.h>
 #include <schd/schdbase.h>
 #include <sus/nonnull.h>
@@ -23,30 +24,97 @@ namespace schd {
 
     void switch_pgd(TaskMemoryManager *tmm);
 
+    /**
+     * @brief 各处理器的线程迁移统计
+     */
+    struct BalanceStats {
+        // 迁入本处理器的线程数 (唤醒, 窃取与周期均衡)
+        size_t migrations = 0;
+        // 本处理器空闲时从其它处理器窃取的线程数
+        size_t steals = 0;
+        // 周期性负载均衡拉取的线程数
+        size_t pulls = 0;
+    };
+
     class Scheduler {
     private:
+        // 周期性负载均衡的间隔 (时钟中断次数)
+        static constexpr size_t BALANCE_INTERVAL = 8;
+
+        size_t _cpu;
         RQ _rq;
+        size_t _ticks = 0;
+        BalanceStats _stats;
 
+        dl::DL<TCB> _dl_schd;
         rr::RR<TCB> _rr_schd;
+        cfs::CFS<TCB> _cfs_schd;
         fcfs::FCFS<TCB> _fcfs_schd;
         idle::IDLE<TCB> _idle_schd;
 
     public:
-        static void init(util::nonnull<TCB *> init_tcb);
+        /**
+         * @brief 为当前处理器构造调度器
+         *
+         * @param idle_tcb 本处理器的空闲上下文, 无其它可运行线程时运行
+         */
+        static void init(util::nonnull<TCB *> idle_tcb);
         static bool initialized();
+        static bool initialized(size_t cpu);
+        // 当前处理器的调度器
         static Scheduler &inst();
+        // 指定处理器的调度器, 访问他核的调度器须持有内核大锁
+        static Scheduler &of(size_t cpu);
+
+        constexpr Scheduler(size_t cpu, util::nonnull<TCB *> idle_tcb)
+            : _cpu(cpu), _idle_schd(idle_tcb) {}
+
+        [[nodiscard]]
+        constexpr size_t cpu() const {
+            return _cpu;
+        }
 
-        constexpr Scheduler(util::nonnull<TCB *> init_tcb)
-            : _idle_schd(init_tcb) {}
+        /**
+         * @brief 本处理器的负载, 即就绪线程数与正在运行的非空闲线程数之和
+         */
+        [[nodiscard]]
+        size_t load() const;
+
+        /**
+         * @brief 选择负载最轻的在线处理器, 用于放置新建的线程
+         */
+        static size_t select_cpu();
+
+        /**
+         * @brief 进程是否有线程正作为某个在线处理器的当前线程
+         *
+         * 该处理器可能仍在使用这些线程的内核栈与地址空间. 处理器在 trap.S
+         * 中离开旧线程的内核栈后才释放内核大锁, 因此持锁时返回 false
+         * 即说明各处理器都已越过静止点, 进程可以安全回收.
+         */
+        static bool running_anywhere(const PCB *pcb);
+
+        [[nodiscard]]
+        constexpr const BalanceStats &stats() const {
+            return _stats;
+        }
 
         constexpr util::nonnull<RQ *> rq() {
             return _rq;
         }
 
+        constexpr util::nonnull<dl::DL<TCB> *> dl_schd() {
+            return _dl_schd;
+        }
+
         constexpr util::nonnull<rr::RR<TCB> *> rr_schd() {
             return _rr_schd;
         }
 
+        constexpr util::nonnull<cfs::CFS<TCB> *> cfs_schd() {
+            return _cfs_schd;
+        }
+
         constexpr util::nonnull<fcfs::FCFS<TCB> *> fcfs_schd() {
             return _fcfs_schd;
         }
@@ -60,11 +128,30 @@ namespace schd {
             return _curtcb;
         }
 
+        /**
+         * @brief ctx 是否为本处理器的空闲上下文被打断时保存的寄存器帧
+         *
+         * 空闲上下文运行于 S-Mode, 只在开中断等待时被打断, 此时其寄存器帧
+         * 位于内核栈顶, 陷入返回时可以像返回用户态一样切换到其它线程.
+         */
+        bool idle_interrupted(const Context *ctx);
+
+        /**
+         * @brief 空闲上下文的入口, 在 S-Mode 下开中断等待
+         *
+         * 不属于任何进程, 运行于内核页表之上, 不持有内核大锁.
+         * 预清零页池未满时关中断并持锁清零一批页, 否则执行 wfi 等待.
+         */
+        [[noreturn]]
+        static void cpu_idle();
+
         using BaseSchedPtr = util::nonnull<BaseSched<TCB> *>;
 
         constexpr Result<BaseSchedPtr> schd(ClassType type) {
             switch (type) {
+                case ClassType::DL:   return {dl_schd()};
                 case ClassType::RR:   return {rr_schd()};
+                case ClassType::CFS:  return {cfs_schd()};
                 case ClassType::FCFS: return {fcfs_schd()};
                 case ClassType::IDLE: return {idle_schd()};
                 default:              unexpect_return(ErrCode::INVALID_PARAM);
@@ -89,9 +176,15 @@ namespace schd {
          */
         template <typename Func>
         void foreach_schdclass(Func f, ClassType bot = ClassType::BOT) {
+            if (ClassType::DL >= bot) {
+                f(dl_schd());
+            }
             if (ClassType::RR >= bot) {
                 f(rr_schd());
             }
+            if (ClassType::CFS >= bot) {
+                f(cfs_schd());
+            }
             if (ClassType::FCFS >= bot) {
                 f(fcfs_schd());
             }
@@ -108,6 +201,38 @@ namespace schd {
         bool try_wakeup(TCB *tcb, int flags);
         bool wakeup(TCB *tcb);
 
+        /**
+         * @brief 为被唤醒的线程选择处理器
+         *
+         * 原处理器负载不高于唤醒者所在处理器时回到原处理器,
+         * 否则留在唤醒者所在处理器, 二者都可能仍缓存有相关数据.
+         * DL 线程的带宽预留在原处理器上, 总是回到原处理器.
+         */
+        size_t select_wake_cpu(TCB *tcb);
+
+        // 就绪线程最多的其它处理器, 没有可迁移线程时返回 nullptr
+        Scheduler *find_busiest();
+
+        /**
+         * @brief 从 src 的就绪队列尾部取出一个线程放入本处理器
+         *
+         * 队尾的线程入队最晚, 离被调度最远, 迁移它对 src 的影响最小.
+         *
+         * @return 被迁移的线程, 没有可迁移线程时返回 nullptr
+         */
+        TCB *migrate_from(Scheduler &src);
+
+        /**
+         * @brief 在本处理器上修改线程的 DL 参数, 见 set_deadline
+         */
+        Result<void> change_deadline(util::nonnull<TCB *> tcb, size_t runtime,
+                                     size_t period, size_t deadline);
+
+        // 本处理器无就绪线程时窃取一个线程
+        bool idle_balance();
+        // 与最忙的处理器负载相差两个以上时拉取线程以缩小差距
+        void periodic_balance();
+
     public:
         void do_tick(const TimerTickEvent &e);
 
@@ -122,8 +247,8 @@ namespace schd {
          * 如果需要则选择下一个要运行的调度单元并切换到它 注意的是,
          * 只有在current_tcb不为null时, 调度器才开始工作 这意味着, 你需要通过
          * init() 方法将 current_tcb 设置为一个有效的 TCB 后, 调度器才会开始调度
-         * 一般来说, init() 方法会将其设置为 IDLE 调度类中的 IDLE TCB,
-         * 这样调度器就会在没有其他可运行线程时调度到这个 IDLE 线程上
+         * 一般来说, init() 方法会将其设置为 IDLE 调度类中的空闲上下文,
+         * 这样调度器就会在没有其他可运行线程时调度到这个空闲上下文上
          *
          */
         void schedule();
@@ -144,5 +269,43 @@ namespace schd {
 
         // 主动放弃 CPU
         void yield();
+
+        /**
+         * @brief 修改线程的 nice 值, 仅影响其在 CFS 调度类中的权重
+         *
+         * 线程可以位于任意处理器上, 须持有内核大锁.
+         *
+         * @param nice 取值范围为 [cfs::MIN_NICE, cfs::MAX_NICE]
+         */
+        static Result<void> set_nice(util::nonnull<TCB *> tcb, int nice);
+
+        /**
+         * @brief 修改线程的静态优先级, 仅影响其在 RR 调度类中的次序
+         *
+         * 线程可以位于任意处理器上, 须持有内核大锁.
+         *
+         * @param prio 取值范围为 [0, rr::NR_PRIOS), 越大越优先
+         */
+        static Result<void> set_priority(util::nonnull<TCB *> tcb,
+                                         size_t prio);
+
+        /**
+         * @brief 设置线程的 DL 参数, 使其进入或退出 DL 调度类
+         *
+         * 参数以时钟中断为单位, 须满足 0 < runtime <= deadline <= period;
+         * 线程所在处理器的 DL 带宽之和超出上限时拒绝准入.
+         * runtime 为 0 时线程退出 DL, 回到进入前的调度类.
+         * 线程可以位于任意处理器上, 须持有内核大锁.
+         */
+        static Result<void> set_deadline(util::nonnull<TCB *> tcb,
+                                         size_t runtime, size_t period,
+                                         size_t deadline);
+
+        /**
+         * @brief 线程创建的线程或子进程应使用的调度类
+         *
+         * DL 的带宽须经准入检查, 不随创建继承, 新线程使用进入 DL 前的类.
+         */
+        static ClassType inherited_class(const TCB &tcb);
     };
 }  // namespace schd
@@ -182,11 +182,11 @@ namespace task {
                                        void *entrypoint, void *stack_top) {
         *tcb->context() = {};
         tcb->context()->setup_regs(false);
-        tcb->context()->pc() = reinterpret_cast<umb_t>(entrypoint);
-        tcb->context()->sp() = reinterpret_cast<umb_t>(stack_top);
-        tcb->basic_entity    = {};
-        tcb->rr_entity       = {};
-        tcb->coroutines      = {};
+        tcb->context()->pc()     = reinterpret_cast<umb_t>(entrypoint);
+        tcb->context()->sp()     = reinterpret_cast<umb_t>(stack_top);
+        tcb->basic_entity        = {};
+        tcb->rr_entity.slice_cnt = 0;
+        tcb->coroutines          = {};
 
         void_return();
     }
@@ -346,6 +346,14 @@ namespace task {
     Result<void> TaskManager::recycle_tcb(util::nonnull<TCB *> tcb) {
         loggers::TASK::DEBUG("回收线程 %d (PID: %d)", tcb->tid,
                             tcb->task != nullptr ? tcb->task->pid : -1);
+        // 归还 DL 线程在其处理器上预留的带宽
+        if (tcb->schd_class == schd::ClassType::DL) {
+            auto detach_res = schd::Scheduler::set_deadline(tcb, 0, 0, 0);
+            if (!detach_res.has_value()) {
+                loggers::TASK::ERROR("释放线程 %d 的 DL 带宽失败! 错误码: %s",
+                                     tcb->tid, to_cstring(detach_res.error()));
+            }
+        }
         PCB *pcb = tcb->task;
         if (pcb != nullptr) {
             pcb->threads.remove(*tcb);
@@ -404,19 +412,24 @@ namespace task {
     }
 
     void TaskManager::reap_recycled() {
-        while (!_recycle_pcbs.empty()) {
-            PCB *pcb = _recycle_pcbs.front();
-            _recycle_pcbs.pop_front();
-            if (pcb == nullptr) {
+        // 仍有线程作为某个处理器的当前线程时, 该处理器可能还在使用其内核栈
+        // 与地址空间; 留在队列中, 待各处理器切换走后的下一次陷入再回收
+        for (auto it = _recycle_pcbs.begin(); it != _recycle_pcbs.end();) {
+            PCB *pcb = *it;
+            if (pcb != nullptr && schd::Scheduler::running_anywhere(pcb)) {
+                ++it;
                 continue;
             }
-            terminate_pcb(util::nnullforce(pcb));
+            it = _recycle_pcbs.erase(it);
+            if (pcb != nullptr) {
+                terminate_pcb(util::nnullforce(pcb));
+            }
         }
     }
 
     Result<util::nonnull<PCB *>> TaskManager::create_init_task(
         TaskSpec spec /* ... args*/) {
-        constexpr schd::ClassType INIT_SCHED_CLASS = schd::ClassType::IDLE;
+        constexpr schd::ClassType INIT_SCHED_CLASS = schd::ClassType::FCFS;
         util::nonnull<PCB *> pcb                   = alloc_pcb();
         auto pcb_guard = util::Guard([pcb]() { delete pcb.get(); });
 
@@ -435,6 +448,7 @@ namespace task {
         }
 
         _pid_map[pcb->pid] = pcb;
+        _init_pcb          = pcb;
         pcb_guard.release();  // 进程已成功构造, 释放PCB的自动释放机制
         return pcb;
     }
@@ -552,10 +566,15 @@ namespace task {
 
     Result<util::nonnull<PCB *>> TaskManager::load_elf_into(
         const char *path, cap::CHolder *holder, schd::ClassType schd_class) {
+        return spawn(SpawnSpec{path, holder, schd_class, nullptr, 0});
+    }
+
+    Result<util::nonnull<PCB *>> TaskManager::spawn(const SpawnSpec &sspec) {
         TaskSpec spec{util::owner<TaskMemoryManager *>(nullptr), nullptr,
                       VirAddr(static_cast<addr_t>(0))};
         LoadPrm load_prm{};
-        auto preload_res = preload_into(path, holder, spec, load_prm);
+        auto preload_res =
+            preload_into(sspec.path, sspec.holder, spec, load_prm);
         if (!preload_res.has_value()) {
             loggers::SUSTCORE::ERROR("预加载程序资源失败! 错误码: %s",
                                      to_cstring(preload_res.error()));
@@ -578,7 +597,26 @@ namespace task {
             unexpect_return(ErrCode::CREATION_FAILED);
         }
 
-        auto task_res = create_task(spec, schd_class);
+        // 映射在主线程运行前完成, 权限由子进程持有的 Memory capability 决定
+        for (size_t i = 0; i < sspec.mapping_count; i++) {
+            const SpawnMapping &mapping = sspec.mappings[i];
+            auto cap_res                = sspec.holder->internal_lookup(
+                mapping.memory);
+            propagate(cap_res);
+            if (cap_res.value()->payload_as<cap::MemoryPayload>() == nullptr) {
+                unexpect_return(ErrCode::TYPE_NOT_MATCHED);
+            }
+            cap::MemoryObject mem_obj(util::nnullforce(cap_res.value()));
+            auto map_res = mem_obj.map_into(*spec.tmm, mapping.vaddr,
+                                            mapping.rwx, mapping.growth);
+            if (!map_res.has_value()) {
+                loggers::SUSTCORE::ERROR("spawn: 映射 Memory 失败: vaddr=%p",
+                                         mapping.vaddr.addr());
+                propagate_return(map_res);
+            }
+        }
+
+        auto task_res = create_task(spec, sspec.schd_class);
         propagate(task_res);
         spec_owned = false;
         return task_res.value();
@@ -606,6 +644,37 @@ namespace task {
         return create_init_task(spec);
     }
 
+    Result<util::nonnull<TCB *>> TaskManager::create_idle_thread() {
+        // 内核栈之下另留一页作为空闲循环自身的栈. 空闲上下文被打断时,
+        // 陷入处理与 trap.S 的出口代码使用寄存器帧之下的内核栈,
+        // 二者不能重叠
+        constexpr size_t IDLE_STACK_PAGES = 1;
+        constexpr size_t PAGES            = TCB::KSTACK_PAGES + IDLE_STACK_PAGES;
+
+        util::nonnull<TCB *> tcb = alloc_tcb();
+        auto tcb_guard = util::Guard([tcb]() { delete tcb.get(); });
+
+        Result<PhyAddr> gfp_res = GFP::get_free_page(PAGES);
+        propagate(gfp_res);
+        tcb->kstack_phy = gfp_res.value() + PAGES * PAGESIZE;
+        tcb->kstack_top = convert<KpaAddr>(tcb->kstack_phy).addr();
+
+        // 不属于任何进程, 以 S-Mode 从 cpu_idle 开始执行; 空闲上下文不会
+        // 迁移, tp 固定为所在处理器的逻辑编号
+        auto *stack_top = static_cast<char *>(tcb->kstack_top) -
+                          TCB::KSTACK_SIZE;
+        *tcb->context() = {};
+        tcb->context()->setup_regs(true);
+        tcb->context()->pc() =
+            reinterpret_cast<umb_t>(&schd::Scheduler::cpu_idle);
+        tcb->context()->sp() = reinterpret_cast<umb_t>(stack_top);
+        tcb->context()->tp() = cpu::current();
+        tcb->schd_class      = schd::ClassType::IDLE;
+
+        tcb_guard.release();
+        return tcb;
+    }
+
     Result<size_t> TaskManager::lookup_holder_id(pid_t pid) {
         return _pid_map.at_nt(pid)
             .transform_error(always(ErrCode::OUT_OF_BOUNDARY))
@@ -668,6 +737,10 @@ namespace task {
                 } else {
                     payload = memory->clone_payload();
                 }
+                if (payload == nullptr) {
+                    clone_caps_err = ErrCode::OUT_OF_MEMORY;
+                    return;
+                }
             }
             auto insert_res =
                 child_holder->internal_insert(idx, payload, parent_cap->perm());
@@ -703,9 +776,14 @@ namespace task {
         child_tcb->context()->sepc                       += 4;
         child_tcb->context()->regs[Context::A0_BASE]      = ret_slot;
         child_tcb->context()->regs[Context::A0_BASE + 1]  = 0;
-        child_tcb->schd_class   = parent_tcb->schd_class;
-        child_tcb->basic_entity = {};
-        child_tcb->rr_entity    = {};
+        child_tcb->schd_class =
+            schd::Scheduler::inherited_class(*parent_tcb);
+        child_tcb->basic_entity   = {};
+        child_tcb->rr_entity      = {};
+        child_tcb->rr_entity.prio = parent_tcb->rr_entity.prio;
+        child_tcb->cfs_entity     = {};
+        child_tcb->cfs_entity.set_nice(parent_tcb->cfs_entity.nice);
+        child_tcb->dl_entity = {};
         child_pcb->threads.push_back(*child_tcb);
         tcb_guard.release();
 
@@ -763,9 +841,9 @@ namespace task {
         auto range_res = pcb->tmm->locate_range(stack_area);
         propagate(range_res);
 
-        auto con_res =
-            construct_thread(util::nnullforce(pcb), entry.addr(),
-                             stack_top.addr(), current_tcb->schd_class);
+        auto con_res = construct_thread(
+            util::nnullforce(pcb), entry.addr(), stack_top.addr(),
+            schd::Scheduler::inherited_class(*current_tcb));
         propagate(con_res);
         util::nonnull<TCB *> tcb = con_res.value();
         auto tcb_guard = util::Guard([this, tcb]() { (void)recycle_tcb(tcb); });
@@ -810,13 +888,18 @@ namespace task {
         auto *current_tcb = schd::Scheduler::inst().current_tcb();
         bool target_current =
             current_tcb != nullptr && current_tcb->task == pcb;
+        // 目标进程的线程正在其它处理器上运行时, 不能回收其内核栈与地址空间
+        if (!target_current && schd::Scheduler::running_anywhere(pcb)) {
+            unexpect_return(ErrCode::BUSY);
+        }
         schd::ClassType schd_class = schd::ClassType::FCFS;
         TCB *reuse_tcb             = nullptr;
         if (target_current) {
             reuse_tcb  = current_tcb;
             schd_class = current_tcb->schd_class;
         } else if (!pcb->threads.empty()) {
-            schd_class = pcb->threads.front().schd_class;
+            schd_class =
+                schd::Scheduler::inherited_class(pcb->threads.front());
             if (schd_class == schd::ClassType::IDLE ||
                 schd_class == schd::ClassType::BOT)
             {
@@ -889,9 +972,9 @@ namespace task {
             populate_task(util::nnullforce(pcb), spec, schd_class, reuse_tcb);
         propagate(populate_res);
         if (target_current) {
-            current_tcb->basic_entity.state = ThreadState::RUNNING;
-            current_tcb->basic_entity.flags = 0;
-            current_tcb->rr_entity          = {};
+            current_tcb->basic_entity.state  = ThreadState::RUNNING;
+            current_tcb->basic_entity.flags  = 0;
+            current_tcb->rr_entity.slice_cnt = 0;
         } else if (!schd::Scheduler::inst().wakeup_new(populate_res.value())) {
             unexpect_return(ErrCode::CREATION_FAILED);
         }
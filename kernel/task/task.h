@@ -13,6 +13,7 @@
 
 #include <arch/description.h>
 #include <exe/task.h>
+#include <object/memory.h>
 #include <schd/schdbase.h>
 #include <sus/list.h>
 #include <sus/map.h>
@@ -27,6 +28,29 @@ namespace task {
         pid_t child_pid;
     };
 
+    /**
+     * @brief spawn 时预先映射进子进程地址空间的 Memory.
+     */
+    struct SpawnMapping {
+        // 子进程 CSpace 中的 Memory capability
+        CapIdx memory;
+        VirAddr vaddr;
+        PageMan::RWX rwx;
+        cap::MemoryGrowth growth;
+    };
+
+    /**
+     * @brief spawn 的参数.
+     */
+    struct SpawnSpec {
+        const char *path;
+        // 已完成 capability 传递的子进程 CHolder
+        cap::CHolder *holder;
+        schd::ClassType schd_class;
+        const SpawnMapping *mappings;
+        size_t mapping_count;
+    };
+
     class TaskManager {
     private:
         size_t __tid_alloc = 1;
@@ -42,6 +66,7 @@ namespace task {
 
         std::unordered_map<pid_t, PCB *> _pid_map;
         util::LinkedList<PCB *> _recycle_pcbs;
+        PCB *_init_pcb = nullptr;
 
         /**
          * @brief 分配并返回一个新的 TCB 对象的非空指针.
@@ -60,6 +85,8 @@ namespace task {
             tcb->schd_class            = schd::ClassType::BOT;
             tcb->basic_entity          = {};
             tcb->rr_entity             = {};
+            tcb->cfs_entity            = {};
+            tcb->dl_entity             = {};
             tcb->wait_reason           = 0;
             tcb->wait_predicate        = {};
             tcb->coroutines.ipc_handle = nullptr;
@@ -322,6 +349,17 @@ namespace task {
         Result<util::nonnull<PCB *>> load_elf_into(const char *path,
                                                    cap::CHolder *holder,
                                                    schd::ClassType schd_class);
+        /**
+         * @brief 直接创建并启动一个新进程, 不复制调用者的地址空间.
+         *
+         * 以 spec.holder 为子进程 CHolder 加载 ELF, 随后将 mappings 中的
+         * Memory 映射进新的地址空间, 最后创建主线程并加入调度.
+         * 调用者的页表不受影响. 失败时已加载的地址空间被释放, holder
+         * 仍归调用者所有.
+         *
+         * @return 创建成功的 PCB.
+         */
+        Result<util::nonnull<PCB *>> spawn(const SpawnSpec &spec);
         /**
          * @brief 加载并创建 init 进程的 PCB, 路径通常指向系统初始化程序.
          *
@@ -330,6 +368,16 @@ namespace task {
          * 失败返回错误码.
          */
         Result<util::nonnull<PCB *>> load_init(const char *path);
+
+        /**
+         * @brief 为当前处理器创建空闲上下文.
+         *
+         * 空闲上下文不属于任何进程, 在 S-Mode 下执行 Scheduler::cpu_idle,
+         * 开中断后以 wfi 等待, 由各处理器的 IDLE 调度类持有, 不进入运行队列.
+         *
+         * @return Result<util::nonnull<TCB *>> 成功返回空闲上下文的 TCB.
+         */
+        Result<util::nonnull<TCB *>> create_idle_thread();
     };
 
     void init_kop();
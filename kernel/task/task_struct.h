@@ -14,6 +14,8 @@
 #include <arch/description.h>
 #include <cap/cholder.h>
 #include <mem/vma.h>
+#include <schd/cfs.h>
+#include <schd/dl.h>
 #include <schd/fcfs.h>
 #include <schd/rr.h>
 #include <schd/schdbase.h>
@@ -60,8 +62,12 @@ namespace task {
 
         //  schedule data
         schd::ClassType schd_class;
+        // 所在运行队列 (或正在其上运行) 的处理器
+        size_t cpu = 0;
         schd::SchedMeta basic_entity;
         schd::rr::Entity rr_entity;
+        schd::cfs::Entity cfs_entity;
+        schd::dl::Entity dl_entity;
 
         struct SystemCoroutines {
             // Endpoint IPC recv 协程句柄, 只由 endpoint recv/send 路径使用. 
@@ -148,8 +148,7 @@ namespace task::wait {
             target_tmm->pgd() != origin_pgd)
         {
             env::inst().tmm(key::wait()) = target_tmm;
-            PageMan(target_tmm->pgd()).switch_root();
-            PageMan::flush_tlb();
+            target_tmm->activate();
         }
 
         bool should_wake = tcb->wait_predicate(tcb);
@@ -158,8 +157,7 @@ namespace task::wait {
             target_tmm->pgd() != origin_pgd)
         {
             env::inst().tmm(key::wait()) = origin_tmm;
-            PageMan(origin_pgd).switch_root();
-            PageMan::flush_tlb();
+            TaskMemoryManager::switch_to(origin_tmm, origin_pgd);
         }
 
         return should_wake;
@@ -9,10 +9,13 @@
  *
  */
 
+#include <mem/alloc.h>
 #include <mem/gfp.h>
 #include <sus/list.h>
 #include <test/buddy.h>
 
+#include <cstring>
+
 namespace test::buddy {
 
     class CaseFragmentation : public TestCase {
@@ -159,6 +162,241 @@ namespace test::buddy {
         }
     };
 
+    class CaseFragmentedAllocFree : public TestCase {
+    private:
+        // 线性同余随机数, 保证每次运行的碎片模式一致
+        static uint64_t next_rand(uint64_t& seed) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            return seed >> 33;
+        }
+
+        static constexpr int kOrderCount =
+            FrameBuddyAllocator::MAX_BUDDY_ORDER + 1;
+
+        static void snapshot(size_t (&counts)[kOrderCount]) {
+            for (int o = 0; o < kOrderCount; ++o) {
+                counts[o] = FrameBuddyAllocator::free_blocks(o);
+            }
+        }
+
+        // 块首页应按所在阶对齐, 且不再登记为空闲块首页
+        static bool placed_as_block(PhyAddr p, size_t pages) {
+            if (!p.nonnull()) {
+                return false;
+            }
+            size_t block = 1;
+            while (block < pages) {
+                block <<= 1;
+            }
+            PageFrame* frame = FrameTable::frame(p);
+            return p.aligned(block * PAGESIZE) && frame != nullptr &&
+                   !frame->test(PageFrame::BUDDY);
+        }
+
+    public:
+        CaseFragmentedAllocFree()
+            : TestCase("Buddy 随机碎片下的分配/释放") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kLevels[] = {0, 256, 2048};
+            constexpr int kLevelCount  = sizeof(kLevels) / sizeof(kLevels[0]);
+            constexpr size_t kMaxHeld  = kLevels[kLevelCount - 1] * 2;
+            constexpr int kOps         = 256;
+            uint64_t seed              = 0x5eed;
+
+            auto* held = static_cast<PhyAddr*>(
+                Allocator::malloc(kMaxHeld * sizeof(PhyAddr)));
+            tassert(held != nullptr, "无法分配记录表");
+            PhyAddr ops[kOps];
+            size_t ops_sz[kOps];
+
+            for (int level = 0; level < kLevelCount; ++level) {
+                action("分配单页后随机释放一半, 制造离散的空洞");
+                const size_t total = kLevels[level] * 2;
+                size_t got         = 0;
+                for (; got < total; ++got) {
+                    auto r = GFP::get_free_page(1);
+                    if (!r.has_value()) break;
+                    held[got] = r.value();
+                }
+                for (size_t i = got; i > 1; --i) {
+                    size_t j = next_rand(seed) % i;
+                    PhyAddr t   = held[i - 1];
+                    held[i - 1] = held[j];
+                    held[j]     = t;
+                }
+                size_t kept = got / 2;
+                for (size_t i = kept; i < got; ++i) {
+                    GFP::put_page(held[i], 1);
+                }
+
+                GFP::drain_pcp();
+                size_t before[kOrderCount];
+                snapshot(before);
+
+                expect("在当前碎片程度下进行随机大小的分配与释放");
+                for (int i = 0; i < kOps; ++i) {
+                    ops_sz[i] = (next_rand(seed) % 4) + 1;
+                    auto r    = GFP::get_free_page(ops_sz[i]);
+                    ops[i]    = r.has_value() ? r.value() : PhyAddr::null;
+                }
+                size_t misplaced = 0;
+                for (int i = 0; i < kOps; ++i) {
+                    if (!placed_as_block(ops[i], ops_sz[i])) {
+                        misplaced++;
+                    }
+                }
+                for (int i = kOps - 1; i >= 0; --i) {
+                    GFP::put_page(ops[i], ops_sz[i]);
+                }
+
+                check("每次分配都得到按阶对齐且已摘下空闲标记的块");
+                test(misplaced == 0, "存在未按阶对齐或仍带空闲标记的块");
+                check("全部释放后各阶空闲块数量恢复, 即伙伴均已合并");
+                GFP::drain_pcp();
+                size_t after[kOrderCount];
+                snapshot(after);
+                bool restored = true;
+                for (int o = 0; o < kOrderCount; ++o) {
+                    restored = restored && before[o] == after[o];
+                }
+                test(restored, "释放后空闲块分布与分配前不一致");
+
+                for (size_t i = 0; i < kept; ++i) {
+                    GFP::put_page(held[i], 1);
+                }
+            }
+
+            Allocator::free(held);
+        }
+    };
+
+    class CaseFrameRefcount : public TestCase {
+    public:
+        CaseFrameRefcount() : TestCase("GFP 页描述符引用计数与 COW 标记") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            expect("新分配的页引用计数为 1, 且不带任何标记");
+            auto r = GFP::get_free_page(1);
+            tassert(r.has_value(), "分配成功");
+            PhyAddr p        = r.value();
+            PageFrame* frame = FrameTable::frame(p);
+            tassert(frame != nullptr, "页应在描述符表覆盖范围内");
+            ttest(GFP::ref_count(p) == 1);
+            ttest(frame->flags == 0);
+
+            action("模拟 COW 共享: 增加一次引用");
+            GFP::keep_page(p, 1);
+            ttest(GFP::ref_count(p) == 2);
+            ttest(frame->test(PageFrame::COW));
+
+            action("释放一次引用, 页回到独占状态");
+            GFP::put_page(p, 1);
+            ttest(GFP::ref_count(p) == 1);
+            ttest(!frame->test(PageFrame::COW));
+
+            action("释放最后一次引用, 页归还页框分配器");
+            GFP::put_page(p, 1);
+            ttest(GFP::ref_count(p) == 0);
+        }
+    };
+
+    class CasePcpCache : public TestCase {
+    public:
+        CasePcpCache() : TestCase("GFP per-CPU 单页缓存命中与水位") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            GFP::drain_pcp();
+            auto before = GFP::pcp_stats();
+
+            expect("反复分配并释放单页, 除首次补充外应全部命中缓存");
+            constexpr int kPairs = 100;
+            for (int i = 0; i < kPairs; i++) {
+                auto r = GFP::get_free_page(1);
+                tassert(r.has_value(), "分配成功");
+                GFP::put_page(r.value(), 1);
+            }
+            auto after = GFP::pcp_stats();
+            ttest(after.misses - before.misses == 1);
+            ttest(after.hits - before.hits == kPairs - 1);
+            ttest(after.refilled - before.refilled >= 1);
+
+            action("一次性释放超过高水位的单页, 触发批量归还");
+            constexpr size_t kBurst = GFP::PCP_HIGH + GFP::PCP_BATCH;
+            PhyAddr pages[kBurst];
+            size_t got = 0;
+            for (; got < kBurst; got++) {
+                auto r = GFP::get_free_page(1);
+                if (!r.has_value()) break;
+                pages[got] = r.value();
+            }
+            for (size_t i = 0; i < got; i++) {
+                GFP::put_page(pages[i], 1);
+            }
+            auto burst = GFP::pcp_stats();
+            ttest(burst.drained > after.drained);
+            ttest(burst.cached <= GFP::PCP_HIGH);
+
+            action("清空缓存");
+            GFP::drain_pcp();
+            ttest(GFP::pcp_stats().cached == 0);
+        }
+    };
+
+    class CaseZeroPool : public TestCase {
+    public:
+        CaseZeroPool() : TestCase("GFP 预清零页池") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kPages = 32;
+            GFP::drain_zero_pool();
+
+            expect("页池为空时 GFP_ZERO 在分配路径上清零");
+            PhyAddr pages[kPages];
+            for (size_t i = 0; i < kPages; i++) {
+                auto r = GFP::get_free_page(1, GFP_ZERO);
+                tassert(r.has_value(), "分配成功");
+                pages[i] = r.value();
+            }
+            for (size_t i = 0; i < kPages; i++) {
+                auto *bytes = convert<KpaAddr>(pages[i]).as<uint8_t>();
+                ttest(bytes[0] == 0 && bytes[PAGESIZE - 1] == 0);
+                // 弄脏页面, 使其再次分配时必须重新清零
+                memset(bytes, 0xA5, PAGESIZE);
+                GFP::put_page(pages[i], 1);
+            }
+
+            action("模拟空闲上下文填充页池");
+            auto before = GFP::zero_pool_stats();
+            size_t filled = 0;
+            while (filled < kPages) {
+                size_t n = GFP::zero_idle();
+                if (n == 0) break;
+                filled += n;
+            }
+            ttest(filled >= kPages);
+            ttest(GFP::zero_pool_stats().cached >= kPages);
+
+            action("GFP_ZERO 分配应直接命中页池");
+            for (size_t i = 0; i < kPages; i++) {
+                auto r = GFP::get_free_page(1, GFP_ZERO);
+                tassert(r.has_value(), "分配成功");
+                pages[i] = r.value();
+            }
+            auto after = GFP::zero_pool_stats();
+            ttest(after.hits - before.hits == kPages);
+            for (size_t i = 0; i < kPages; i++) {
+                auto *words = convert<KpaAddr>(pages[i]).as<uint64_t>();
+                bool clean  = true;
+                for (size_t w = 0; w < PAGESIZE / sizeof(uint64_t); w++) {
+                    clean = clean && words[w] == 0;
+                }
+                ttest(clean);
+                ttest(GFP::ref_count(pages[i]) == 1);
+                GFP::put_page(pages[i], 1);
+            }
+
+            GFP::drain_zero_pool();
+            ttest(GFP::zero_pool_stats().cached == 0);
+        }
+    };
+
     void collect_tests(TestFramework& framework) {
         auto cases = util::ArrayList<TestCase*>();
         cases.push_back(new CaseFragmentation());
@@ -167,6 +405,10 @@ namespace test::buddy {
         cases.push_back(new CaseInvalidArgs());
         cases.push_back(new CaseAlignment());
         cases.push_back(new CaseStressSmall());
+        cases.push_back(new CaseFragmentedAllocFree());
+        cases.push_back(new CaseFrameRefcount());
+        cases.push_back(new CasePcpCache());
+        cases.push_back(new CaseZeroPool());
 
         framework.add_category(new TestCategory("buddy", std::move(cases)));
     }
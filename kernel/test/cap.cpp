@@ -12,6 +12,7 @@
 #include <cap/capability.h>
 #include <cap/cholder.h>
 #include <object/intobj.h>
+#include <object/memory.h>
 #include <object/perm.h>
 #include <test/cap.h>
 
@@ -254,6 +255,76 @@ namespace test::cap {
         }
     };
 
+    class CaseMemoryFaultIndex : public TestCase {
+    public:
+        CaseMemoryFaultIndex() : TestCase("Memory 逐页缺页 64MiB 的页索引") {}
+        void _run(void *env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kBytes = 64ul << 20;
+            constexpr size_t kPages = kBytes / PAGESIZE;
+            auto *memory            = new kcap::MemoryPayload(
+                kBytes, false, false, kcap::MemoryGrowth::FLEXUP);
+
+            expect("逐页 ensure_page 填满 64MiB");
+            for (size_t i = 0; i < kPages; i++) {
+                auto r = memory->ensure_page(i * PAGESIZE);
+                tassert(r.has_value(), "缺页分配成功");
+            }
+            ttest(memory->allocated_size() == kBytes);
+            ttest(memory->phy_pages.size() == kPages);
+            // 两层: 一个根节点加 kPages / FANOUT 个叶节点
+            constexpr size_t kLeaves = kPages / PageIndex::FANOUT;
+            ttest(memory->phy_pages.node_count() == 1 + kLeaves);
+
+            action("查找与替换");
+            auto mid = memory->lookup_page(kBytes / 2 + 123);
+            tassert(mid.has_value(), "中间页存在");
+            auto again = memory->ensure_page(kBytes / 2);
+            ttest(again.has_value() && again.value() == mid.value());
+
+            action("收缩到一半, 超出部分应被释放");
+            memory->release_pages_from(kBytes / 2);
+            ttest(memory->allocated_size() == kBytes / 2);
+            ttest(memory->phy_pages.node_count() == 1 + kLeaves / 2);
+            auto gone = memory->lookup_page(kBytes / 2);
+            ttest(!gone.has_value() &&
+                  gone.error() == ErrCode::PAGE_NOT_PRESENT);
+
+            memory->destruct();
+        }
+    };
+
+    class CaseMemorySinglePage : public TestCase {
+    public:
+        CaseMemorySinglePage() : TestCase("单页 Memory 的页索引不分配节点") {}
+        void _run(void *env [[maybe_unused]]) const noexcept override {
+            auto *memory = new kcap::MemoryPayload(
+                PAGESIZE, false, false, kcap::MemoryGrowth::FLEXUP);
+
+            expect("唯一的页内联于根槽");
+            auto r = memory->ensure_page(0);
+            tassert(r.has_value(), "缺页分配成功");
+            ttest(memory->phy_pages.size() == 1);
+            ttest(memory->phy_pages.node_count() == 0);
+            auto hit = memory->lookup_page(PAGESIZE - 1);
+            ttest(hit.has_value() && hit.value() == r.value());
+
+            action("增长到两页, 第二页缺页时才分配节点");
+            tassert(memory->resize(2 * PAGESIZE).has_value(), "增长成功");
+            ttest(memory->phy_pages.node_count() == 0);
+            auto second = memory->ensure_page(PAGESIZE);
+            tassert(second.has_value(), "第二页分配成功");
+            ttest(memory->phy_pages.node_count() == 1);
+            ttest(memory->lookup_page(0).value() == r.value());
+
+            action("收缩回一页");
+            tassert(memory->resize(PAGESIZE).has_value(), "收缩成功");
+            ttest(memory->phy_pages.size() == 1);
+            ttest(memory->lookup_page(0).value() == r.value());
+
+            memory->destruct();
+        }
+    };
+
     void collect_tests(TestFramework &framework) {
         auto cases = util::ArrayList<TestCase *>();
         cases.push_back(new CaseCreateObject());
@@ -262,6 +333,8 @@ namespace test::cap {
         cases.push_back(new CaseMigrate());
         cases.push_back(new CaseMigrateOnce());
         cases.push_back(new CasePayloadDestruct());
+        cases.push_back(new CaseMemoryFaultIndex());
+        cases.push_back(new CaseMemorySinglePage());
 
         framework.add_category(
             new TestCategory("capability", std::move(cases)));
@@ -21,6 +21,8 @@
 #include <test/functional.h>
 #include <test/path.h>
 #include <test/printf.h>
+#include <test/schd/cfs.h>
+#include <test/schd/dl.h>
 #include <test/schd/fcfs.h>
 #include <test/schd/rr.h>
 #include <test/slub.h>
@@ -28,6 +30,7 @@
 #include <test/string_view.h>
 #include <test/tree.h>
 #include <test/unordered_map.h>
+#include <test/vma.h>
 
 void collect_tests(TestFramework& framework) {
     test::buddy::collect_tests(framework);
@@ -37,6 +40,8 @@ void collect_tests(TestFramework& framework) {
     test::functional::collect_tests(framework);
     test::path::collect_tests(framework);
     test::printf::collect_tests(framework);
+    test::schd_test::cfs::collect_tests(framework);
+    test::schd_test::dl::collect_tests(framework);
     test::schd_test::fcfs::collect_tests(framework);
     test::schd_test::rr::collect_tests(framework);
     test::slub::collect_tests(framework);
@@ -44,6 +49,7 @@ void collect_tests(TestFramework& framework) {
     test::string_view::collect_tests(framework);
     test::tree::collect_tests(framework);
     test::unordered_map::collect_tests(framework);
+    test::vma::collect_tests(framework);
 }
 
 void TestFramework::run_all() const {
@@ -9,8 +9,11 @@
  *
  */
 
+#include <exe/image_cache.h>
 #include <logger.h>
 #include <mem/alloc.h>
+#include <mem/gfp.h>
+#include <mem/vma.h>
 #include <object/vfile.h>
 #include <symbols.h>
 #include <test/fs.h>
@@ -186,6 +189,118 @@ namespace test::fs {
         }
     };
 
+    class CaseImageCache : public TestCase {
+    public:
+        CaseImageCache() : TestCase("按 inode 缓存已加载的进程镜像") {}
+
+        void _run(void* env) const noexcept override {
+            auto& vfs = VFS::inst();
+            const VirAddr code(0x10000000);
+            const VirAddr data(0x20000000);
+
+            RamDiskDevice* initrd = make_initrd();
+            tassert(initrd != nullptr, "应能成功创建 initrd RamDisk 设备");
+            auto mount_res =
+                vfs.mount("tarfs", initrd, "/", MountFlags::NONE, nullptr);
+            tassert(mount_res.has_value(), "应能将 tarfs 挂载到根目录 /");
+            auto open_res = vfs.open("/license");
+            tassert(open_res.has_value(), "应能成功打开 /license 文件");
+            auto* cap = new cap::Capability(open_res.value(), perm::allperm());
+            VINode* vind = cap::VFileObject(util::nnullforce(cap)).vind();
+
+            auto first_pgd  = GFP::get_free_page(1);
+            auto second_pgd = GFP::get_free_page(1);
+            tassert(first_pgd.has_value() && second_pgd.has_value(),
+                    "应能分配页表根");
+            TaskSpec first{
+                util::owner(new TaskMemoryManager(first_pgd.value())),
+                nullptr};
+            TaskSpec second{
+                util::owner(new TaskMemoryManager(second_pgd.value())),
+                nullptr};
+            TaskMemoryManager* first_tmm  = first.tmm.get();
+            TaskMemoryManager* second_tmm = second.tmm.get();
+
+            action("模拟一次完成的加载: 一个代码段和一个数据段");
+            auto* text = new cap::MemoryPayload(PAGESIZE, false, false,
+                                                VMA::Growth::FIXED);
+            auto* bss  = new cap::MemoryPayload(PAGESIZE, false, false,
+                                                VMA::Growth::FIXED);
+            tassert(first_tmm
+                        ->add_vma(VMA::Type::CODE, VMA::Growth::FIXED,
+                                  VirArea(code, code + PAGESIZE), text,
+                                  PageMan::RWX::RX)
+                        .has_value(),
+                    "应能创建代码段");
+            tassert(first_tmm
+                        ->add_vma(VMA::Type::DATA, VMA::Growth::FIXED,
+                                  VirArea(data, data + PAGESIZE), bss,
+                                  PageMan::RWX::RW)
+                        .has_value(),
+                    "应能创建数据段");
+            tassert(first_tmm->on_np({code}) && first_tmm->on_np({data, true}),
+                    "应能映射两个段");
+            first.entrypoint = code;
+            first.heap_vaddr = data + PAGESIZE;
+
+            auto insert_res = loader::ImageCache::insert(vind, first);
+            tassert(insert_res.has_value(), "应能将镜像加入缓存");
+            const loader::ImageCache::Image* image =
+                loader::ImageCache::lookup(vind);
+            tassert(image != nullptr && image->seg_count == 2,
+                    "缓存中应能查到两个段的镜像");
+
+            auto pte_res = first_tmm->pman().query_page(data);
+            tassert(pte_res.has_value() &&
+                        PageMan::is_cow(*pte_res.value().pte),
+                    "首个进程的数据段映射应转为 COW");
+
+            action("以缓存的镜像建立第二个地址空间");
+            auto map_res = loader::ImageCache::map(*image, second);
+            tassert(map_res.has_value(), "应能按缓存映射镜像");
+            tassert(second.entrypoint == code &&
+                        second.heap_vaddr == data + PAGESIZE,
+                    "入口点与堆起点应来自缓存");
+            auto code_vma = second_tmm->locate(code);
+            tassert(code_vma.has_value() && code_vma.value()->memory == text,
+                    "只读段应直接共享 Memory");
+            auto data_vma = second_tmm->locate(data);
+            tassert(data_vma.has_value() && data_vma.value()->memory != bss,
+                    "数据段应使用独立的 Memory");
+            tassert(second_tmm->on_np({data}), "应能映射数据段");
+            pte_res = second_tmm->pman().query_page(data);
+            tassert(pte_res.has_value() &&
+                        PageMan::is_cow(*pte_res.value().pte) &&
+                        PageMan::get_physical_address(*pte_res.value().pte) ==
+                            bss->lookup_page(0).value(),
+                    "数据段应以 COW 共享已加载的页");
+
+            action("使 inode 对应的缓存项失效后重新加入");
+            loader::ImageCache::invalidate(vind);
+            tassert(loader::ImageCache::lookup(vind) == nullptr,
+                    "失效后不应再命中");
+            tassert(loader::ImageCache::insert(vind, first).has_value(),
+                    "应能重新加入缓存");
+
+            delete second_tmm;
+            delete first_tmm;
+            GFP::put_page(second_pgd.value(), 1);
+            GFP::put_page(first_pgd.value(), 1);
+
+            action("缓存项不应阻止卸载");
+            delete cap;
+            auto tidy_res = vfs.tidy_up();
+            tassert(tidy_res.has_value(),
+                    "tidy_up 应成功整理 dentry/inode 缓存");
+            auto umount_res = vfs.umount("/");
+            tassert(umount_res.has_value(), "卸载根目录 / 应成功");
+            tassert(loader::ImageCache::lookup(vind) == nullptr,
+                    "卸载后缓存项应已失效");
+
+            delete initrd;
+        }
+    };
+
     static RamDiskDevice* make_initrd() {
         size_t sz             = (char*)&e_initrd - (char*)&s_initrd;
         RamDiskDevice* device = new RamDiskDevice(&s_initrd, sz, 1);
@@ -198,6 +313,7 @@ namespace test::fs {
         cases.push_back(new CaseMountBusyUmount());
         cases.push_back(new CaseOpenMissingFile());
         cases.push_back(new CaseMountParamValidation());
+        cases.push_back(new CaseImageCache());
         framework.add_category(new TestCategory("fs", std::move(cases)));
     }
 }  // namespace test::fs
@@ -1,2 +1,2 @@
 sources += buddy.cpp cap.cpp expected.cpp framework.cpp fs.cpp path.cpp printf.cpp slub.cpp
-sources += string.cpp string_view.cpp tree.cpp functional.cpp unordered_map.cpp
+sources += string.cpp string_view.cpp tree.cpp functional.cpp unordered_map.cpp vma.cpp
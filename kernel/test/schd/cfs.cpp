@@ -0,0 +1,198 @@
+/**
+ * @file cfs.cpp
+ * @brief CFS 调度器加权公平性与抢占测试
+ */
+
+#include <schd/cfs.h>
+#include <test/schd/cfs.h>
+
+namespace test::schd_test::cfs {
+    struct TestThread {
+        schd::SchedMeta basic_entity{};
+        schd::cfs::Entity cfs_entity{};
+        size_t ran = 0;
+    };
+
+    using Policy = schd::cfs::CFS<TestThread>;
+
+    class CaseEmptyQueue : public TestCase {
+    public:
+        CaseEmptyQueue() : TestCase("CFS 空队列行为") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            Policy scheduler;
+            schd::RQ rq{};
+
+            expect("在没有就绪线程时尝试取下一个线程");
+            auto next = scheduler.pick_next(util::nnullforce(&rq));
+            ttest(!next.has_value());
+            ttest(scheduler.last(util::nnullforce(&rq)) == nullptr);
+        }
+    };
+
+    class CaseVruntimeOrder : public TestCase {
+    public:
+        CaseVruntimeOrder() : TestCase("CFS 按虚拟运行时间选择线程") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            Policy scheduler;
+            schd::RQ rq{};
+            TestThread ahead{};
+            TestThread behind{};
+            ahead.cfs_entity.vruntime  = 3 * schd::cfs::TICK_VRUNTIME;
+            behind.cfs_entity.vruntime = schd::cfs::TICK_VRUNTIME;
+
+            tassert(scheduler
+                        .enqueue(util::nnullforce(&rq),
+                                 util::nnullforce(&ahead))
+                        .has_value(),
+                    "第一个线程入队成功");
+            tassert(scheduler
+                        .enqueue(util::nnullforce(&rq),
+                                 util::nnullforce(&behind))
+                        .has_value(),
+                    "第二个线程入队成功");
+            ttest(rq.nr_queued() == 2);
+            ttest(rq.cfs.load_weight == 2 * schd::cfs::NICE_0_WEIGHT);
+
+            expect("虚拟运行时间较小的线程先被选中, 较大者位于队尾");
+            ttest(scheduler.last(util::nnullforce(&rq)) == &ahead);
+            auto next = scheduler.pick_next(util::nnullforce(&rq));
+            tassert(next.has_value(), "成功取到可运行线程");
+            ttest(next.value() == &behind);
+            ttest(behind.basic_entity.state == ThreadState::RUNNING);
+            ttest(!behind.cfs_entity.queued);
+            ttest(rq.cfs.min_vruntime == schd::cfs::TICK_VRUNTIME);
+
+            action("将剩余线程出队");
+            tassert(scheduler
+                        .dequeue(util::nnullforce(&rq),
+                                 util::nnullforce(&ahead))
+                        .has_value(),
+                    "线程出队成功");
+            ttest(rq.nr_queued() == 0);
+            ttest(rq.cfs.load_weight == 0);
+            ttest(!scheduler
+                       .dequeue(util::nnullforce(&rq),
+                                util::nnullforce(&ahead))
+                       .has_value());
+        }
+    };
+
+    class CaseSleeperCredit : public TestCase {
+    public:
+        CaseSleeperCredit() : TestCase("CFS 唤醒线程的补偿有上限") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            Policy scheduler;
+            schd::RQ rq{};
+            rq.cfs.min_vruntime = 100 * schd::cfs::TICK_VRUNTIME;
+            TestThread sleeper{};
+
+            expect("长时间睡眠的线程入队时被拉至基准之前 SLEEPER_CREDIT 处");
+            tassert(scheduler
+                        .enqueue(util::nnullforce(&rq),
+                                 util::nnullforce(&sleeper))
+                        .has_value(),
+                    "线程入队成功");
+            ttest(sleeper.cfs_entity.vruntime ==
+                  rq.cfs.min_vruntime - Policy::SLEEPER_CREDIT);
+
+            expect("落后较多的线程被唤醒时抢占当前线程");
+            TestThread current{};
+            current.cfs_entity.vruntime = rq.cfs.min_vruntime;
+            ttest(scheduler.check_preempt_wakeup(util::nnullforce(&rq),
+                                                 util::nnullforce(&current),
+                                                 util::nnullforce(&sleeper)));
+            ttest(!scheduler.check_preempt_wakeup(util::nnullforce(&rq),
+                                                  util::nnullforce(&sleeper),
+                                                  util::nnullforce(&current)));
+        }
+    };
+
+    class CaseWeightedShare : public TestCase {
+    public:
+        CaseWeightedShare() : TestCase("CFS 按 nice 权重分配 CPU") {}
+
+        constexpr static size_t TICKS = 3000;
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            Policy scheduler;
+            schd::RQ rq{};
+            TestThread heavy{};
+            TestThread light{};
+
+            tassert(scheduler
+                        .enqueue(util::nnullforce(&rq),
+                                 util::nnullforce(&heavy))
+                        .has_value(),
+                    "nice 0 线程入队成功");
+            tassert(scheduler
+                        .enqueue(util::nnullforce(&rq),
+                                 util::nnullforce(&light))
+                        .has_value(),
+                    "nice 5 线程入队成功");
+
+            action("在队列中将第二个线程的 nice 调整为 5");
+            tassert(scheduler
+                        .set_nice(util::nnullforce(&rq),
+                                  util::nnullforce(&light), 5)
+                        .has_value(),
+                    "调整 nice 成功");
+            ttest(light.cfs_entity.weight == schd::cfs::weight_of(5));
+            ttest(rq.cfs.load_weight ==
+                  schd::cfs::NICE_0_WEIGHT + schd::cfs::weight_of(5));
+            ttest(!scheduler
+                       .set_nice(util::nnullforce(&rq),
+                                 util::nnullforce(&light), 20)
+                       .has_value());
+
+            action("模拟运行若干时钟中断");
+            auto next = scheduler.pick_next(util::nnullforce(&rq));
+            tassert(next.has_value(), "成功取到可运行线程");
+            TestThread* current = next.value();
+            for (size_t tick = 0; tick < TICKS; ++tick) {
+                current->ran++;
+                tassert(scheduler
+                            .on_tick(util::nnullforce(&rq),
+                                     util::nnullforce(current))
+                            .has_value(),
+                        "on_tick 调用成功");
+                if (!current->basic_entity
+                         .flags_check<schd::SchedMeta::FLAGS_NEED_RESCHED>())
+                {
+                    continue;
+                }
+                current->basic_entity
+                    .flags_reset<schd::SchedMeta::FLAGS_NEED_RESCHED>();
+                tassert(scheduler
+                            .put_prev(util::nnullforce(&rq),
+                                      util::nnullforce(current))
+                            .has_value(),
+                        "put_prev 调用成功");
+                next = scheduler.pick_next(util::nnullforce(&rq));
+                tassert(next.has_value(), "成功取到可运行线程");
+                current = next.value();
+            }
+
+            expect("两线程的运行时间之比接近权重之比 1024:335");
+            size_t expected_heavy = TICKS * schd::cfs::NICE_0_WEIGHT /
+                                    (schd::cfs::NICE_0_WEIGHT +
+                                     schd::cfs::weight_of(5));
+            size_t diff = heavy.ran > expected_heavy
+                              ? heavy.ran - expected_heavy
+                              : expected_heavy - heavy.ran;
+            ttest(heavy.ran + light.ran == TICKS);
+            ttest(diff <= TICKS / 50);
+        }
+    };
+
+    void collect_tests(TestFramework& framework) {
+        auto cases = util::ArrayList<TestCase*>();
+        cases.push_back(new CaseEmptyQueue());
+        cases.push_back(new CaseVruntimeOrder());
+        cases.push_back(new CaseSleeperCredit());
+        cases.push_back(new CaseWeightedShare());
+        framework.add_category(new TestCategory("schd.cfs", std::move(cases)));
+    }
+}  // namespace test::schd_test::cfs
@@ -0,0 +1,13 @@
+/**
+ * @file cfs.h
+ * @author
+ * @brief CFS 调度器测试
+ */
+
+#pragma once
+
+#include <test/framework.h>
+
+namespace test::schd_test::cfs {
+    void collect_tests(TestFramework& framework);
+}
@@ -0,0 +1,262 @@
+/**
+ * @file dl.cpp
+ * @brief DL 调度器截止时间排序, 准入控制, 节流与错过计数测试
+ */
+
+#include <schd/dl.h>
+#include <test/schd/dl.h>
+
+namespace test::schd_test::dl {
+    struct TestThread {
+        schd::SchedMeta basic_entity{};
+        schd::dl::Entity dl_entity{};
+    };
+
+    using Policy = schd::dl::DL<TestThread>;
+
+    // 经准入检查后以给定参数进入 DL
+    static bool attach(Policy& scheduler, schd::RQ& rq, TestThread& thread,
+                       size_t runtime, size_t period, size_t deadline) {
+        auto admit_res = scheduler.admit(util::nnullforce(&rq),
+                                         util::nnullforce(&thread), runtime,
+                                         period, deadline);
+        if (!admit_res.has_value()) {
+            return false;
+        }
+        scheduler.attach(util::nnullforce(&rq), util::nnullforce(&thread),
+                         runtime, period, deadline);
+        return true;
+    }
+
+    class CaseEdfOrder : public TestCase {
+    public:
+        CaseEdfOrder() : TestCase("DL 按截止时间选择线程") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            Policy scheduler;
+            schd::RQ rq{};
+            TestThread relaxed{};
+            TestThread urgent{};
+
+            expect("在没有就绪线程时尝试取下一个线程");
+            ttest(!scheduler.pick_next(util::nnullforce(&rq)).has_value());
+
+            tassert(attach(scheduler, rq, relaxed, 2, 20, 20),
+                    "截止时间较晚的线程准入成功");
+            tassert(attach(scheduler, rq, urgent, 1, 10, 5),
+                    "截止时间较早的线程准入成功");
+            tassert(scheduler
+                        .enqueue(util::nnullforce(&rq),
+                                 util::nnullforce(&relaxed))
+                        .has_value(),
+                    "第一个线程入队成功");
+            tassert(scheduler
+                        .enqueue(util::nnullforce(&rq),
+                                 util::nnullforce(&urgent))
+                        .has_value(),
+                    "第二个线程入队成功");
+            ttest(rq.nr_queued() == 2);
+
+            expect("截止时间较早的线程先被选中, 且可抢占较晚者");
+            ttest(scheduler.check_preempt_wakeup(util::nnullforce(&rq),
+                                                 util::nnullforce(&relaxed),
+                                                 util::nnullforce(&urgent)));
+            ttest(!scheduler.check_preempt_wakeup(util::nnullforce(&rq),
+                                                  util::nnullforce(&urgent),
+                                                  util::nnullforce(&relaxed)));
+            auto next = scheduler.pick_next(util::nnullforce(&rq));
+            tassert(next.has_value(), "成功取到可运行线程");
+            ttest(next.value() == &urgent);
+            ttest(urgent.basic_entity.state == ThreadState::RUNNING);
+            ttest(!urgent.dl_entity.queued);
+        }
+    };
+
+    class CaseAdmission : public TestCase {
+    public:
+        CaseAdmission() : TestCase("DL 准入控制") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            Policy scheduler;
+            schd::RQ rq{};
+            TestThread a{};
+            TestThread b{};
+            TestThread c{};
+
+            expect("参数须满足 0 < runtime <= deadline <= period");
+            ttest(!attach(scheduler, rq, a, 0, 10, 10));
+            ttest(!attach(scheduler, rq, a, 6, 10, 5));
+            ttest(!attach(scheduler, rq, a, 2, 10, 12));
+            ttest(rq.dl.total_bw == 0);
+
+            expect("带宽之和不超过上限时准入, 超过时拒绝");
+            ttest(attach(scheduler, rq, a, 5, 10, 10));
+            ttest(attach(scheduler, rq, b, 4, 10, 10));
+            ttest(!attach(scheduler, rq, c, 1, 10, 10));
+            ttest(rq.dl.total_bw == schd::dl::bandwidth(5, 10) +
+                                       schd::dl::bandwidth(4, 10));
+
+            expect("修改参数时替换线程原有的带宽");
+            ttest(attach(scheduler, rq, a, 5, 10, 10));
+            ttest(attach(scheduler, rq, a, 4, 10, 10));
+
+            action("释放一个线程的带宽后重新准入");
+            scheduler.detach(util::nnullforce(&rq), util::nnullforce(&b));
+            ttest(rq.dl.total_bw == schd::dl::bandwidth(4, 10));
+            ttest(attach(scheduler, rq, c, 1, 10, 10));
+        }
+    };
+
+    class CaseThrottle : public TestCase {
+    public:
+        CaseThrottle() : TestCase("DL 预算用尽后节流至下一周期") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            Policy scheduler;
+            schd::RQ rq{};
+            TestThread thread{};
+
+            tassert(attach(scheduler, rq, thread, 2, 10, 10), "准入成功");
+            tassert(scheduler
+                        .enqueue(util::nnullforce(&rq),
+                                 util::nnullforce(&thread))
+                        .has_value(),
+                    "线程入队成功");
+            auto next = scheduler.pick_next(util::nnullforce(&rq));
+            tassert(next.has_value(), "成功取到可运行线程");
+
+            action("运行两个时钟中断以耗尽预算");
+            for (uint64_t now = 1; now <= 2; ++now) {
+                ttest(scheduler.update_clock(util::nnullforce(&rq), now) ==
+                      nullptr);
+                tassert(scheduler
+                            .on_tick(util::nnullforce(&rq),
+                                     util::nnullforce(&thread))
+                            .has_value(),
+                        "on_tick 调用成功");
+            }
+            ttest(thread.dl_entity.throttled);
+            ttest(thread.basic_entity
+                      .flags_check<schd::SchedMeta::FLAGS_NEED_RESCHED>());
+
+            expect("被节流的线程放回后不可运行");
+            tassert(scheduler
+                        .put_prev(util::nnullforce(&rq),
+                                  util::nnullforce(&thread))
+                        .has_value(),
+                    "put_prev 调用成功");
+            ttest(rq.nr_queued() == 0);
+            ttest(!scheduler.pick_next(util::nnullforce(&rq)).has_value());
+            ttest(scheduler.update_clock(util::nnullforce(&rq), 9) ==
+                  nullptr);
+
+            expect("下一周期开始时补充预算并重新就绪");
+            ttest(scheduler.update_clock(util::nnullforce(&rq), 10) ==
+                  &thread);
+            ttest(!thread.dl_entity.throttled);
+            ttest(thread.dl_entity.runtime_left == 2);
+            ttest(thread.dl_entity.deadline == 20);
+            ttest(rq.nr_queued() == 1);
+            ttest(thread.dl_entity.misses == 0);
+        }
+    };
+
+    class CaseDeadlineMiss : public TestCase {
+    public:
+        CaseDeadlineMiss() : TestCase("DL 错过截止时间的计数") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            Policy scheduler;
+            schd::RQ rq{};
+            TestThread thread{};
+
+            tassert(attach(scheduler, rq, thread, 2, 10, 3), "准入成功");
+            tassert(scheduler
+                        .enqueue(util::nnullforce(&rq),
+                                 util::nnullforce(&thread))
+                        .has_value(),
+                    "线程入队成功");
+
+            action("线程直到截止时间才得到运行");
+            scheduler.update_clock(util::nnullforce(&rq), 3);
+            auto next = scheduler.pick_next(util::nnullforce(&rq));
+            tassert(next.has_value(), "成功取到可运行线程");
+            tassert(scheduler
+                        .on_tick(util::nnullforce(&rq),
+                                 util::nnullforce(&thread))
+                        .has_value(),
+                    "on_tick 调用成功");
+
+            expect("越过截止时间仍有剩余预算, 记一次错过");
+            ttest(thread.dl_entity.misses == 1);
+            ttest(rq.dl.nr_missed == 1);
+
+            expect("同一作业不重复计数");
+            scheduler.update_clock(util::nnullforce(&rq), 4);
+            tassert(scheduler
+                        .on_tick(util::nnullforce(&rq),
+                                 util::nnullforce(&thread))
+                        .has_value(),
+                    "on_tick 调用成功");
+            ttest(thread.dl_entity.throttled);
+            ttest(thread.dl_entity.misses == 1);
+            ttest(rq.dl.nr_missed == 1);
+        }
+    };
+
+    class CaseCbsWakeup : public TestCase {
+    public:
+        CaseCbsWakeup() : TestCase("DL 唤醒时按 CBS 规则重置截止时间") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            Policy scheduler;
+            schd::RQ rq{};
+            TestThread thread{};
+
+            tassert(attach(scheduler, rq, thread, 2, 10, 10), "准入成功");
+
+            expect("剩余预算在截止时间前可按原带宽用完时沿用原截止时间");
+            thread.dl_entity.runtime_left = 1;
+            scheduler.update_clock(util::nnullforce(&rq), 5);
+            tassert(scheduler
+                        .enqueue(util::nnullforce(&rq),
+                                 util::nnullforce(&thread))
+                        .has_value(),
+                    "线程入队成功");
+            ttest(thread.dl_entity.deadline == 10);
+            tassert(scheduler
+                        .dequeue(util::nnullforce(&rq),
+                                 util::nnullforce(&thread))
+                        .has_value(),
+                    "线程出队成功");
+
+            expect("否则开始新作业, 截止时间从唤醒时刻起算");
+            scheduler.update_clock(util::nnullforce(&rq), 8);
+            tassert(scheduler
+                        .enqueue(util::nnullforce(&rq),
+                                 util::nnullforce(&thread))
+                        .has_value(),
+                    "线程入队成功");
+            ttest(thread.dl_entity.deadline == 18);
+            ttest(thread.dl_entity.runtime_left == 2);
+
+            expect("主动让出表示作业完成, 节流至下一周期");
+            auto next = scheduler.pick_next(util::nnullforce(&rq));
+            tassert(next.has_value(), "成功取到可运行线程");
+            tassert(scheduler.yield(util::nnullforce(&rq)).has_value(),
+                    "yield 调用成功");
+            ttest(thread.dl_entity.throttled);
+            ttest(thread.dl_entity.runtime_left == 0);
+        }
+    };
+
+    void collect_tests(TestFramework& framework) {
+        auto cases = util::ArrayList<TestCase*>();
+        cases.push_back(new CaseEdfOrder());
+        cases.push_back(new CaseAdmission());
+        cases.push_back(new CaseThrottle());
+        cases.push_back(new CaseDeadlineMiss());
+        cases.push_back(new CaseCbsWakeup());
+        framework.add_category(new TestCategory("schd.dl", std::move(cases)));
+    }
+}  // namespace test::schd_test::dl
@@ -0,0 +1,13 @@
+/**
+ * @file dl.h
+ * @author
+ * @brief DL 调度器测试
+ */
+
+#pragma once
+
+#include <test/framework.h>
+
+namespace test::schd_test::dl {
+    void collect_tests(TestFramework& framework);
+}
@@ -1 +1 @@
-sources += fcfs.cpp rr.cpp
+sources += cfs.cpp dl.cpp fcfs.cpp rr.cpp
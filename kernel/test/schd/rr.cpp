@@ -73,21 +73,141 @@ namespace test::schd_test::rr {
                                       util::nnullforce(&second)).has_value(),
                     "第二个线程入队成功");
 
-            ttest(rq.rr_list.size() == 2);
+            ttest(rq.rr.nr == 2);
 
             tassert(scheduler.dequeue(util::nnullforce(&rq),
                                       util::nnullforce(&second)).has_value(),
                     "第二个线程出队成功");
-            ttest(rq.rr_list.size() == 1);
+            ttest(rq.rr.nr == 1);
             ttest(second.basic_entity.state == ThreadState::EMPTY);
         }
     };
 
+    class CasePriority : public TestCase {
+    public:
+        CasePriority() : TestCase("RR 多优先级选择与调整") {}
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            schd::rr::RR<TestThread> scheduler;
+            schd::RQ rq{};
+            TestThread low{};
+            TestThread mid{};
+            TestThread high{};
+            low.rr_entity.prio  = 1;
+            mid.rr_entity.prio  = 5;
+            high.rr_entity.prio = 9;
+
+            for (TestThread* thread : {&low, &mid, &high}) {
+                tassert(scheduler
+                            .enqueue(util::nnullforce(&rq),
+                                     util::nnullforce(thread))
+                            .has_value(),
+                        "线程入队成功");
+            }
+            ttest(rq.rr.nr == 3);
+            ttest(rq.rr.bitmap == ((1u << 1) | (1u << 5) | (1u << 9)));
+            ttest(scheduler.last(util::nnullforce(&rq)) == &high);
+
+            expect("重复入队应失败");
+            ttest(!scheduler
+                       .enqueue(util::nnullforce(&rq),
+                                util::nnullforce(&mid))
+                       .has_value());
+
+            action("将低优先级线程提升到最高");
+            tassert(scheduler
+                        .set_prio(util::nnullforce(&rq),
+                                  util::nnullforce(&low), 12)
+                        .has_value(),
+                    "调整优先级成功");
+            ttest(rq.rr.bitmap == ((1u << 5) | (1u << 9) | (1u << 12)));
+            ttest(!scheduler
+                       .set_prio(util::nnullforce(&rq),
+                                 util::nnullforce(&low),
+                                 schd::rr::NR_PRIOS)
+                       .has_value());
+
+            expect("按优先级从高到低依次选中");
+            auto next = scheduler.pick_next(util::nnullforce(&rq));
+            tassert(next.has_value(), "取到第一个线程");
+            ttest(next.value() == &low);
+            next = scheduler.pick_next(util::nnullforce(&rq));
+            tassert(next.has_value(), "取到第二个线程");
+            ttest(next.value() == &high);
+
+            expect("高优先级线程就绪时抢占同类的低优先级线程");
+            ttest(scheduler.check_preempt_wakeup(util::nnullforce(&rq),
+                                                 util::nnullforce(&mid),
+                                                 util::nnullforce(&high)));
+            ttest(!scheduler.check_preempt_wakeup(util::nnullforce(&rq),
+                                                  util::nnullforce(&high),
+                                                  util::nnullforce(&mid)));
+
+            action("移出最后一个线程");
+            tassert(scheduler
+                        .dequeue(util::nnullforce(&rq),
+                                 util::nnullforce(&mid))
+                        .has_value(),
+                    "线程出队成功");
+            ttest(rq.rr.nr == 0);
+            ttest(rq.rr.bitmap == 0);
+        }
+    };
+
+    class CaseManyThreads : public TestCase {
+    public:
+        CaseManyThreads() : TestCase("RR 数百线程的入队出队") {}
+
+        constexpr static size_t NUM_THREADS = 512;
+
+        mutable TestThread threads[NUM_THREADS];
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            schd::rr::RR<TestThread> scheduler;
+            schd::RQ rq{};
+
+            for (size_t i = 0; i < NUM_THREADS; ++i) {
+                threads[i]                = {};
+                threads[i].rr_entity.prio = i % schd::rr::NR_PRIOS;
+                tassert(scheduler
+                            .enqueue(util::nnullforce(&rq),
+                                     util::nnullforce(&threads[i]))
+                            .has_value(),
+                        "线程入队成功");
+            }
+            ttest(rq.rr.nr == NUM_THREADS);
+            ttest(rq.rr.bitmap == 0xFFFF'FFFFu);
+
+            action("从队列中部移出奇数编号的线程");
+            for (size_t i = 1; i < NUM_THREADS; i += 2) {
+                tassert(scheduler
+                            .dequeue(util::nnullforce(&rq),
+                                     util::nnullforce(&threads[i]))
+                            .has_value(),
+                        "线程出队成功");
+            }
+            ttest(rq.rr.nr == NUM_THREADS / 2);
+
+            expect("剩余线程按优先级非增的次序被选中");
+            size_t prev_prio = schd::rr::NR_PRIOS;
+            for (size_t i = 0; i < NUM_THREADS / 2; ++i) {
+                auto next = scheduler.pick_next(util::nnullforce(&rq));
+                tassert(next.has_value(), "取到可运行线程");
+                ttest(next.value()->rr_entity.prio <= prev_prio);
+                prev_prio = next.value()->rr_entity.prio;
+            }
+            ttest(rq.rr.nr == 0);
+            ttest(rq.rr.bitmap == 0);
+        }
+    };
+
     void collect_tests(TestFramework& framework) {
         auto cases = util::ArrayList<TestCase*>();
         cases.push_back(new CaseEmptyQueue());
         cases.push_back(new CaseTimeSlice());
         cases.push_back(new CaseQueueOps());
+        cases.push_back(new CasePriority());
+        cases.push_back(new CaseManyThreads());
         framework.add_category(new TestCategory("schd.rr", std::move(cases)));
     }
 
@@ -25,6 +25,18 @@ namespace test::slub {
         char data[3000];
     };
 
+    struct Slub1KObj {
+        char data[1024];
+    };
+
+    struct Slub1536Obj {
+        char data[1536];
+    };
+
+    struct Slub2KObj {
+        char data[2048];
+    };
+
     class CaseSmallObjAlloc : public TestCase {
     public:
         CaseSmallObjAlloc() : TestCase("SLUB 小对象分配与释放") {}
@@ -190,7 +202,7 @@ namespace test::slub {
                 }
             }
 
-            action("交错释放一半对象, 触发 AllocRecord 复用");
+            action("交错释放一半对象, 触发页描述符复用");
             for (int round = 0; round < kRounds; round += 2) {
                 for (int i = 0; i < kSizeCount; ++i) {
                     if (ptrs[round][i] != nullptr) {
@@ -211,7 +223,7 @@ namespace test::slub {
                 }
             }
 
-            action("释放所有对象, 验证分配记录可查找并移除");
+            action("释放所有对象, 验证页描述符可正确定位尺寸类");
             for (int round = 0; round < kRounds; ++round) {
                 for (int i = 0; i < kSizeCount; ++i) {
                     if (ptrs[round][i] != nullptr) {
@@ -225,14 +237,157 @@ namespace test::slub {
         }
     };
 
+    class CaseMixedAllocatorFreeLookup : public TestCase {
+    public:
+        CaseMixedAllocatorFreeLookup()
+            : TestCase("SLUB 全局释放由页描述符定位 slab") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kLiveCounts[] = {16, 256, 4096};
+            constexpr int kLevels =
+                sizeof(kLiveCounts) / sizeof(kLiveCounts[0]);
+            constexpr size_t kMaxLive = kLiveCounts[kLevels - 1];
+            constexpr int kProbes     = 256;
+
+            // 指针表放在堆上, 避免撑爆内核栈
+            void** live =
+                static_cast<void**>(Allocator::malloc(kMaxLive * sizeof(void*)));
+            tassert(live != nullptr, "无法分配指针表");
+            void* probes[kProbes] = {};
+
+            size_t live_cnt = 0;
+            for (int level = 0; level < kLevels; ++level) {
+                action("扩充存活对象数量");
+                for (; live_cnt < kLiveCounts[level]; ++live_cnt) {
+                    live[live_cnt] = Allocator::malloc(64);
+                    if (live[live_cnt] == nullptr) {
+                        test(false, "Allocator 分配失败");
+                        break;
+                    }
+                }
+
+                expect("在当前存活对象规模下穿插分配与释放");
+                for (int i = 0; i < kProbes; ++i) {
+                    probes[i] = Allocator::malloc(64);
+                }
+                for (int i = kProbes - 1; i >= 0; --i) {
+                    Allocator::free(probes[i]);
+                }
+            }
+
+            check("每个存活对象的尺寸类由其所在页的描述符给出");
+            size_t resolved = 0;
+            for (size_t i = 0; i < live_cnt; ++i) {
+                void* page = KpaAddr(live[i]).page_align_down().addr();
+                ::slub::SlabHeader* slab =
+                    ::slub::SlabPageTable::slab_of(live[i]);
+                if (slab != nullptr && slab->obj_size == 64 &&
+                    ::slub::SlabPageTable::slab_of(page) == slab)
+                {
+                    resolved++;
+                }
+            }
+            test(resolved == live_cnt, "存在无法由页描述符定位的对象");
+
+            for (size_t i = 0; i < live_cnt; ++i) {
+                Allocator::free(live[i]);
+            }
+            Allocator::free(live);
+        }
+    };
+
+    class CaseOffSlabLayout : public TestCase {
+    public:
+        CaseOffSlabLayout() : TestCase("SLUB 大尺寸类 off-slab 布局与利用率") {}
+
+        template <typename Obj>
+        void check_layout(const char* name) const {
+            ::slub::SlubAllocator<Obj> alloc;
+            constexpr int kCount = 8;
+            Obj* objs[kCount]    = {nullptr};
+
+            expect(std::string("分配 8 个对象: ") + name);
+            for (int i = 0; i < kCount; i++) {
+                objs[i] = alloc.alloc();
+                test(objs[i] != nullptr, "分配成功");
+            }
+
+            auto stats = alloc.get_stats();
+            kprintfln("    %s: %u 页/slab, %u slab, 满载利用率 %u‰, off-slab=%d",
+                      name, static_cast<unsigned int>(stats.pages_per_slab),
+                      static_cast<unsigned int>(stats.total_slabs),
+                      static_cast<unsigned int>(stats.full_utilization()),
+                      stats.off_slab ? 1 : 0);
+            check("头部应放在 slab 之外, 且满载利用率不低于 90%");
+            ttest(stats.off_slab);
+            ttest(stats.full_utilization() >= 900);
+            ttest(stats.objects_inuse == kCount);
+
+            for (int i = 0; i < kCount; i++) {
+                if (objs[i]) alloc.free(objs[i]);
+            }
+            ttest(alloc.get_stats().objects_inuse == 0);
+        }
+
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            check_layout<Slub1KObj>("1024B");
+            check_layout<Slub1536Obj>("1536B");
+            check_layout<Slub2KObj>("2048B");
+        }
+    };
+
+    class CaseMagazine : public TestCase {
+    public:
+        CaseMagazine() : TestCase("SLUB per-CPU magazine 命中与批量交换") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            ::slub::SlubAllocator<SlubSmallObj> alloc;
+            constexpr int kPairs = 100;
+
+            expect("反复分配并立即释放同一类对象, 应几乎全部命中 magazine");
+            for (int i = 0; i < kPairs; i++) {
+                SlubSmallObj* p = alloc.alloc();
+                tassert(p != nullptr, "分配失败");
+                alloc.free(p);
+            }
+            auto stats = alloc.get_stats();
+            ttest(stats.magazine_misses == 1);
+            ttest(stats.magazine_hits == kPairs * 2 - 1);
+            ttest(stats.objects_inuse == 0);
+            ttest(stats.objects_cached > 0);
+
+            action("连续分配 64 个对象后全部释放, 触发批量补充与归还");
+            constexpr int kBurst     = 64;
+            SlubSmallObj* objs[kBurst] = {nullptr};
+            for (int i = 0; i < kBurst; i++) {
+                objs[i] = alloc.alloc();
+                test(objs[i] != nullptr, "分配成功");
+            }
+            for (int i = 0; i < kBurst; i++) {
+                if (objs[i]) alloc.free(objs[i]);
+            }
+            auto burst = alloc.get_stats();
+            ttest(burst.magazine_misses > stats.magazine_misses);
+            ttest(burst.objects_inuse == 0);
+
+            action("清空 magazine");
+            alloc.drain();
+            check("所有对象均应回到 slab");
+            auto drained = alloc.get_stats();
+            ttest(drained.objects_cached == 0);
+            ttest(drained.objects_inuse == 0);
+        }
+    };
+
     void collect_tests(TestFramework& framework) {
         auto cases = util::ArrayList<TestCase*>();
         cases.push_back(new CaseSmallObjAlloc());
         cases.push_back(new CaseObjectReuse());
         cases.push_back(new CaseHugeObjPath());
         cases.push_back(new CaseMultiSlab());
+        cases.push_back(new CaseOffSlabLayout());
         cases.push_back(new CaseStressFreelist());
+        cases.push_back(new CaseMagazine());
         cases.push_back(new CaseMixedAllocatorRecords());
+        cases.push_back(new CaseMixedAllocatorFreeLookup());
 
         framework.add_category(new TestCategory("slub", std::move(cases)));
     }
@@ -139,11 +139,96 @@ namespace test::tree {
         }
     };
 
+    struct RBItem {
+        util::rbtree::RBNode<RBItem> rb_node;
+        int key     = 0;
+        bool linked = false;
+    };
+
+    struct RBItemOrder {
+        bool operator()(const RBItem &lhs, const RBItem &rhs) const {
+            return lhs.key < rhs.key;
+        }
+    };
+
+    class CaseRBTree : public TestCase {
+    public:
+        CaseRBTree() : TestCase("RBTree 随机插入删除与有序查找") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            using Tree = util::rbtree::RBTree<RBItem, &RBItem::rb_node,
+                                              RBItemOrder>;
+            constexpr size_t N = 256;
+            static RBItem items[N];
+            Tree tree;
+
+            expect("随机插入与删除后红黑性质保持, 中序有序");
+            uint32_t seed = 12345;
+            auto rand     = [&seed]() {
+                seed = seed * 1103515245 + 12345;
+                return seed >> 8;
+            };
+            size_t linked = 0;
+            for (int round = 0; round < 4096; round++) {
+                RBItem &item = items[rand() % N];
+                if (item.linked) {
+                    tree.remove(item);
+                    item.linked = false;
+                    linked--;
+                } else {
+                    item.key = static_cast<int>(rand() % 128);
+                    tree.insert(item);
+                    item.linked = true;
+                    linked++;
+                }
+            }
+            ttest(tree.validate());
+            ttest(tree.size() == linked);
+
+            size_t count = 0;
+            int prev_key = -1;
+            bool sorted  = true;
+            for (RBItem *it = tree.first(); it != nullptr;
+                 it         = Tree::next(it))
+            {
+                sorted   = sorted && it->key >= prev_key;
+                prev_key = it->key;
+                count++;
+            }
+            ttest(sorted);
+            ttest(count == linked);
+
+            check("last_such_that 求 floor");
+            for (int q = 0; q < 128; q += 7) {
+                RBItem *floor = tree.last_such_that(
+                    [q](const RBItem &it) { return it.key <= q; });
+                int expect_key = -1;
+                for (auto &item : items) {
+                    if (item.linked && item.key <= q && item.key > expect_key) {
+                        expect_key = item.key;
+                    }
+                }
+                ttest(expect_key < 0 ? floor == nullptr
+                                     : floor != nullptr &&
+                                           floor->key == expect_key);
+            }
+
+            action("清空");
+            for (auto &item : items) {
+                if (item.linked) {
+                    tree.remove(item);
+                    item.linked = false;
+                }
+            }
+            ttest(tree.empty() && tree.validate());
+        }
+    };
+
     void collect_tests(TestFramework &framework) {
         auto cases = util::ArrayList<TestCase *>();
         cases.push_back(new CaseTreeStructure());
         cases.push_back(new CaseTreeLCA());
         cases.push_back(new CaseTreeBaseMulti());
+        cases.push_back(new CaseRBTree());
 
         framework.add_category(new TestCategory("tree", std::move(cases)));
     }
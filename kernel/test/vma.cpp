@@ -0,0 +1,629 @@
+/**
+ * @file vma.cpp
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief VMA 管理测试
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <mem/gfp.h>
+#include <mem/vma.h>
+#include <object/memory.h>
+#include <test/vma.h>
+
+#include <cstring>
+
+namespace test::vma {
+    class CaseVmaIndex : public TestCase {
+    public:
+        CaseVmaIndex() : TestCase("TMM 大量 VMA 下的按地址定位") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kVmas = 512;
+            const VirAddr base(0x10000000);
+
+            auto pgd_res = GFP::get_free_page(1);
+            tassert(pgd_res.has_value(), "分配页表根");
+            auto* tmm = new TaskMemoryManager(pgd_res.value());
+
+            expect("以一页间隔建立 512 个单页 VMA");
+            for (size_t i = 0; i < kVmas; i++) {
+                VirAddr begin = base + i * 2 * PAGESIZE;
+                auto* memory  = new cap::MemoryPayload(
+                    PAGESIZE, false, false, cap::MemoryGrowth::FIXED);
+                auto add_res =
+                    tmm->add_vma(VMA::Type::DATA, VMA::Growth::FIXED,
+                                 VirArea(begin, begin + PAGESIZE), memory,
+                                 PageMan::RWX::RW);
+                tassert(add_res.has_value(), "添加 VMA");
+            }
+
+            check("重叠区域应被拒绝");
+            auto* dup = new cap::MemoryPayload(PAGESIZE, false, false,
+                                               cap::MemoryGrowth::FIXED);
+            auto dup_res = tmm->add_vma(
+                VMA::Type::DATA, VMA::Growth::FIXED,
+                VirArea(base + PAGESIZE / 2, base + PAGESIZE * 3 / 2), dup,
+                PageMan::RWX::RW);
+            ttest(!dup_res.has_value() && dup_res.error() == ErrCode::BUSY);
+            delete dup;
+
+            check("VMA 内地址命中, 间隙地址未命中");
+            for (size_t i = 0; i < kVmas; i++) {
+                VirAddr inside = base + i * 2 * PAGESIZE + 0x123;
+                auto res       = tmm->locate(inside);
+                ttest(res.has_value() &&
+                      res.value()->varea.begin == inside.page_align_down());
+                auto gap = tmm->locate(base + (i * 2 + 1) * PAGESIZE);
+                ttest(!gap.has_value());
+            }
+
+            for (size_t i = 0; i < kVmas; i++) {
+                ttest(tmm->locate(base + i * 8).has_value());
+            }
+
+            action("删除与扩展后索引保持一致");
+            auto mid = tmm->locate(base + kVmas * PAGESIZE);
+            tassert(mid.has_value(), "定位中间 VMA");
+            VMA* victim = mid.value();
+            ttest(tmm->remove_vma(util::nnullforce(victim)).has_value());
+            ttest(!tmm->locate(base + kVmas * PAGESIZE).has_value());
+            ttest(tmm->locate(base + (kVmas + 2) * PAGESIZE).has_value());
+
+            auto first = tmm->locate(base);
+            tassert(first.has_value(), "定位首个 VMA");
+            ttest(tmm->remove_vma(first.value()).has_value());
+            auto* flex = new cap::MemoryPayload(
+                PAGESIZE, false, false, cap::MemoryGrowth::FLEXUP);
+            auto flex_res = tmm->add_vma(VMA::Type::HEAP, VMA::Growth::FLEXUP,
+                                         VirArea(base, base + PAGESIZE), flex,
+                                         PageMan::RWX::RW);
+            tassert(flex_res.has_value(), "添加可增长 VMA");
+            auto grow_res = tmm->grow_vma(
+                flex_res.value(), VirArea(base, base + 2 * PAGESIZE));
+            ttest(grow_res.has_value());
+            ttest(tmm->locate(base + PAGESIZE).has_value() &&
+                  tmm->locate(base + PAGESIZE).value() == flex_res.value());
+            auto over_res = tmm->grow_vma(
+                flex_res.value(), VirArea(base, base + 3 * PAGESIZE));
+            ttest(!over_res.has_value() &&
+                  over_res.error() == ErrCode::BUSY);
+
+            delete tmm;
+            GFP::put_page(pgd_res.value(), 1);
+        }
+    };
+
+    class CaseAsid : public TestCase {
+    public:
+        CaseAsid() : TestCase("ASID 分配与代切换") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            using Context = AsidAllocator::Context;
+            kprintfln("ASID 位宽: %u", AsidAllocator::bits());
+
+            expect("新上下文取得当前代的 ASID");
+            Context a       = AsidAllocator::NO_CONTEXT;
+            Context b       = AsidAllocator::NO_CONTEXT;
+            uint16_t asid_a = AsidAllocator::acquire(a);
+            uint16_t asid_b = AsidAllocator::acquire(b);
+            ttest(AsidAllocator::live(a) && AsidAllocator::live(b));
+            ttest(AsidAllocator::acquire(a) == asid_a);
+
+            if (!AsidAllocator::supported()) {
+                check("硬件不支持 ASID 时均使用 0");
+                ttest(asid_a == 0 && asid_b == 0);
+                return;
+            }
+
+            check("不同上下文的 ASID 互不相同且不为 0");
+            ttest(asid_a != 0 && asid_b != 0 && asid_a != asid_b);
+
+            action("耗尽本代 ASID 以触发代切换");
+            const uint64_t origin = AsidAllocator::rollovers();
+            size_t budget         = (1ul << AsidAllocator::bits()) + 1;
+            // 代切换时本处理器正在运行的上下文
+            Context running       = AsidAllocator::NO_CONTEXT;
+            while (AsidAllocator::rollovers() == origin && budget-- > 0) {
+                Context tmp = AsidAllocator::NO_CONTEXT;
+                AsidAllocator::acquire(tmp);
+                if (AsidAllocator::rollovers() == origin) {
+                    running = tmp;
+                }
+            }
+            ttest(AsidAllocator::rollovers() == origin + 1);
+
+            check("旧代上下文失效, 重新分配后恢复有效");
+            ttest(!AsidAllocator::live(a) && !AsidAllocator::live(b));
+            ttest(!AsidAllocator::loaded(a));
+            AsidAllocator::acquire(a);
+            ttest(AsidAllocator::live(a) && AsidAllocator::asid_of(a) != 0);
+
+            check("正在运行的上下文保留其 ASID, 刷新时仍视为有效");
+            ttest(!AsidAllocator::live(running) &&
+                  AsidAllocator::loaded(running));
+            const uint16_t kept = AsidAllocator::asid_of(running);
+            AsidAllocator::acquire(running);
+            ttest(AsidAllocator::live(running) &&
+                  AsidAllocator::asid_of(running) == kept);
+            ttest(AsidAllocator::asid_of(a) != kept);
+        }
+    };
+
+    class CaseTlbGather : public TestCase {
+    public:
+        CaseTlbGather() : TestCase("批量 TLB 失效") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            const VirAddr base(0x10000000);
+            auto pgd_res = GFP::get_free_page(1);
+            tassert(pgd_res.has_value(), "分配页表根");
+            auto* tmm = new TaskMemoryManager(pgd_res.value());
+
+            expect("少量页逐页失效");
+            TlbStats before = TlbGather::stats();
+            {
+                TlbGather tlb(*tmm);
+                tlb.add_page(base);
+                tlb.add_page(base + PAGESIZE);
+                tlb.add_page(base + 8 * PAGESIZE);
+                ttest(tlb.pages() == 3);
+            }
+            TlbStats after = TlbGather::stats();
+            ttest(after.page_flushes == before.page_flushes + 3);
+            ttest(after.full_flushes == before.full_flushes);
+
+            check("超过阈值时退化为整个地址空间失效");
+            before = after;
+            {
+                TlbGather tlb(*tmm);
+                tlb.add_range(VirArea(
+                    base, base + (TlbGather::FULL_FLUSH_PAGES + 1) * PAGESIZE));
+            }
+            after = TlbGather::stats();
+            ttest(after.full_flushes == before.full_flushes + 1);
+            ttest(after.page_flushes == before.page_flushes);
+
+            check("区间过多时同样退化");
+            before = after;
+            {
+                TlbGather tlb(*tmm);
+                for (size_t i = 0; i <= TlbGather::MAX_RANGES; i++) {
+                    tlb.add_page(base + i * 2 * PAGESIZE);
+                }
+            }
+            after = TlbGather::stats();
+            ttest(after.full_flushes == before.full_flushes + 1);
+
+            check("摘下的页表页在刷新之后才归还");
+            auto table_res = GFP::get_free_page(1, GFP_ZERO);
+            tassert(table_res.has_value(), "分配页表页");
+            before = after;
+            {
+                TlbGather tlb(*tmm);
+                tlb.add_table(table_res.value());
+                ttest(GFP::ref_count(table_res.value()) == 1);
+            }
+            after = TlbGather::stats();
+            ttest(after.full_flushes == before.full_flushes + 1);
+            ttest(GFP::ref_count(table_res.value()) == 0);
+
+            delete tmm;
+            GFP::put_page(pgd_res.value(), 1);
+        }
+    };
+
+    class CasePageWalk : public TestCase {
+    public:
+        CasePageWalk() : TestCase("SV39 单次遍历的区间操作") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            // 跨越 2M 边界, 涉及三张末级页表
+            constexpr size_t kPages = 1100;
+            const VirAddr vbase(0x10000000 - 16 * PAGESIZE);
+            const PhyAddr pbase(0x80000000);
+
+            auto root_res = GFP::get_free_page(1);
+            tassert(root_res.has_value(), "分配页表根");
+            PageMan::make_root(root_res.value());
+            PageMan pman(root_res.value());
+
+            expect("区间映射后逐页查询结果一致");
+            pman.map_range<false>(vbase, pbase, kPages * PAGESIZE,
+                                  PageMan::RWX::RW, true, false);
+            for (size_t i = 0; i < kPages; i++) {
+                auto res = pman.query_page(vbase + i * PAGESIZE);
+                tassert(res.has_value(), "查询已映射页");
+                ttest(PageMan::get_physical_address(*res.value().pte) ==
+                      pbase + i * PAGESIZE);
+            }
+            ttest(!pman.query_page(vbase + kPages * PAGESIZE).has_value());
+            // 一张一级页表与四张末级页表
+            ttest(pman.table_pages() == 5);
+
+            check("遍历只访问区间内的有效叶项");
+            size_t visited = 0;
+            auto walk_res  = pman.for_each_pte<false>(
+                vbase - 64 * PAGESIZE, (kPages + 128) * PAGESIZE,
+                [&visited](VirAddr, PageMan::PTE& pte, PageMan::PageSize) {
+                    visited += pte.v ? 1 : 0;
+                    return true;
+                });
+            ttest(walk_res.has_value() && visited == kPages);
+
+            action("解除中间一段映射");
+            pman.unmap_range(vbase + 100 * PAGESIZE, 600 * PAGESIZE);
+            ttest(pman.query_page(vbase + 99 * PAGESIZE).has_value());
+            ttest(!pman.query_page(vbase + 100 * PAGESIZE).has_value());
+            ttest(!pman.query_page(vbase + 699 * PAGESIZE).has_value());
+            ttest(pman.query_page(vbase + 700 * PAGESIZE).has_value());
+            ttest(pman.table_pages() == 5);
+
+            check("全部解除后页表页均被归还");
+            pman.unmap_range(vbase, kPages * PAGESIZE);
+            ttest(pman.table_pages() == 0);
+            GFP::put_page(root_res.value(), 1);
+        }
+    };
+
+    class CaseHugePage : public TestCase {
+    public:
+        CaseHugePage() : TestCase("透明大页的映射与拆分") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kHuge = PageMan::psize(PageMan::PageSize::_2M);
+            const VirAddr base(0x40000000);
+            auto pgd_res = GFP::get_free_page(1);
+            tassert(pgd_res.has_value(), "分配页表根");
+            auto* tmm    = new TaskMemoryManager(pgd_res.value());
+            auto* memory = new cap::MemoryPayload(2 * kHuge, false, false,
+                                                  VMA::Growth::FLEXUP);
+            auto vma_res = tmm->add_vma(VMA::Type::HEAP, VMA::Growth::FLEXUP,
+                                        VirArea(base, base + 2 * kHuge),
+                                        memory, PageMan::RWX::RW);
+            tassert(vma_res.has_value(), "创建堆 VMA");
+
+            const VirAddr stack(base + 4 * kHuge);
+            auto* stack_mem = new cap::MemoryPayload(kHuge, false, false,
+                                                     VMA::Growth::GROW_DOWN);
+            tassert(tmm->add_vma(VMA::Type::STACK, VMA::Growth::GROW_DOWN,
+                                 VirArea(stack, stack + kHuge), stack_mem,
+                                 PageMan::RWX::RW)
+                        .has_value(),
+                    "创建栈 VMA");
+
+            expect("未设置 huge 的 VMA 即便覆盖整个窗口也以 4K 页映射");
+            ttest(!vma_res.value()->huge);
+            ttest(tmm->on_np({stack + kHuge - PAGESIZE, true}));
+            auto res = tmm->pman().query_page(stack + kHuge - PAGESIZE);
+            ttest(res.has_value() &&
+                  res.value().size == PageMan::PageSize::_4K);
+            ttest(stack_mem->allocated_size() == PAGESIZE);
+
+            action("设置 huge 后, 对齐的窗口以 2M 页映射");
+            vma_res.value()->huge = true;
+            // 读缺页同样以大页映射, 不因先映射零页而失去大页
+            ttest(tmm->on_np({base + 5 * PAGESIZE}));
+            ttest(tmm->on_np({base + kHuge + 7 * PAGESIZE, true}));
+            res = tmm->pman().query_page(base);
+            tassert(res.has_value(), "查询读缺页映射的大页");
+            ttest(res.value().size == PageMan::PageSize::_2M);
+            res = tmm->pman().query_page(base + kHuge);
+            tassert(res.has_value(), "查询大页");
+            ttest(res.value().size == PageMan::PageSize::_2M);
+            ttest(memory->allocated_size() == 2 * kHuge);
+
+            action("收缩到第二个大页中间");
+            const VirAddr cut = base + kHuge + 16 * PAGESIZE;
+            ttest(tmm->grow_vma(vma_res.value(), VirArea(base, cut))
+                      .has_value());
+
+            check("被截断的大页拆分为 4K 页, 其余大页不变");
+            res = tmm->pman().query_page(base);
+            ttest(res.has_value() &&
+                  res.value().size == PageMan::PageSize::_2M);
+            res = tmm->pman().query_page(cut - PAGESIZE);
+            ttest(res.has_value() &&
+                  res.value().size == PageMan::PageSize::_4K);
+            ttest(!tmm->pman().query_page(cut).has_value());
+
+            delete tmm;
+            GFP::put_page(pgd_res.value(), 1);
+        }
+    };
+
+    class CaseFaultAround : public TestCase {
+    public:
+        CaseFaultAround() : TestCase("缺页窗口内的批量映射") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kPages = 40;
+            const VirAddr base(0x10000000);
+            auto pgd_res = GFP::get_free_page(1);
+            tassert(pgd_res.has_value(), "分配页表根");
+            auto* tmm    = new TaskMemoryManager(pgd_res.value());
+            auto* memory = new cap::MemoryPayload(kPages * PAGESIZE, true,
+                                                  false, VMA::Growth::FIXED);
+            for (size_t i = 0; i < kPages; i++) {
+                tassert(memory->ensure_page(i * PAGESIZE).has_value(),
+                        "预先分配 Memory 页");
+            }
+            auto vma_res = tmm->add_vma(VMA::Type::SHARE_RW, VMA::Growth::FIXED,
+                                        VirArea(base, base + kPages * PAGESIZE),
+                                        memory, PageMan::RWX::RW);
+            tassert(vma_res.has_value(), "创建共享 VMA");
+
+            expect("一次缺页映射整个对齐窗口");
+            const size_t window = tmm->fault_around_pages();
+            ttest(window > 1 && window < kPages);
+            ttest(tmm->on_np({base + 3 * PAGESIZE}));
+            for (size_t i = 0; i < window; i++) {
+                auto res = tmm->pman().query_page(base + i * PAGESIZE);
+                ttest(res.has_value() &&
+                      PageMan::get_physical_address(*res.value().pte) ==
+                          memory->lookup_page(i * PAGESIZE).value());
+            }
+            ttest(!tmm->pman().query_page(base + window * PAGESIZE)
+                       .has_value());
+
+            check("顺序扫描每个窗口只缺页一次");
+            size_t faults = 1;
+            for (size_t i = window; i < kPages; i++) {
+                VirAddr vaddr = base + i * PAGESIZE;
+                if (!tmm->pman().query_page(vaddr).has_value()) {
+                    ttest(tmm->on_np({vaddr}));
+                    faults++;
+                }
+            }
+            ttest(faults == (kPages + window - 1) / window);
+
+            check("窗口大小须为 2 的幂");
+            ttest(!tmm->set_fault_around(3).has_value());
+            ttest(tmm->set_fault_around(1).has_value());
+
+            delete tmm;
+            GFP::put_page(pgd_res.value(), 1);
+        }
+    };
+
+    class CaseZeroPage : public TestCase {
+    public:
+        CaseZeroPage() : TestCase("读缺页映射共享零页") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kPages = 8;
+            const VirAddr base(0x10000000);
+            auto pgd_res = GFP::get_free_page(1);
+            tassert(pgd_res.has_value(), "分配页表根");
+            auto* tmm    = new TaskMemoryManager(pgd_res.value());
+            auto* memory = new cap::MemoryPayload(kPages * PAGESIZE, false,
+                                                  false, VMA::Growth::FLEXUP);
+            auto vma_res = tmm->add_vma(VMA::Type::HEAP, VMA::Growth::FLEXUP,
+                                        VirArea(base, base + kPages * PAGESIZE),
+                                        memory, PageMan::RWX::RW);
+            tassert(vma_res.has_value(), "创建堆 VMA");
+            const PhyAddr zero = GFP::zero_page();
+            tassert(zero.nonnull(), "零页已分配");
+
+            expect("读缺页映射只读的零页, 不分配物理页");
+            ttest(tmm->on_np({base + 2 * PAGESIZE}));
+            ttest(tmm->on_np({base + 5 * PAGESIZE}));
+            for (size_t i : {2, 5}) {
+                auto res = tmm->pman().query_page(base + i * PAGESIZE);
+                tassert(res.has_value(), "查询零页映射");
+                PageMan::PTE* pte = res.value().pte;
+                ttest(PageMan::get_physical_address(*pte) == zero);
+                ttest(!PageMan::is_writable(PageMan::rwx(*pte)));
+                ttest(PageMan::is_cow(*pte));
+            }
+            ttest(memory->allocated_size() == 0);
+
+            check("首次写入经 COW 分配实际的页");
+            ttest(tmm->on_wp(base + 2 * PAGESIZE));
+            auto res = tmm->pman().query_page(base + 2 * PAGESIZE);
+            tassert(res.has_value(), "查询写入后的映射");
+            PhyAddr paddr = PageMan::get_physical_address(*res.value().pte);
+            ttest(paddr != zero);
+            ttest(PageMan::is_writable(PageMan::rwx(*res.value().pte)));
+            ttest(memory->lookup_page(2 * PAGESIZE).value() == paddr);
+            ttest(memory->allocated_size() == PAGESIZE);
+
+            check("写缺页直接分配页");
+            ttest(tmm->on_np({base + 6 * PAGESIZE, true}));
+            res = tmm->pman().query_page(base + 6 * PAGESIZE);
+            ttest(res.has_value() &&
+                  PageMan::get_physical_address(*res.value().pte) != zero);
+
+            check("零页内容保持为 0");
+            const auto* words = convert<KpaAddr>(zero).as<uint64_t>();
+            bool clean        = true;
+            for (size_t i = 0; i < PAGESIZE / sizeof(uint64_t); i++) {
+                clean = clean && words[i] == 0;
+            }
+            ttest(clean);
+
+            delete tmm;
+            GFP::put_page(pgd_res.value(), 1);
+        }
+    };
+
+    class CaseBackedMemory : public TestCase {
+    public:
+        CaseBackedMemory() : TestCase("按需映射后备内容") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kPages = 3;
+            constexpr size_t kTail  = 100;
+            const VirAddr code(0x10000000);
+            const VirAddr data(0x20000000);
+            auto pgd_res  = GFP::get_free_page(1);
+            auto file_res = GFP::get_free_page(kPages);
+            tassert(pgd_res.has_value() && file_res.has_value(),
+                    "分配页表根与模拟文件内容");
+            const PhyAddr file = file_res.value();
+            auto* bytes        = convert<KpaAddr>(file).as<uint8_t>();
+            for (size_t i = 0; i < kPages * PAGESIZE; i++) {
+                bytes[i] = static_cast<uint8_t>(i * 7 + 1);
+            }
+            const size_t backing_size = 2 * PAGESIZE + kTail;
+
+            auto* tmm  = new TaskMemoryManager(pgd_res.value());
+            auto* text = new cap::MemoryPayload(kPages * PAGESIZE, false,
+                                                false, VMA::Growth::FIXED);
+            auto* vars = new cap::MemoryPayload(kPages * PAGESIZE, false,
+                                                false, VMA::Growth::FIXED);
+            text->set_backing(bytes, backing_size);
+            vars->set_backing(bytes, backing_size);
+            tassert(tmm->add_vma(VMA::Type::CODE, VMA::Growth::FIXED,
+                                 VirArea(code, code + kPages * PAGESIZE), text,
+                                 PageMan::RWX::RX)
+                        .has_value(),
+                    "创建代码段");
+            tassert(tmm->add_vma(VMA::Type::DATA, VMA::Growth::FIXED,
+                                 VirArea(data, data + kPages * PAGESIZE), vars,
+                                 PageMan::RWX::RW)
+                        .has_value(),
+                    "创建数据段");
+
+            expect("完整的后备页直接映射, 不分配物理页");
+            ttest(tmm->on_np({code}));
+            for (size_t i : {0, 1}) {
+                auto res = tmm->pman().query_page(code + i * PAGESIZE);
+                tassert(res.has_value(), "查询后备页映射");
+                ttest(PageMan::get_physical_address(*res.value().pte) ==
+                      file + i * PAGESIZE);
+                ttest(!PageMan::is_cow(*res.value().pte));
+            }
+            ttest(text->allocated_size() == 0);
+
+            check("不完整的末页复制后备内容并补零");
+            ttest(tmm->on_np({code + 2 * PAGESIZE}));
+            auto tail_res = text->lookup_page(2 * PAGESIZE);
+            tassert(tail_res.has_value(), "末页应已分配");
+            const auto* tail = convert<KpaAddr>(tail_res.value()).as<uint8_t>();
+            bool same        = true;
+            for (size_t i = 0; i < PAGESIZE; i++) {
+                uint8_t want = i < kTail ? bytes[2 * PAGESIZE + i] : 0;
+                same         = same && tail[i] == want;
+            }
+            ttest(same);
+
+            check("可写段读缺页以 COW 映射后备页");
+            ttest(tmm->on_np({data}));
+            auto res = tmm->pman().query_page(data);
+            tassert(res.has_value(), "查询数据段映射");
+            ttest(PageMan::get_physical_address(*res.value().pte) == file);
+            ttest(PageMan::is_cow(*res.value().pte));
+            ttest(!PageMan::is_writable(PageMan::rwx(*res.value().pte)));
+
+            check("首次写入复制为私有页, 后备内容不变");
+            ttest(tmm->on_wp(data));
+            res = tmm->pman().query_page(data);
+            tassert(res.has_value(), "查询写入后的映射");
+            PhyAddr paddr = PageMan::get_physical_address(*res.value().pte);
+            ttest(paddr != file && vars->lookup_page(0).value() == paddr);
+            ttest(PageMan::is_writable(PageMan::rwx(*res.value().pte)));
+            ttest(memcmp(convert<KpaAddr>(paddr).addr(), bytes, PAGESIZE) == 0);
+            ttest(vars->allocated_size() == PAGESIZE);
+
+            delete tmm;
+            GFP::put_page(file, kPages);
+            GFP::put_page(pgd_res.value(), 1);
+        }
+    };
+
+    class CaseLazyFork : public TestCase {
+    public:
+        CaseLazyFork() : TestCase("fork 延迟复制页表项") {}
+        void _run(void* env [[maybe_unused]]) const noexcept override {
+            constexpr size_t kPages = 4;
+            const VirAddr code(0x10000000);
+            const VirAddr data(0x20000000);
+            auto parent_pgd = GFP::get_free_page(1);
+            auto child_pgd  = GFP::get_free_page(1);
+            tassert(parent_pgd.has_value() && child_pgd.has_value(),
+                    "分配页表根");
+            auto* parent = new TaskMemoryManager(parent_pgd.value());
+            auto* child  = new TaskMemoryManager(child_pgd.value());
+
+            auto* text = new cap::MemoryPayload(kPages * PAGESIZE, false,
+                                                false, VMA::Growth::FIXED);
+            auto* heap = new cap::MemoryPayload(kPages * PAGESIZE, false,
+                                                false, VMA::Growth::FLEXUP);
+            // 代码段由加载器持有, 且同时被镜像缓存引用
+            text->image_owned = true;
+            text->keep();
+            tassert(parent
+                        ->add_vma(VMA::Type::CODE, VMA::Growth::FIXED,
+                                  VirArea(code, code + kPages * PAGESIZE),
+                                  text, PageMan::RWX::RX)
+                        .has_value(),
+                    "创建代码段");
+            // 只读, 但来自 capability 的 Memory
+            const VirAddr ro(0x30000000);
+            auto* rodata = new cap::MemoryPayload(PAGESIZE, false, false,
+                                                  VMA::Growth::FIXED);
+            tassert(parent
+                        ->add_vma(VMA::Type::SHARE_RO, VMA::Growth::FIXED,
+                                  VirArea(ro, ro + PAGESIZE), rodata,
+                                  PageMan::RWX::RO)
+                        .has_value(),
+                    "创建只读映射");
+            tassert(parent
+                        ->add_vma(VMA::Type::HEAP, VMA::Growth::FLEXUP,
+                                  VirArea(data, data + kPages * PAGESIZE),
+                                  heap, PageMan::RWX::RW)
+                        .has_value(),
+                    "创建堆");
+            ttest(parent->on_np({code}));
+            ttest(parent->on_np({data, true}));
+            const size_t child_tables = child->page_table_pages();
+
+            action("fork 地址空间");
+            ttest(parent->clone_to_cow(*child).has_value());
+
+            expect("子进程不复制页表项");
+            ttest(child->page_table_pages() == child_tables);
+            ttest(!child->pman().query_page(code).has_value());
+            ttest(!child->pman().query_page(data).has_value());
+
+            check("加载器持有的只读代码段直接共享 Memory");
+            auto text_vma = child->locate(code);
+            ttest(text_vma.has_value() && text_vma.value()->memory == text);
+            auto ro_vma = child->locate(ro);
+            ttest(ro_vma.has_value() && ro_vma.value()->memory != rodata);
+            auto heap_vma = child->locate(data);
+            ttest(heap_vma.has_value() && heap_vma.value()->memory != heap);
+
+            check("父进程可写映射转为 COW");
+            auto res = parent->pman().query_page(data);
+            tassert(res.has_value(), "查询父进程堆页");
+            ttest(PageMan::is_cow(*res.value().pte));
+            ttest(!PageMan::is_writable(PageMan::rwx(*res.value().pte)));
+
+            check("子进程首次访问时按 COW 映射");
+            ttest(child->on_np({data}));
+            res = child->pman().query_page(data);
+            tassert(res.has_value(), "查询子进程堆页");
+            ttest(PageMan::is_cow(*res.value().pte));
+            ttest(PageMan::get_physical_address(*res.value().pte) ==
+                  heap->lookup_page(0).value());
+
+            delete child;
+            delete parent;
+            text->release();
+            GFP::put_page(child_pgd.value(), 1);
+            GFP::put_page(parent_pgd.value(), 1);
+        }
+    };
+
+    void collect_tests(TestFramework& framework) {
+        auto cases = util::ArrayList<TestCase*>();
+        cases.push_back(new CaseVmaIndex());
+        cases.push_back(new CaseAsid());
+        cases.push_back(new CaseTlbGather());
+        cases.push_back(new CasePageWalk());
+        cases.push_back(new CaseHugePage());
+        cases.push_back(new CaseFaultAround());
+        cases.push_back(new CaseZeroPage());
+        cases.push_back(new CaseLazyFork());
+        cases.push_back(new CaseBackedMemory());
+
+        framework.add_category(new TestCategory("vma", std::move(cases)));
+    }
+}  // namespace test::vma
@@ -0,0 +1,18 @@
+/**
+ * @file vma.h
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief VMA 管理测试头文件
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <test/framework.h>
+
+namespace test::vma {
+    void collect_tests(TestFramework& framework);
+}
@@ -144,6 +144,18 @@ public:
      *
      */
     virtual Result<void> sync() = 0;
+
+    /**
+     * @brief 获取常驻内存中的文件内容
+     *
+     * 仅当文件内容已整体位于内存中 (如 RamDisk 上的文件) 时支持,
+     * 返回的内存在块设备存在期间保持有效, 可供按需分页直接映射.
+     *
+     * @return Result<const void *> 文件内容起始地址
+     */
+    virtual Result<const void *> mapping() {
+        unexpect_return(ErrCode::NOT_SUPPORTED);
+    }
 };
 
 /**
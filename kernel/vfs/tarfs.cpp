@@ -66,6 +66,14 @@ namespace tarfs {
 		return to_read;
 	}
 
+	Result<const void *> TarFile::mapping() {
+		// 仅 RamDisk 上的数据直接取自设备内存, 其余情形为卸载时释放的副本
+		if (!sb_->device_->is<RamDiskDevice>()) {
+			unexpect_return(ErrCode::NOT_SUPPORTED);
+		}
+		return static_cast<const void *>(data_);
+	}
+
 	// TarDirectory
 
 	void *TarDirectory::operator new(size_t size) {
@@ -140,6 +140,7 @@ namespace tarfs {
 		Result<void> sync() override {
 			unexpect_return(ErrCode::NOT_SUPPORTED);
 		}
+		Result<const void *> mapping() override;
 
         void *operator new(size_t size);
         void operator delete(void *ptr);
@@ -9,6 +9,7 @@
  *
  */
 
+#include <exe/image_cache.h>
 #include <sus/nonnull.h>
 #include <sus/owner.h>
 #include <sus/path.h>
@@ -137,6 +138,9 @@ Result<void> VFS::umount(const char *mountpoint) {
 
     util::owner<VSuperblock *> vsb = lookup_result.value().get();
 
+    // 镜像缓存持有的 inode 不应阻止卸载
+    loader::ImageCache::drop(*vsb);
+
     // 确定没有打开的文件属于该挂载点
     // 先进行一次tidy_up, 清理掉已亡文件
     // 因为我们并不会在文件的引用计数归零时即刻对其进行删除
@@ -433,3 +437,19 @@ Result<void> VFS::sync(VINode *vfile) const
 
     return file->sync();
 }
+
+// 获取常驻内存中的文件内容
+Result<const void *> VFS::mapping(VINode *vfile) const
+{
+    // check if vfile is valid
+    if (vfile->closable()) {
+        unexpect_return(ErrCode::INVALID_PARAM);
+    }
+
+    // get interfaces from vfile
+    auto file_res = vfile->inode()->as_file();
+    propagate(file_res);
+    IFile *file = file_res.value();
+
+    return file->mapping();
+}
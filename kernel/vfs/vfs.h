@@ -242,4 +242,6 @@ public:
     Result<size_t> size(VINode *vfile) const;
     // 刷新文件内容到存储设备
     Result<void> sync(VINode *vfile) const;
+    // 获取常驻内存中的文件内容, 见 IFile::mapping
+    Result<const void *> mapping(VINode *vfile) const;
 };
@@ -25,6 +25,10 @@ CapIdx sys_create_process(const char *path, CapIdx *caps, size_t caps_sz,
     return sys_pcb_create_process(__pcb_cap, path, caps, caps_sz, sched_class);
 }
 
+CapIdx sys_spawn(const SpawnArgs *args) {
+    return sys_pcb_spawn(__pcb_cap, args);
+}
+
 CapIdx sys_create_thread(void (*entry)(), void *stack_addr,
                          size_t stack_size) {
     return sys_pcb_create_thread(__pcb_cap, entry, stack_addr, stack_size);
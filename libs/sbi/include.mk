@@ -1 +1 @@
-sources += sbi.c sbi_dbcn.c sbi_legacy.c sbi_base.c
+sources += sbi.c sbi_dbcn.c sbi_legacy.c sbi_base.c sbi_hsm.c sbi_remote_fence.c
@@ -0,0 +1,31 @@
+/**
+ * @file sbi_hsm.c
+ * @author theflysong (song_of_the_fly@163.com)
+ * @brief SBI Hart State Management
+ * @version alpha-1.0.0
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <sbi/sbi.h>
+
+SBIRet sbi_hart_start(umb_t hartid, umb_t start_addr, umb_t opaque) {
+    return sbi_ecall(SBI_EID_HSM, SBI_HART_START,
+                     hartid,
+                     start_addr,
+                     opaque,
+                     0, 0, 0);
+}
+
+SBIRet sbi_hart_stop(void) {
+    return sbi_ecall(SBI_EID_HSM, SBI_HART_STOP,
+                     0, 0, 0, 0, 0, 0);
+}
+
+SBIRet sbi_hart_get_status(umb_t hartid) {
+    return sbi_ecall(SBI_EID_HSM, SBI_HART_GET_STATUS,
+                     hartid,
+                     0, 0, 0, 0, 0);
+}
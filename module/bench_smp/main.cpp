@@ -0,0 +1,81 @@
+#include <kmod/syscall.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// 多进程吞吐量基准: 分别以 1, 2, 4, 8 个进程完成相同总量的计算,
+// 比较总耗时以观察多处理器下的扩展性
+constexpr CapIdx kCompletionNotifCap = cap::make(1, 3);
+constexpr CapIdx kWorkerNotifCap     = cap::make(1, 4);
+constexpr size_t kCompletionSignal   = 0;
+constexpr size_t kWorkerCounts[]     = {1, 2, 4, 8};
+constexpr size_t kTotalIterations    = 1 << 24;
+
+static inline uint64_t read_time() {
+    uint64_t ticks;
+    asm volatile("rdtime %0" : "=r"(ticks));
+    return ticks;
+}
+
+static size_t spin_work(size_t iterations) {
+    volatile size_t acc = 0;
+    for (size_t i = 0; i < iterations; ++i) {
+        acc = acc * 1103515245 + 12345;
+    }
+    return acc;
+}
+
+// 派生 workers 个子进程平分 kTotalIterations 次计算, 返回总耗时
+static uint64_t run_round(size_t workers) {
+    const size_t share = kTotalIterations / workers;
+    uint64_t start     = read_time();
+    for (size_t i = 0; i < workers; ++i) {
+        ForkRet ret = fork();
+        if (ret.ret1 == cap::error) {
+            printf("bench_smp: fork failed\n");
+            return 0;
+        }
+        if (ret.ret2 == 0) {
+            spin_work(share);
+            sys_notif_signal(kWorkerNotifCap, i);
+            exit(0);
+        }
+        sys_cap_remove(ret.ret1);
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        sys_notif_wait(kWorkerNotifCap, i);
+        sys_notif_unsignal(kWorkerNotifCap, i);
+    }
+    return read_time() - start;
+}
+
+int kmod_main() {
+    printf("bench_smp: 启动, 总计算量 %u 次迭代\n", kTotalIterations);
+    if (!sys_notif_create(kWorkerNotifCap)) {
+        printf("bench_smp: create worker notification failed\n");
+        while (true) {
+        }
+    }
+
+    uint64_t baseline = 0;
+    for (size_t workers : kWorkerCounts) {
+        uint64_t ticks = run_round(workers);
+        if (ticks == 0) {
+            break;
+        }
+        if (baseline == 0) {
+            baseline = ticks;
+        }
+        printf("bench_smp: %u 个进程, 耗时 %u ticks, 加速比 %u.%02u\n",
+               workers, (size_t)ticks, (size_t)(baseline / ticks),
+               (size_t)(baseline * 100 / ticks % 100));
+    }
+
+    sys_notif_signal(kCompletionNotifCap, kCompletionSignal);
+    exit(0);
+
+    while (true) {
+    }
+    return 0;
+}
@@ -1 +1 @@
-sources += main.cpp cpu.S
+sources += main.cpp
@@ -13,12 +13,10 @@
 
 #include <cstdio>
 
-extern "C" {
-void cpu_idle();
-}
-
 constexpr CapIdx kForkDoneCap    = cap::make(1, 3);
 constexpr size_t kForkDoneSignal = 0;
+// 无人发送的信号, init 完成启动工作后在其上阻塞
+constexpr size_t kParkSignal     = 1;
 
 int kmod_main() {
     printf("进入 init 模块!\n");
@@ -29,8 +27,9 @@ int kmod_main() {
     }
 
     CapIdx initial_caps[] = {kForkDoneCap};
-    CapIdx modidx         = sys_create_process("/initrd/test_fork.mod",
-                                               (CapIdx *)initial_caps, 1, 3);
+    CapIdx modidx =
+        sys_create_process("/initrd/test_fork.mod", (CapIdx *)initial_caps, 1,
+                           SCHED_CLASS_RR);
     printf("移除test_fork模块能力 %p\n", modidx);
     // don't hold its capability index.
     sys_cap_remove(modidx);
@@ -39,20 +38,35 @@ int kmod_main() {
     sys_notif_unsignal(kForkDoneCap, kForkDoneSignal);
     printf("init: 收到test_fork完成通知\n");
 
-    modidx = sys_create_process("/initrd/test_thread.mod", nullptr, 0, 3);
+    // 吞吐量基准须独占处理器, 待其完成后再启动其余测试
+    modidx = sys_create_process("/initrd/bench_smp.mod",
+                                (CapIdx *)initial_caps, 1, SCHED_CLASS_RR);
+    printf("移除bench_smp模块能力 %p\n", modidx);
+    sys_cap_remove(modidx);
+
+    sys_notif_wait(kForkDoneCap, kForkDoneSignal);
+    sys_notif_unsignal(kForkDoneCap, kForkDoneSignal);
+    printf("init: 收到bench_smp完成通知\n");
+
+    modidx = sys_create_process("/initrd/test_thread.mod", nullptr, 0,
+                                SCHED_CLASS_RR);
     printf("移除test_thread模块能力 %p\n", modidx);
     sys_cap_remove(modidx);
 
-    modidx =
-        sys_create_process("/initrd/test_endpoint_master.mod", nullptr, 0, 3);
+    modidx = sys_create_process("/initrd/test_endpoint_master.mod", nullptr,
+                                0, SCHED_CLASS_RR);
     printf("移除test-endpoint-master模块能力 %p\n", modidx);
     sys_cap_remove(modidx);
 
-    modidx = sys_create_process("/initrd/test_call_service.mod", nullptr, 0, 3);
+    modidx = sys_create_process("/initrd/test_call_service.mod", nullptr, 0,
+                                SCHED_CLASS_RR);
     printf("移除test_call_service模块能力 %p\n", modidx);
     sys_cap_remove(modidx);
 
-    printf("进入 cpu_idle()!\n");
-    cpu_idle();
+    // 处理器空闲时由内核的空闲上下文执行 wfi, init 无需自旋占用处理器
+    printf("init: 启动完成, 进入等待\n");
+    while (true) {
+        sys_notif_wait(kForkDoneCap, kParkSignal);
+    }
     return 0;
 }
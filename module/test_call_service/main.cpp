@@ -78,9 +78,16 @@ int kmod_main() {
         }
     }
 
-    CapIdx initial_caps[] = {kCallEndpointCap};
-    CapIdx user_pcb       = sys_create_process("/initrd/test_call_user.mod",
-                                               initial_caps, 1, SCHED_CLASS_RR);
+    SpawnCap initial_caps[] = {{kCallEndpointCap, kCallEndpointCap, 0}};
+    SpawnArgs spawn_args{
+        .path        = "/initrd/test_call_user.mod",
+        .caps        = initial_caps,
+        .caps_sz     = 1,
+        .maps        = nullptr,
+        .maps_sz     = 0,
+        .sched_class = SCHED_CLASS_RR,
+    };
+    CapIdx user_pcb = sys_spawn(&spawn_args);
     if (user_pcb == cap::error) {
         printf("test_call_service: 创建user失败\n");
         while (true) {
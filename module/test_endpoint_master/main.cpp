@@ -5,9 +5,28 @@
 #include <cstdint>
 #include <cstdio>
 
-constexpr CapIdx kEndpointCap = cap::make(1, 3);
-constexpr uint64_t kValueV    = 0x123456789abcdef0ULL;
-constexpr size_t kRepeatCount = 10;
+constexpr CapIdx kEndpointCap    = cap::make(1, 3);
+constexpr uint64_t kValueV       = 0x123456789abcdef0ULL;
+constexpr size_t kRepeatCount    = 10;
+constexpr size_t kPingPongRounds = 1000;
+
+static inline uint64_t read_time() {
+    uint64_t ticks;
+    asm volatile("rdtime %0" : "=r"(ticks));
+    return ticks;
+}
+
+static void send_u64(CapIdx endpoint, uint64_t value) {
+    size_t msgsz = sizeof(value);
+    size_t capsz = 0;
+    MsgPacket packet{
+        .msgbuf  = &value,
+        .msgsz   = &msgsz,
+        .caplist = nullptr,
+        .capsz   = &capsz,
+    };
+    sys_endpoint_send(endpoint, &packet);
+}
 
 static uint64_t recv_u64(CapIdx endpoint, const char *tag) {
     uint64_t value = 0;
@@ -40,7 +59,8 @@ int kmod_main() {
 
     CapIdx initial_caps[] = {kEndpointCap};
     CapIdx slave_pcb = sys_create_process("/initrd/test_endpoint_slave.mod",
-                                          (CapIdx *)initial_caps, 1, 3);
+                                          (CapIdx *)initial_caps, 1,
+                                          SCHED_CLASS_RR);
     if (slave_pcb == cap::error) {
         printf("test-endpoint-master: 创建 test-endpoint-slave 失败!\n");
         exit(-1);
@@ -65,6 +85,20 @@ int kmod_main() {
         sys_endpoint_send(kEndpointCap, &packet);
     }
 
+    // 往返计时: 每轮一次发送与一次接收, 均伴随一次地址空间切换
+    uint64_t start = read_time();
+    for (size_t round = 0; round < kPingPongRounds; ++round) {
+        send_u64(kEndpointCap, round);
+        uint64_t echo = recv_u64(kEndpointCap, "test-endpoint-master");
+        if (echo != round) {
+            printf("test-endpoint-master: 回显错误 %lu != %lu\n", echo, round);
+            exit(-1);
+        }
+    }
+    uint64_t elapsed = read_time() - start;
+    printf("test-endpoint-master: %u 次往返共 %lu ticks, 平均 %lu ticks\n",
+           kPingPongRounds, elapsed, elapsed / kPingPongRounds);
+
     exit(-1);
     return 0;
 }
@@ -5,9 +5,10 @@
 #include <cstdint>
 #include <cstdio>
 
-constexpr uint64_t kValueK    = 0xfedcba9876543210ULL;
-constexpr size_t kRepeatCount = 10;
-constexpr size_t kScanSlots   = 16;
+constexpr uint64_t kValueK       = 0xfedcba9876543210ULL;
+constexpr size_t kRepeatCount    = 10;
+constexpr size_t kScanSlots      = 16;
+constexpr size_t kPingPongRounds = 1000;
 
 // test-endpoint-slave 模块: 从 test-endpoint-master 接收一个值,
 // 进行异或运算后再发回去, 重复多轮 这里寻找能力空间中唯一的端点能力, 从而与
@@ -85,6 +86,14 @@ int kmod_main() {
                round, kValueK, c, v);
     }
 
+    // 原样回显, 配合 test-endpoint-master 进行往返计时
+    for (size_t round = 0; round < kPingPongRounds; ++round) {
+        value = recv_u64(endpoint_cap, "test-endpoint-slave");
+        msgsz = sizeof(value);
+        capsz = 0;
+        sys_endpoint_send(endpoint_cap, &packet);
+    }
+
     exit(-1);
     return 0;
 }
@@ -1,6 +1,7 @@
 #include <kmod/syscall.h>
 
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 
@@ -14,6 +15,8 @@ constexpr size_t kSignalSyn          = 0;
 constexpr size_t kSignalSynAck       = 1;
 constexpr size_t kSignalAck          = 2;
 constexpr size_t kCompletionSignal   = 0;
+constexpr size_t kForkRounds         = 8;
+constexpr size_t kBenchPageSteps[]   = {0, 256, 1024};
 
 static const char *cap_type_name(PayloadType type) {
     return to_string(type);
@@ -47,6 +50,43 @@ static char *alloc_page_string(const char *str) {
     return buf;
 }
 
+static inline uint64_t read_time() {
+    uint64_t ticks;
+    asm volatile("rdtime %0" : "=r"(ticks));
+    return ticks;
+}
+
+// 在已写入 pages 页堆内存的地址空间中测量 fork 的平均耗时
+static void bench_fork(size_t pages) {
+    if (pages > 0) {
+        auto *heap = static_cast<volatile char *>(sbrk(pages * 4096));
+        if (heap == reinterpret_cast<volatile char *>(-1)) {
+            printf("test_fork: bench sbrk failed\n");
+            return;
+        }
+        for (size_t i = 0; i < pages; ++i) {
+            heap[i * 4096] = static_cast<char>(i);
+        }
+    }
+
+    uint64_t total = 0;
+    for (size_t round = 0; round < kForkRounds; ++round) {
+        uint64_t start = read_time();
+        ForkRet ret    = fork();
+        uint64_t end   = read_time();
+        if (ret.ret1 == cap::error) {
+            printf("test_fork: bench fork failed\n");
+            return;
+        }
+        if (ret.ret2 == 0) {
+            exit(0);
+        }
+        total += end - start;
+    }
+    printf("test_fork: bench 堆 %u 页, fork 平均 %u ticks\n", pages,
+           (size_t)(total / kForkRounds));
+}
+
 int kmod_main() {
     printf("test_fork: 启动时PID=%u pcb_cap=%p\n", sys_getpid(__pcb_cap),
            (void *)__pcb_cap);
@@ -57,6 +97,12 @@ int kmod_main() {
         }
     }
 
+    size_t bench_pages = 0;
+    for (size_t step : kBenchPageSteps) {
+        bench_fork(step - bench_pages);
+        bench_pages = step;
+    }
+
     global_value     = 114514;
     char *shared_buf = alloc_page_string("全体目光向我看齐");
 